@@ -51,6 +51,7 @@ int main(int argc, char** argv) {
         std::string data(128, 'x');
         data[97] = ',';
         std::cerr << "simd_pos=" << csv::internals::find_next_non_special(data, 0, sentinels)
+                  << " simd_level=" << static_cast<int>(csv::internals::active_simd_level())
 #ifdef __AVX2__
                   << " __AVX2__=1"
 #else
@@ -0,0 +1,92 @@
+#include "bench_common.hpp"
+
+#include <csv.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace {
+    // JSON documents embedded in a CSV column: every JSON quote is escaped as "".
+    std::string make_json_payload(std::size_t target_size) {
+        std::string payload;
+        std::size_t key = 0;
+        while (payload.size() < target_size) {
+            payload += "{\"\"id\"\": " + std::to_string(key)
+                + ", \"\"name\"\": \"\"item " + std::to_string(key)
+                + "\"\", \"\"tags\"\": [\"\"a\"\", \"\"b\"\"]}";
+            ++key;
+        }
+
+        payload.resize(target_size);
+        return payload;
+    }
+
+    // The per-byte loop the field policy used before the SIMD kernels.
+    std::size_t compact_with_parse_flags(
+        const csv::internals::ParseFlagMap& parse_flags,
+        csv::string_view field,
+        char* out
+    ) {
+        using csv::internals::ParseFlags;
+        using csv::CHAR_OFFSET;
+
+        char* const begin = out;
+        for (std::size_t i = 0; i < field.size(); ++i) {
+            if (parse_flags[field[i] + CHAR_OFFSET] == ParseFlags::QUOTE
+                && i + 1 < field.size()
+                && parse_flags[field[i + 1] + CHAR_OFFSET] == ParseFlags::QUOTE) {
+                *(out++) = field[i++];
+                continue;
+            }
+
+            *(out++) = field[i];
+        }
+
+        return static_cast<std::size_t>(out - begin);
+    }
+
+    void BM_quote_compaction_parse_flag_loop(benchmark::State& state) {
+        const std::string payload = make_json_payload(static_cast<std::size_t>(state.range(0)));
+        const auto parse_flags = csv::internals::make_parse_flags(',', '"');
+        std::vector<char> out(payload.size());
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(compact_with_parse_flags(parse_flags, payload, out.data()));
+            benchmark::ClobberMemory();
+        }
+
+        csv_bench::set_bytes_processed(state, payload.size());
+    }
+
+    void BM_quote_compaction_scalar(benchmark::State& state) {
+        const std::string payload = make_json_payload(static_cast<std::size_t>(state.range(0)));
+        std::vector<char> out(payload.size());
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(csv::internals::compact_doubled_quotes_scalar(payload, '"', out.data()));
+            benchmark::ClobberMemory();
+        }
+
+        csv_bench::set_bytes_processed(state, payload.size());
+    }
+
+    void BM_quote_compaction_simd(benchmark::State& state) {
+        const std::string payload = make_json_payload(static_cast<std::size_t>(state.range(0)));
+        std::vector<char> out(payload.size());
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(csv::internals::compact_doubled_quotes(payload, '"', out.data()));
+            benchmark::ClobberMemory();
+        }
+
+        csv_bench::set_bytes_processed(state, payload.size());
+        state.SetLabel("simd_level=" + std::to_string(static_cast<int>(csv::internals::active_simd_level())));
+    }
+
+    BENCHMARK(BM_quote_compaction_parse_flag_loop)->Arg(64)->Arg(512)->Arg(16 << 10);
+    BENCHMARK(BM_quote_compaction_scalar)->Arg(64)->Arg(512)->Arg(16 << 10);
+    BENCHMARK(BM_quote_compaction_simd)->Arg(64)->Arg(512)->Arg(16 << 10);
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,97 @@
+#include "bench_common.hpp"
+
+#include <csv.hpp>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr std::size_t ROWS_PER_ITERATION = 1 << 20;
+
+    // One parser thread pushing rows one at a time (as CSVParserCore does in
+    // the serial path) against one consumer draining read_chunk()-sized batches.
+    template<typename Queue>
+    void BM_row_queue_push_back(benchmark::State& state) {
+        const std::size_t batch_size = static_cast<std::size_t>(state.range(0));
+
+        for (auto _ : state) {
+            Queue queue(100);
+            queue.notify_all();
+
+            std::thread producer([&queue]() {
+                for (std::size_t i = 0; i < ROWS_PER_ITERATION; ++i) {
+                    queue.push_back(csv::CSVRow());
+                }
+                queue.kill_all();
+            });
+
+            std::size_t consumed = 0;
+            std::vector<csv::CSVRow> batch;
+            while (true) {
+                if (queue.empty()) {
+                    if (!queue.is_waitable() && queue.empty()) {
+                        break;
+                    }
+                    queue.wait();
+                    continue;
+                }
+
+                batch.clear();
+                consumed += queue.drain_front(batch, batch_size);
+            }
+
+            producer.join();
+            benchmark::DoNotOptimize(consumed);
+        }
+
+        csv_bench::set_items_processed(state, ROWS_PER_ITERATION);
+    }
+
+    // Speculative workers hand over whole vectors of rows.
+    template<typename Queue>
+    void BM_row_queue_append_rows(benchmark::State& state) {
+        const std::size_t rows_per_batch = static_cast<std::size_t>(state.range(0));
+
+        for (auto _ : state) {
+            Queue queue(100);
+            queue.notify_all();
+
+            std::thread producer([&queue, rows_per_batch]() {
+                for (std::size_t i = 0; i < ROWS_PER_ITERATION; i += rows_per_batch) {
+                    queue.append_rows(std::vector<csv::CSVRow>(rows_per_batch));
+                }
+                queue.kill_all();
+            });
+
+            std::size_t consumed = 0;
+            while (true) {
+                if (queue.empty()) {
+                    if (!queue.is_waitable() && queue.empty()) {
+                        break;
+                    }
+                    queue.wait();
+                    continue;
+                }
+
+                benchmark::DoNotOptimize(queue.pop_front());
+                ++consumed;
+            }
+
+            producer.join();
+            benchmark::DoNotOptimize(consumed);
+        }
+
+        csv_bench::set_items_processed(state, ROWS_PER_ITERATION);
+    }
+
+    using MutexQueue = csv::internals::ThreadSafeDeque<csv::CSVRow>;
+    using SPSCQueue = csv::internals::SPSCRowQueue<csv::CSVRow>;
+
+    BENCHMARK_TEMPLATE(BM_row_queue_push_back, MutexQueue)->Arg(1)->Arg(1024)->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_row_queue_push_back, SPSCQueue)->Arg(1)->Arg(1024)->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_row_queue_append_rows, MutexQueue)->Arg(64)->Arg(4096)->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_row_queue_append_rows, SPSCQueue)->Arg(64)->Arg(4096)->UseRealTime();
+}
+
+BENCHMARK_MAIN();
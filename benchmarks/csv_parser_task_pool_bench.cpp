@@ -0,0 +1,92 @@
+#include "bench_common.hpp"
+
+#include <csv.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+    using csv::internals::parallel::TaskGroup;
+    using csv::internals::parallel::WorkStealingPool;
+
+    // Deterministic busy work the optimizer cannot drop.
+    std::uint64_t spin(std::size_t iterations) {
+        std::uint64_t x = 0x9E3779B97F4A7C15ull;
+        for (std::size_t i = 0; i < iterations; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+        return x;
+    }
+
+    // Round trip of one parallel_for with one empty task per worker: the
+    // fixed cost paid for every speculative window or DataFrame batch.
+    void BM_task_pool_dispatch(benchmark::State& state) {
+        const std::size_t workers = static_cast<std::size_t>(state.range(0));
+        WorkStealingPool pool(workers);
+
+        for (auto _ : state) {
+            pool.parallel_for(workers, [](std::size_t, std::size_t task_index) {
+                benchmark::DoNotOptimize(task_index);
+            });
+        }
+
+        csv_bench::set_items_processed(state, 1);
+    }
+
+    // Windows of equal chunks where one chunk per window costs 16x the others,
+    // like a chunk full of multiline quoted text. range(1) == 0 waits for each
+    // window before starting the next (the old barrier); range(1) == 1 starts
+    // window N+1 before waiting for window N, as pipelined parsing does.
+    void BM_task_pool_skewed(benchmark::State& state) {
+        const std::size_t workers = static_cast<std::size_t>(state.range(0));
+        const bool overlap = state.range(1) != 0;
+        const std::size_t windows = 32;
+        const std::size_t chunks_per_window = workers;
+        const std::size_t light_work = 20000;
+        WorkStealingPool pool(workers);
+
+        std::vector<std::uint64_t> sink(chunks_per_window * windows);
+        for (auto _ : state) {
+            std::unique_ptr<TaskGroup> previous;
+            for (std::size_t window = 0; window < windows; ++window) {
+                std::unique_ptr<TaskGroup> current(new TaskGroup());
+                pool.spawn_for(*current, chunks_per_window, [&sink, window, chunks_per_window, light_work](
+                    std::size_t,
+                    std::size_t chunk
+                ) {
+                    const bool heavy = chunk == window % chunks_per_window;
+                    sink[window * chunks_per_window + chunk] = spin(heavy ? 16 * light_work : light_work);
+                });
+
+                if (overlap) {
+                    if (previous) {
+                        pool.wait(*previous);
+                    }
+                    previous = std::move(current);
+                }
+                else {
+                    pool.wait(*current);
+                }
+            }
+
+            if (previous) {
+                pool.wait(*previous);
+            }
+            benchmark::DoNotOptimize(sink.data());
+        }
+
+        csv_bench::set_items_processed(state, windows * chunks_per_window);
+    }
+
+    BENCHMARK(BM_task_pool_dispatch)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+    BENCHMARK(BM_task_pool_skewed)
+        ->Args({ 4, 0 })->Args({ 4, 1 })
+        ->Args({ 8, 0 })->Args({ 8, 1 })
+        ->UseRealTime();
+}
+
+BENCHMARK_MAIN();
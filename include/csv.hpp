@@ -32,6 +32,7 @@ SOFTWARE.
 #include "internal/data_frame.hpp"
 #include "internal/csv_reader.hpp"
 #include "internal/csv_utility.hpp"
+#include "internal/csv_row_index.hpp"
 #include "internal/csv_writer.hpp"
 
 /** INSERT_CSV_SOURCES **/
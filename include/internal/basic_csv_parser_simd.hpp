@@ -13,9 +13,16 @@
  *
  *  UTF-8 safe: all CSV structural bytes are single-byte ASCII; multi-byte
  *  sequences (values > 0x7F) are never misidentified as special.
+ *
+ *  On x86, kernels are selected at runtime: the SSE2, AVX2 and AVX-512BW
+ *  variants are all compiled (via per-function target attributes on GCC/Clang)
+ *  and cpuid picks the widest supported one once per process. A baseline
+ *  x86-64 build therefore still scans 32 or 64 bytes at a time on newer hosts.
+ *  Define CSV_NO_SIMD_DISPATCH to fall back to the compile-time selection.
  */
 #include <array>
 #include <cstdint>
+#include <cstring>
 
 #include "common.hpp"
 
@@ -38,6 +45,36 @@
 #  else
 #    define CSV_TZCNT32(x) static_cast<unsigned>(__builtin_ctz(x))
 #  endif
+
+// Runtime dispatch needs either per-function target attributes (GCC/Clang)
+// or a compiler that accepts any intrinsic regardless of /arch (MSVC).
+// Emscripten maps x86 intrinsics onto wasm SIMD and has no cpuid.
+#  if !defined(CSV_NO_SIMD_DISPATCH) && !defined(__EMSCRIPTEN__) \
+    && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#    define CSV_SIMD_DISPATCH 1
+#  endif
+#endif
+
+#if defined(CSV_SIMD_DISPATCH)
+#  if defined(__GNUC__) || defined(__clang__)
+#    define CSV_TARGET_AVX2 __attribute__((target("avx2,pclmul")))
+#    define CSV_TARGET_AVX512BW __attribute__((target("avx512f,avx512bw,pclmul")))
+#  else
+#    define CSV_TARGET_AVX2
+#    define CSV_TARGET_AVX512BW
+#  endif
+
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    if _MSC_VER >= 1911
+#      define CSV_SIMD_AVX512 1
+#    endif
+#  elif defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 6)
+#    define CSV_SIMD_AVX512 1
+#  endif
+#endif
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
 #endif
 
 #if defined(CSV_SIMD_NEON)
@@ -82,24 +119,39 @@ namespace csv {
         static_assert(sizeof(SentinelVecs) == 128, "SentinelVecs layout must stay ISA-independent.");
         static_assert(alignof(SentinelVecs) <= alignof(void*), "SentinelVecs must not require over-aligned allocation.");
 
-        // Free function — easy to unit test independently of CSVParserCore.
-        //
-        // SIMD-only fast-forward: skips pos forward past any bytes that are
-        // definitely not one of the four CSV sentinel characters. Stops as
-        // soon as a sentinel byte is found OR fewer bytes remain than one
-        // SIMD lane. The caller is responsible for the scalar tail loop.
-        //
-        // State-agnostic by design: stops conservatively at any sentinel byte
-        // regardless of quote_escape. Inside a quoted field, delimiter and
-        // newline bytes are NOT_SPECIAL under compound_parse_flag, so the
-        // outer DFA loop re-enters parse_field immediately at zero cost.
-        inline size_t find_next_non_special(
+        /** Instruction set tiers a sentinel scan kernel can be built for. */
+        enum class SIMDLevel : int {
+            SCALAR = 0,
+            SSE2 = 1,
+            AVX2 = 2,
+            AVX512 = 3,
+            NEON = 4
+        };
+
+        /** Signature shared by every find_next_non_special kernel. */
+        using SentinelScanFn = size_t(*)(csv::string_view, size_t, const SentinelVecs&) noexcept;
+
+        // Every kernel below follows the same contract as find_next_non_special:
+        // fast-forward through complete lanes without sentinel bytes and leave
+        // the sub-lane tail to the caller.
+        inline size_t find_next_non_special_scalar(
+            csv::string_view,
+            size_t pos,
+            const SentinelVecs&
+        ) noexcept {
+            return pos;
+        }
+
+#if defined(CSV_SIMD_AVX2)
+        inline size_t find_next_non_special_avx2(
+#elif defined(CSV_SIMD_DISPATCH)
+        CSV_TARGET_AVX2 inline size_t find_next_non_special_avx2(
+#endif
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_DISPATCH)
             csv::string_view data,
             size_t pos,
             const SentinelVecs& sentinels
-        ) noexcept
-        {
-#if defined(CSV_SIMD_AVX2)
+        ) noexcept {
             const __m256i v_delim = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sentinels.v_delim.data()));
             const __m256i v_quote = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sentinels.v_quote.data()));
             const __m256i v_lf    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sentinels.v_lf.data()));
@@ -117,7 +169,17 @@ namespace csv {
                     return pos + CSV_TZCNT32(static_cast<unsigned>(mask));
                 pos += 32;
             }
-#elif defined(CSV_SIMD_SSE2)
+
+            return pos;
+        }
+#endif
+
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_SSE2)
+        inline size_t find_next_non_special_sse2(
+            csv::string_view data,
+            size_t pos,
+            const SentinelVecs& sentinels
+        ) noexcept {
             const __m128i v_delim = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sentinels.v_delim.data()));
             const __m128i v_quote = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sentinels.v_quote.data()));
             const __m128i v_lf    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sentinels.v_lf.data()));
@@ -135,7 +197,50 @@ namespace csv {
                     return pos + CSV_TZCNT32(static_cast<unsigned>(mask));
                 pos += 16;
             }
-#elif defined(CSV_SIMD_NEON)
+
+            return pos;
+        }
+#endif
+
+#if defined(CSV_SIMD_AVX512)
+        // 64-byte lanes. The 32-byte sentinel arrays are broadcast from their
+        // first byte, so SentinelVecs keeps its ISA-independent layout.
+        CSV_TARGET_AVX512BW inline size_t find_next_non_special_avx512(
+            csv::string_view data,
+            size_t pos,
+            const SentinelVecs& sentinels
+        ) noexcept {
+            const __m512i v_delim = _mm512_set1_epi8(sentinels.v_delim[0]);
+            const __m512i v_quote = _mm512_set1_epi8(sentinels.v_quote[0]);
+            const __m512i v_lf    = _mm512_set1_epi8('\n');
+            const __m512i v_cr    = _mm512_set1_epi8('\r');
+
+            while (pos + 64 <= data.size()) {
+                const __m512i bytes = _mm512_loadu_si512(reinterpret_cast<const void*>(data.data() + pos));
+                const __mmask64 mask = _mm512_cmpeq_epi8_mask(bytes, v_delim)
+                    | _mm512_cmpeq_epi8_mask(bytes, v_quote)
+                    | _mm512_cmpeq_epi8_mask(bytes, v_lf)
+                    | _mm512_cmpeq_epi8_mask(bytes, v_cr);
+
+                if (mask != 0) {
+                    const auto low = static_cast<unsigned>(mask & 0xFFFFFFFFu);
+                    if (low != 0)
+                        return pos + CSV_TZCNT32(low);
+                    return pos + 32 + CSV_TZCNT32(static_cast<unsigned>(mask >> 32));
+                }
+                pos += 64;
+            }
+
+            return pos;
+        }
+#endif
+
+#if defined(CSV_SIMD_NEON)
+        inline size_t find_next_non_special_neon(
+            csv::string_view data,
+            size_t pos,
+            const SentinelVecs& sentinels
+        ) noexcept {
             const uint8x16_t v_delim = vld1q_u8(reinterpret_cast<const uint8_t*>(sentinels.v_delim.data()));
             const uint8x16_t v_quote = vld1q_u8(reinterpret_cast<const uint8_t*>(sentinels.v_quote.data()));
             const uint8x16_t v_lf    = vld1q_u8(reinterpret_cast<const uint8_t*>(sentinels.v_lf.data()));
@@ -163,10 +268,856 @@ namespace csv {
                 }
                 pos += 16;
             }
+
+            return pos;
+        }
+#endif
+
+        /** Widest kernel tier the host CPU and OS support.
+         *
+         *  Only meaningful for x86 dispatch builds; other builds report the
+         *  tier chosen at compile time. The AVX2 and AVX-512 tiers also require
+         *  PCLMULQDQ, which the structural-index kernels use for prefix-XOR.
+         */
+        inline SIMDLevel detect_simd_level() noexcept {
+#if defined(CSV_SIMD_DISPATCH)
+#  if defined(_MSC_VER)
+            int regs[4] = { 0, 0, 0, 0 };
+            __cpuid(regs, 0);
+            const int max_leaf = regs[0];
+
+            __cpuid(regs, 1);
+            const bool pclmul = (regs[2] & (1 << 1)) != 0;
+            const bool osxsave = (regs[2] & (1 << 27)) != 0;
+            const bool avx = (regs[2] & (1 << 28)) != 0;
+            if (!pclmul || !osxsave || !avx || max_leaf < 7)
+                return SIMDLevel::SSE2;
+
+            // XCR0 must report OS support for the YMM (and ZMM) register state.
+            const unsigned long long xcr0 = _xgetbv(0);
+            if ((xcr0 & 0x6) != 0x6)
+                return SIMDLevel::SSE2;
+
+            __cpuidex(regs, 7, 0);
+            const bool avx2 = (regs[1] & (1 << 5)) != 0;
+            const bool avx512f = (regs[1] & (1 << 16)) != 0;
+            const bool avx512bw = (regs[1] & (1 << 30)) != 0;
+#    if defined(CSV_SIMD_AVX512)
+            if (avx512f && avx512bw && (xcr0 & 0xE6) == 0xE6)
+                return SIMDLevel::AVX512;
+#    else
+            (void)avx512f; (void)avx512bw;
+#    endif
+            return avx2 ? SIMDLevel::AVX2 : SIMDLevel::SSE2;
+#  else
+            // libgcc/compiler-rt also verify XCR0 before reporting AVX features.
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("pclmul"))
+                return SIMDLevel::SSE2;
+#    if defined(CSV_SIMD_AVX512)
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+                return SIMDLevel::AVX512;
+#    endif
+            if (__builtin_cpu_supports("avx2"))
+                return SIMDLevel::AVX2;
+            return SIMDLevel::SSE2;
+#  endif
+#elif defined(CSV_SIMD_AVX2)
+            return SIMDLevel::AVX2;
+#elif defined(CSV_SIMD_SSE2)
+            return SIMDLevel::SSE2;
+#elif defined(CSV_SIMD_NEON)
+            return SIMDLevel::NEON;
+#else
+            return SIMDLevel::SCALAR;
+#endif
+        }
+
+        /** Kernel compiled for the given tier, or nullptr if this build lacks one.
+         *
+         *  Does not check that the host can execute it; see detect_simd_level().
+         */
+        inline SentinelScanFn sentinel_scan_kernel(SIMDLevel level) noexcept {
+            switch (level) {
+            case SIMDLevel::SCALAR:
+                return &find_next_non_special_scalar;
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_SSE2)
+            case SIMDLevel::SSE2:
+                return &find_next_non_special_sse2;
+#endif
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_DISPATCH)
+            case SIMDLevel::AVX2:
+                return &find_next_non_special_avx2;
+#endif
+#if defined(CSV_SIMD_AVX512)
+            case SIMDLevel::AVX512:
+                return &find_next_non_special_avx512;
+#endif
+#if defined(CSV_SIMD_NEON)
+            case SIMDLevel::NEON:
+                return &find_next_non_special_neon;
+#endif
+            default:
+                return nullptr;
+            }
+        }
+
+        /** Tier used by find_next_non_special() in this process. */
+        inline SIMDLevel active_simd_level() noexcept {
+            static const SIMDLevel level = detect_simd_level();
+            return level;
+        }
+
+        // Free function — easy to unit test independently of CSVParserCore.
+        //
+        // SIMD-only fast-forward: skips pos forward past any bytes that are
+        // definitely not one of the four CSV sentinel characters. Stops as
+        // soon as a sentinel byte is found OR fewer bytes remain than one
+        // SIMD lane. The caller is responsible for the scalar tail loop.
+        //
+        // State-agnostic by design: stops conservatively at any sentinel byte
+        // regardless of quote_escape. CSVParserCore::parse_field switches to
+        // find_next_quote() inside quoted fields, where delimiters and newlines
+        // are ordinary content.
+        //
+        // Shared by CSVParserCore::parse_field and the writer's quoting scan.
+        inline size_t find_next_non_special(
+            csv::string_view data,
+            size_t pos,
+            const SentinelVecs& sentinels
+        ) noexcept
+        {
+#if defined(CSV_SIMD_DISPATCH)
+            // Resolved once per process; thread-safe static initialization.
+            static const SentinelScanFn kernel = sentinel_scan_kernel(active_simd_level());
+            return kernel(data, pos, sentinels);
+#elif defined(CSV_SIMD_AVX2)
+            return find_next_non_special_avx2(data, pos, sentinels);
+#elif defined(CSV_SIMD_SSE2)
+            return find_next_non_special_sse2(data, pos, sentinels);
+#elif defined(CSV_SIMD_NEON)
+            return find_next_non_special_neon(data, pos, sentinels);
 #else
-            (void)data; (void)sentinels;
+            return find_next_non_special_scalar(data, pos, sentinels);
+#endif
+        }
+
+        // Quote-only counterparts of the sentinel kernels, for use while inside a
+        // quoted field. Same contract: skip complete lanes without a quote byte
+        // and leave the sub-lane tail to the caller.
+        inline size_t find_next_quote_scalar(
+            csv::string_view,
+            size_t pos,
+            const SentinelVecs&
+        ) noexcept {
+            return pos;
+        }
+
+#if defined(CSV_SIMD_AVX2)
+        inline size_t find_next_quote_avx2(
+#elif defined(CSV_SIMD_DISPATCH)
+        CSV_TARGET_AVX2 inline size_t find_next_quote_avx2(
+#endif
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_DISPATCH)
+            csv::string_view data,
+            size_t pos,
+            const SentinelVecs& sentinels
+        ) noexcept {
+            const __m256i v_quote = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sentinels.v_quote.data()));
+
+            while (pos + 32 <= data.size()) {
+                const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data.data() + pos));
+                const int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, v_quote));
+
+                if (mask != 0)
+                    return pos + CSV_TZCNT32(static_cast<unsigned>(mask));
+                pos += 32;
+            }
+
+            return pos;
+        }
+#endif
+
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_SSE2)
+        inline size_t find_next_quote_sse2(
+            csv::string_view data,
+            size_t pos,
+            const SentinelVecs& sentinels
+        ) noexcept {
+            const __m128i v_quote = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sentinels.v_quote.data()));
+
+            while (pos + 16 <= data.size()) {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data.data() + pos));
+                const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, v_quote));
+
+                if (mask != 0)
+                    return pos + CSV_TZCNT32(static_cast<unsigned>(mask));
+                pos += 16;
+            }
+
+            return pos;
+        }
 #endif
+
+#if defined(CSV_SIMD_AVX512)
+        CSV_TARGET_AVX512BW inline size_t find_next_quote_avx512(
+            csv::string_view data,
+            size_t pos,
+            const SentinelVecs& sentinels
+        ) noexcept {
+            const __m512i v_quote = _mm512_set1_epi8(sentinels.v_quote[0]);
+
+            while (pos + 64 <= data.size()) {
+                const __m512i bytes = _mm512_loadu_si512(reinterpret_cast<const void*>(data.data() + pos));
+                const __mmask64 mask = _mm512_cmpeq_epi8_mask(bytes, v_quote);
+
+                if (mask != 0) {
+                    const auto low = static_cast<unsigned>(mask & 0xFFFFFFFFu);
+                    if (low != 0)
+                        return pos + CSV_TZCNT32(low);
+                    return pos + 32 + CSV_TZCNT32(static_cast<unsigned>(mask >> 32));
+                }
+                pos += 64;
+            }
+
+            return pos;
+        }
+#endif
+
+#if defined(CSV_SIMD_NEON)
+        inline size_t find_next_quote_neon(
+            csv::string_view data,
+            size_t pos,
+            const SentinelVecs& sentinels
+        ) noexcept {
+            const uint8x16_t v_quote = vld1q_u8(reinterpret_cast<const uint8_t*>(sentinels.v_quote.data()));
+
+            while (pos + 16 <= data.size()) {
+                const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(data.data() + pos));
+                const uint8x16_t quotes = vceqq_u8(bytes, v_quote);
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+                if (vmaxvq_u8(quotes) == 0) {
+                    pos += 16;
+                    continue;
+                }
+#endif
+
+                uint8_t lanes[16];
+                vst1q_u8(lanes, quotes);
+                for (size_t i = 0; i < 16; ++i) {
+                    if (lanes[i] != 0)
+                        return pos + i;
+                }
+                pos += 16;
+            }
+
             return pos;
         }
+#endif
+
+        /** Quote-only kernel compiled for the given tier, or nullptr if this build lacks one. */
+        inline SentinelScanFn quote_scan_kernel(SIMDLevel level) noexcept {
+            switch (level) {
+            case SIMDLevel::SCALAR:
+                return &find_next_quote_scalar;
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_SSE2)
+            case SIMDLevel::SSE2:
+                return &find_next_quote_sse2;
+#endif
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_DISPATCH)
+            case SIMDLevel::AVX2:
+                return &find_next_quote_avx2;
+#endif
+#if defined(CSV_SIMD_AVX512)
+            case SIMDLevel::AVX512:
+                return &find_next_quote_avx512;
+#endif
+#if defined(CSV_SIMD_NEON)
+            case SIMDLevel::NEON:
+                return &find_next_quote_neon;
+#endif
+            default:
+                return nullptr;
+            }
+        }
+
+        // Inside a quoted field only the quote byte can change parser state, so
+        // this needs a single compare per vector instead of four.
+        inline size_t find_next_quote(
+            csv::string_view data,
+            size_t pos,
+            const SentinelVecs& sentinels
+        ) noexcept
+        {
+#if defined(CSV_SIMD_DISPATCH)
+            static const SentinelScanFn kernel = quote_scan_kernel(active_simd_level());
+            return kernel(data, pos, sentinels);
+#elif defined(CSV_SIMD_AVX2)
+            return find_next_quote_avx2(data, pos, sentinels);
+#elif defined(CSV_SIMD_SSE2)
+            return find_next_quote_sse2(data, pos, sentinels);
+#elif defined(CSV_SIMD_NEON)
+            return find_next_quote_neon(data, pos, sentinels);
+#else
+            return find_next_quote_scalar(data, pos, sentinels);
+#endif
+        }
+
+        inline unsigned trailing_zeros64(uint64_t bits) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index = 0;
+#  if defined(_M_X64) || defined(_M_ARM64)
+            _BitScanForward64(&index, bits);
+            return static_cast<unsigned>(index);
+#  else
+            if (static_cast<uint32_t>(bits) != 0) {
+                _BitScanForward(&index, static_cast<uint32_t>(bits));
+                return static_cast<unsigned>(index);
+            }
+            _BitScanForward(&index, static_cast<uint32_t>(bits >> 32));
+            return static_cast<unsigned>(index) + 32;
+#  endif
+#else
+            return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+        }
+
+        inline unsigned popcount64(uint64_t bits) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_popcountll(bits));
+#else
+            // MSVC's __popcnt64 faults on pre-POPCNT CPUs; SWAR is portable.
+            bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+            bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+            bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+            return static_cast<unsigned>((bits * 0x0101010101010101ull) >> 56);
+#endif
+        }
+
+        /** Bytes covered by one structural-index block. */
+        constexpr size_t STRUCTURAL_BLOCK_SIZE = 64;
+
+        /** Per-byte bitmaps for one 64-byte block; bit i describes block[i].
+         *
+         *  `quote_prefix` is the inclusive prefix-XOR of `quote`: bit i is set
+         *  when an odd number of quote bytes occur in block[0..i].
+         */
+        struct StructuralBlockMasks {
+            uint64_t quote = 0;
+            uint64_t quote_prefix = 0;
+            uint64_t delim = 0;
+            uint64_t lf = 0;
+            uint64_t cr = 0;
+        };
+
+        /** Signature shared by every structural block kernel.
+         *
+         *  Kernels instantiated with Quoting = false skip the quote compare and
+         *  prefix-XOR and leave both quote masks zero; the unquoted engine only
+         *  needs delimiter and line-ending bits.
+         */
+        using StructuralMaskFn = void(*)(const char*, const SentinelVecs&, StructuralBlockMasks&) noexcept;
+
+        /** Portable prefix-XOR; the AVX2/AVX-512 kernels use a carry-less multiply instead. */
+        CONSTEXPR_14 uint64_t prefix_xor(uint64_t bits) noexcept {
+            bits ^= bits << 1;
+            bits ^= bits << 2;
+            bits ^= bits << 4;
+            bits ^= bits << 8;
+            bits ^= bits << 16;
+            bits ^= bits << 32;
+            return bits;
+        }
+
+        template<bool Quoting = true>
+        inline void structural_block_masks_scalar(
+            const char* block,
+            const SentinelVecs& sentinels,
+            StructuralBlockMasks& masks
+        ) noexcept {
+            masks = StructuralBlockMasks();
+            for (size_t i = 0; i < STRUCTURAL_BLOCK_SIZE; ++i) {
+                const uint64_t bit = uint64_t(1) << i;
+                const char ch = block[i];
+                if (Quoting && ch == sentinels.v_quote[0]) masks.quote |= bit;
+                if (ch == sentinels.v_delim[0]) masks.delim |= bit;
+                if (ch == '\n') masks.lf |= bit;
+                if (ch == '\r') masks.cr |= bit;
+            }
+
+            IF_CONSTEXPR(Quoting) {
+                masks.quote_prefix = prefix_xor(masks.quote);
+            }
+        }
+
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_SSE2)
+        template<bool Quoting = true>
+        inline void structural_block_masks_sse2(
+            const char* block,
+            const SentinelVecs& sentinels,
+            StructuralBlockMasks& masks
+        ) noexcept {
+            const __m128i v_delim = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sentinels.v_delim.data()));
+            const __m128i v_quote = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sentinels.v_quote.data()));
+            const __m128i v_lf    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sentinels.v_lf.data()));
+            const __m128i v_cr    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sentinels.v_cr.data()));
+
+            masks = StructuralBlockMasks();
+            for (unsigned lane = 0; lane < 4; ++lane) {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + lane * 16));
+                const unsigned shift = lane * 16;
+                IF_CONSTEXPR(Quoting) {
+                    masks.quote |= uint64_t(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, v_quote)))) << shift;
+                }
+                masks.delim |= uint64_t(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, v_delim)))) << shift;
+                masks.lf    |= uint64_t(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, v_lf)))) << shift;
+                masks.cr    |= uint64_t(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, v_cr)))) << shift;
+            }
+
+            IF_CONSTEXPR(Quoting) {
+                masks.quote_prefix = prefix_xor(masks.quote);
+            }
+        }
+#endif
+
+#if defined(CSV_SIMD_DISPATCH)
+        // Carry-less multiply by all-ones computes prefix-XOR in one instruction.
+        CSV_TARGET_AVX2 inline uint64_t prefix_xor_clmul(uint64_t bits) noexcept {
+            const __m128i product = _mm_clmulepi64_si128(
+                _mm_set_epi64x(0, static_cast<long long>(bits)),
+                _mm_set1_epi8(static_cast<char>(0xFF)),
+                0
+            );
+
+            uint64_t result = 0;
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(&result), product);
+            return result;
+        }
+
+        CSV_TARGET_AVX2 inline uint64_t movemask64_avx2(__m256i lo, __m256i hi, __m256i needle) noexcept {
+            const auto low = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+            const auto high = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+            return uint64_t(low) | (uint64_t(high) << 32);
+        }
+
+        template<bool Quoting = true>
+        CSV_TARGET_AVX2 inline void structural_block_masks_avx2(
+            const char* block,
+            const SentinelVecs& sentinels,
+            StructuralBlockMasks& masks
+        ) noexcept {
+            const __m256i v_delim = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sentinels.v_delim.data()));
+            const __m256i v_quote = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sentinels.v_quote.data()));
+            const __m256i v_lf    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sentinels.v_lf.data()));
+            const __m256i v_cr    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sentinels.v_cr.data()));
+
+            const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+            const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+
+            masks.delim = movemask64_avx2(lo, hi, v_delim);
+            masks.lf = movemask64_avx2(lo, hi, v_lf);
+            masks.cr = movemask64_avx2(lo, hi, v_cr);
+            IF_CONSTEXPR(Quoting) {
+                masks.quote = movemask64_avx2(lo, hi, v_quote);
+                masks.quote_prefix = prefix_xor_clmul(masks.quote);
+            }
+            else {
+                masks.quote = 0;
+                masks.quote_prefix = 0;
+            }
+        }
+#endif
+
+#if defined(CSV_SIMD_AVX512)
+        template<bool Quoting = true>
+        CSV_TARGET_AVX512BW inline void structural_block_masks_avx512(
+            const char* block,
+            const SentinelVecs& sentinels,
+            StructuralBlockMasks& masks
+        ) noexcept {
+            const __m512i bytes = _mm512_loadu_si512(reinterpret_cast<const void*>(block));
+            masks.delim = _mm512_cmpeq_epi8_mask(bytes, _mm512_set1_epi8(sentinels.v_delim[0]));
+            masks.lf = _mm512_cmpeq_epi8_mask(bytes, _mm512_set1_epi8('\n'));
+            masks.cr = _mm512_cmpeq_epi8_mask(bytes, _mm512_set1_epi8('\r'));
+            IF_CONSTEXPR(!Quoting) {
+                masks.quote = 0;
+                masks.quote_prefix = 0;
+                return;
+            }
+
+            masks.quote = _mm512_cmpeq_epi8_mask(bytes, _mm512_set1_epi8(sentinels.v_quote[0]));
+
+            const __m128i product = _mm_clmulepi64_si128(
+                _mm_set_epi64x(0, static_cast<long long>(masks.quote)),
+                _mm_set1_epi8(static_cast<char>(0xFF)),
+                0
+            );
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(&masks.quote_prefix), product);
+        }
+#endif
+
+#if defined(CSV_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+        inline uint64_t neon_movemask64(
+            uint8x16_t a,
+            uint8x16_t b,
+            uint8x16_t c,
+            uint8x16_t d
+        ) noexcept {
+            static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+            const uint8x16_t w = vld1q_u8(weights);
+            uint64_t result = 0;
+            const uint8x16_t parts[4] = { vandq_u8(a, w), vandq_u8(b, w), vandq_u8(c, w), vandq_u8(d, w) };
+            for (unsigned i = 0; i < 4; ++i) {
+                const uint64_t low = vaddv_u8(vget_low_u8(parts[i]));
+                const uint64_t high = vaddv_u8(vget_high_u8(parts[i]));
+                result |= (low | (high << 8)) << (i * 16);
+            }
+            return result;
+        }
+
+        template<bool Quoting = true>
+        inline void structural_block_masks_neon(
+            const char* block,
+            const SentinelVecs& sentinels,
+            StructuralBlockMasks& masks
+        ) noexcept {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(block);
+            const uint8x16_t b0 = vld1q_u8(bytes);
+            const uint8x16_t b1 = vld1q_u8(bytes + 16);
+            const uint8x16_t b2 = vld1q_u8(bytes + 32);
+            const uint8x16_t b3 = vld1q_u8(bytes + 48);
+
+            const uint8x16_t v_quote = vdupq_n_u8(static_cast<uint8_t>(sentinels.v_quote[0]));
+            const uint8x16_t v_delim = vdupq_n_u8(static_cast<uint8_t>(sentinels.v_delim[0]));
+            const uint8x16_t v_lf = vdupq_n_u8('\n');
+            const uint8x16_t v_cr = vdupq_n_u8('\r');
+
+            masks.delim = neon_movemask64(vceqq_u8(b0, v_delim), vceqq_u8(b1, v_delim), vceqq_u8(b2, v_delim), vceqq_u8(b3, v_delim));
+            masks.lf = neon_movemask64(vceqq_u8(b0, v_lf), vceqq_u8(b1, v_lf), vceqq_u8(b2, v_lf), vceqq_u8(b3, v_lf));
+            masks.cr = neon_movemask64(vceqq_u8(b0, v_cr), vceqq_u8(b1, v_cr), vceqq_u8(b2, v_cr), vceqq_u8(b3, v_cr));
+            IF_CONSTEXPR(Quoting) {
+                masks.quote = neon_movemask64(vceqq_u8(b0, v_quote), vceqq_u8(b1, v_quote), vceqq_u8(b2, v_quote), vceqq_u8(b3, v_quote));
+                masks.quote_prefix = prefix_xor(masks.quote);
+            }
+            else {
+                masks.quote = 0;
+                masks.quote_prefix = 0;
+            }
+        }
+#endif
+
+        /** Structural block kernel compiled for the given tier, or nullptr. */
+        template<bool Quoting = true>
+        inline StructuralMaskFn structural_mask_kernel(SIMDLevel level) noexcept {
+            switch (level) {
+            case SIMDLevel::SCALAR:
+                return &structural_block_masks_scalar<Quoting>;
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_SSE2)
+            case SIMDLevel::SSE2:
+                return &structural_block_masks_sse2<Quoting>;
+#endif
+#if defined(CSV_SIMD_DISPATCH)
+            case SIMDLevel::AVX2:
+                return &structural_block_masks_avx2<Quoting>;
+#elif defined(CSV_SIMD_AVX2)
+            case SIMDLevel::AVX2:
+                return &structural_block_masks_sse2<Quoting>;
+#endif
+#if defined(CSV_SIMD_AVX512)
+            case SIMDLevel::AVX512:
+                return &structural_block_masks_avx512<Quoting>;
+#endif
+#if defined(CSV_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+            case SIMDLevel::NEON:
+                return &structural_block_masks_neon<Quoting>;
+#endif
+            default:
+                return nullptr;
+            }
+        }
+
+        /** Fill quote/delimiter/newline bitmaps for the 64 bytes at `block`.
+         *
+         *  Callers must guarantee STRUCTURAL_BLOCK_SIZE readable bytes.
+         */
+        template<bool Quoting = true>
+        inline void find_structural_masks(
+            const char* block,
+            const SentinelVecs& sentinels,
+            StructuralBlockMasks& masks
+        ) noexcept {
+#if defined(CSV_NO_SIMD)
+            structural_block_masks_scalar<Quoting>(block, sentinels, masks);
+#else
+            static const StructuralMaskFn kernel = structural_mask_kernel<Quoting>(active_simd_level())
+                ? structural_mask_kernel<Quoting>(active_simd_level())
+                : &structural_block_masks_scalar<Quoting>;
+            kernel(block, sentinels, masks);
+#endif
+        }
+
+        /** Signature shared by every doubled-quote compaction kernel.
+         *
+         *  Copies `field` to `out`, collapsing each escaped quote pair into a
+         *  single quote, and returns the number of bytes written. `out` must
+         *  hold field.size() bytes.
+         */
+        using QuoteCompactFn = size_t(*)(csv::string_view, char, char*) noexcept;
+
+        /** Reference compaction loop; also handles the sub-block tail of the SIMD kernels. */
+        inline size_t compact_doubled_quotes_scalar(
+            csv::string_view field,
+            char quote,
+            char* out
+        ) noexcept {
+            char* const begin = out;
+            for (size_t i = 0; i < field.size(); ++i) {
+                if (field[i] == quote && i + 1 < field.size() && field[i + 1] == quote) {
+                    *(out++) = field[i++];
+                    continue;
+                }
+
+                *(out++) = field[i];
+            }
+
+            return static_cast<size_t>(out - begin);
+        }
+
+        /** Mark the second quote of every escaped pair in a 64-byte block.
+         *
+         *  Pairs are matched left to right, so within a run of quotes every
+         *  odd-offset quote is dropped. `carry` is set when the block ends in
+         *  an unmatched quote, in which case a quote at bit 0 of the next block
+         *  completes the pair.
+         */
+        inline uint64_t doubled_quote_drop_mask(uint64_t quotes, uint64_t& carry) noexcept {
+            const uint64_t even_bits = 0x5555555555555555ull;
+            const uint64_t pair_openers = quotes & ~carry;
+            const uint64_t follows_opener = (pair_openers << 1) | carry;
+
+            // Runs starting on an odd bit get +1 so the carry of the addition
+            // flips their parity; the sum's set bits then mark where a run
+            // started on an even bit.
+            const uint64_t odd_run_starts = pair_openers & ~even_bits & ~follows_opener;
+            const uint64_t sum = odd_run_starts + pair_openers;
+            carry = sum < odd_run_starts ? 1 : 0;
+
+            const uint64_t second_of_pair = (even_bits ^ (sum << 1)) & follows_opener;
+            return second_of_pair & quotes;
+        }
+
+        inline size_t compact_doubled_quotes_tail(
+            csv::string_view field,
+            char quote,
+            uint64_t carry,
+            char* out
+        ) noexcept {
+            size_t skipped = 0;
+            if (carry != 0 && !field.empty() && field[0] == quote) {
+                skipped = 1;
+            }
+
+            return compact_doubled_quotes_scalar(field.substr(skipped), quote, out);
+        }
+
+        /** Copy a 64-byte block to `out`, omitting bytes flagged in `drop`. */
+        inline char* copy_kept_bytes(const char* block, uint64_t drop, char* out) noexcept {
+            size_t from = 0;
+            while (drop != 0) {
+                const size_t to = trailing_zeros64(drop);
+                std::memcpy(out, block + from, to - from);
+                out += to - from;
+                from = to + 1;
+                drop &= drop - 1;
+            }
+
+            std::memcpy(out, block + from, STRUCTURAL_BLOCK_SIZE - from);
+            return out + (STRUCTURAL_BLOCK_SIZE - from);
+        }
+
+        /** PSHUFB control words that pack the kept bytes of an 8-byte group to the front. */
+        struct QuoteCompactTable {
+            QuoteCompactTable() noexcept {
+                for (unsigned drop = 0; drop < 256; ++drop) {
+                    uint8_t kept_count = 0;
+                    for (uint8_t i = 0; i < 8; ++i) {
+                        if (((drop >> i) & 1) == 0) {
+                            shuffle[drop][kept_count++] = i;
+                        }
+                    }
+
+                    for (uint8_t i = kept_count; i < 8; ++i) {
+                        shuffle[drop][i] = 0x80;
+                    }
+                    kept[drop] = kept_count;
+                }
+            }
+
+            std::array<std::array<uint8_t, 8>, 256> shuffle;
+            std::array<uint8_t, 256> kept;
+        };
+
+        inline const QuoteCompactTable& quote_compact_table() noexcept {
+            static const QuoteCompactTable table;
+            return table;
+        }
+
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_SSE2)
+        inline size_t compact_doubled_quotes_sse2(
+            csv::string_view field,
+            char quote,
+            char* out
+        ) noexcept {
+            const __m128i v_quote = _mm_set1_epi8(quote);
+            char* const begin = out;
+            uint64_t carry = 0;
+            size_t pos = 0;
+
+            for (; pos + STRUCTURAL_BLOCK_SIZE <= field.size(); pos += STRUCTURAL_BLOCK_SIZE) {
+                uint64_t quotes = 0;
+                for (unsigned lane = 0; lane < 4; ++lane) {
+                    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(field.data() + pos + lane * 16));
+                    quotes |= uint64_t(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, v_quote)))) << (lane * 16);
+                }
+
+                out = copy_kept_bytes(field.data() + pos, doubled_quote_drop_mask(quotes, carry), out);
+            }
+
+            out += compact_doubled_quotes_tail(field.substr(pos), quote, carry, out);
+            return static_cast<size_t>(out - begin);
+        }
+#endif
+
+#if defined(CSV_SIMD_AVX2)
+        inline char* compact_block_pshufb(
+#elif defined(CSV_SIMD_DISPATCH)
+        CSV_TARGET_AVX2 inline char* compact_block_pshufb(
+#endif
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_DISPATCH)
+            const char* block,
+            uint64_t drop,
+            char* out,
+            const QuoteCompactTable& table
+        ) noexcept {
+            if (drop == 0) {
+                std::memcpy(out, block, STRUCTURAL_BLOCK_SIZE);
+                return out + STRUCTURAL_BLOCK_SIZE;
+            }
+
+            // Each 8-byte store may spill up to 7 stale bytes past the packed
+            // output, but never past the current input position, so it stays
+            // inside the field-sized destination.
+            for (unsigned group = 0; group < 8; ++group) {
+                const auto group_drop = static_cast<unsigned>((drop >> (group * 8)) & 0xFF);
+                const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(block + group * 8));
+                const __m128i control = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(table.shuffle[group_drop].data()));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(bytes, control));
+                out += table.kept[group_drop];
+            }
+
+            return out;
+        }
+#endif
+
+#if defined(CSV_SIMD_AVX2)
+        inline size_t compact_doubled_quotes_avx2(
+#elif defined(CSV_SIMD_DISPATCH)
+        CSV_TARGET_AVX2 inline size_t compact_doubled_quotes_avx2(
+#endif
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_DISPATCH)
+            csv::string_view field,
+            char quote,
+            char* out
+        ) noexcept {
+            const QuoteCompactTable& table = quote_compact_table();
+            const __m256i v_quote = _mm256_set1_epi8(quote);
+            char* const begin = out;
+            uint64_t carry = 0;
+            size_t pos = 0;
+
+            for (; pos + STRUCTURAL_BLOCK_SIZE <= field.size(); pos += STRUCTURAL_BLOCK_SIZE) {
+                const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(field.data() + pos));
+                const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(field.data() + pos + 32));
+                const auto low = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, v_quote)));
+                const auto high = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, v_quote)));
+                const uint64_t quotes = uint64_t(low) | (uint64_t(high) << 32);
+
+                out = compact_block_pshufb(field.data() + pos, doubled_quote_drop_mask(quotes, carry), out, table);
+            }
+
+            out += compact_doubled_quotes_tail(field.substr(pos), quote, carry, out);
+            return static_cast<size_t>(out - begin);
+        }
+#endif
+
+#if defined(CSV_SIMD_AVX512)
+        CSV_TARGET_AVX512BW inline size_t compact_doubled_quotes_avx512(
+            csv::string_view field,
+            char quote,
+            char* out
+        ) noexcept {
+            const QuoteCompactTable& table = quote_compact_table();
+            const __m512i v_quote = _mm512_set1_epi8(quote);
+            char* const begin = out;
+            uint64_t carry = 0;
+            size_t pos = 0;
+
+            for (; pos + STRUCTURAL_BLOCK_SIZE <= field.size(); pos += STRUCTURAL_BLOCK_SIZE) {
+                const __m512i bytes = _mm512_loadu_si512(reinterpret_cast<const void*>(field.data() + pos));
+                const uint64_t quotes = _mm512_cmpeq_epi8_mask(bytes, v_quote);
+
+                out = compact_block_pshufb(field.data() + pos, doubled_quote_drop_mask(quotes, carry), out, table);
+            }
+
+            out += compact_doubled_quotes_tail(field.substr(pos), quote, carry, out);
+            return static_cast<size_t>(out - begin);
+        }
+#endif
+
+        /** Compaction kernel compiled for the given tier, or nullptr.
+         *
+         *  NEON has no cheap byte movemask, so it keeps the scalar loop.
+         */
+        inline QuoteCompactFn quote_compact_kernel(SIMDLevel level) noexcept {
+            switch (level) {
+            case SIMDLevel::SCALAR:
+                return &compact_doubled_quotes_scalar;
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_SSE2)
+            case SIMDLevel::SSE2:
+                return &compact_doubled_quotes_sse2;
+#endif
+#if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_DISPATCH)
+            case SIMDLevel::AVX2:
+                return &compact_doubled_quotes_avx2;
+#endif
+#if defined(CSV_SIMD_AVX512)
+            case SIMDLevel::AVX512:
+                return &compact_doubled_quotes_avx512;
+#endif
+#if defined(CSV_SIMD_NEON)
+            case SIMDLevel::NEON:
+                return &compact_doubled_quotes_scalar;
+#endif
+            default:
+                return nullptr;
+            }
+        }
+
+        /** Collapse escaped quote pairs in `field` into `out`; returns the bytes written. */
+        inline size_t compact_doubled_quotes(
+            csv::string_view field,
+            char quote,
+            char* out
+        ) noexcept {
+#if defined(CSV_NO_SIMD)
+            return compact_doubled_quotes_scalar(field, quote, out);
+#else
+            static const QuoteCompactFn kernel = quote_compact_kernel(active_simd_level())
+                ? quote_compact_kernel(active_simd_level())
+                : &compact_doubled_quotes_scalar;
+            return kernel(field, quote, out);
+#endif
+        }
     }
 }
@@ -397,6 +397,11 @@ namespace csv {
         const int PAGE_SIZE = 4096;
 #endif
 
+        /** Assumed cache line size, used to keep producer and consumer state
+         *  of lock-free queues from sharing a line.
+         */
+        constexpr size_t CSV_CACHE_LINE_SIZE = 64;
+
         /** Default chunk size for lazy-loading large CSV files
          * 
          * The worker thread reads this many bytes at a time by default (10MB).
@@ -47,12 +47,16 @@ namespace csv {
         CONSTEXPR_VALUE_14 char ERROR_CHUNK_PARALLEL_APPLY_ZERO[] =
             "chunk_parallel_apply() requires a non-zero chunk size.";
         CONSTEXPR_VALUE_14 char ERROR_READER_NULL_STREAM[] = "CSVReader requires a non-null stream";
+        CONSTEXPR_VALUE_14 char ERROR_READER_NOT_FOLLOWING[] = "Only a CSVReader following a file has checkpoints";
         CONSTEXPR_VALUE_14 char ERROR_MULTIPLE_DELIMITERS[] =
             "There is more than one possible delimiter.";
         CONSTEXPR_VALUE_14 char ERROR_CHUNK_SIZE_FLOOR_PREFIX[] = "Chunk size must be at least ";
         CONSTEXPR_VALUE_14 char ERROR_CHUNK_SIZE_FLOOR_MIDDLE[] = " bytes (500KB). Provided: ";
         CONSTEXPR_VALUE_14 char ERROR_CHUNK_SIZE_CEILING_PREFIX[] = "Chunk size must fit in uint32_t. Maximum: ";
         CONSTEXPR_VALUE_14 char ERROR_CHUNK_SIZE_CEILING_MIDDLE[] = ". Provided: ";
+        CONSTEXPR_VALUE_14 char ERROR_ROW_INDEX_INVALID[] = "Not a valid row index: ";
+        CONSTEXPR_VALUE_14 char ERROR_ROW_INDEX_STALE[] = "Row index is out of date for ";
+        CONSTEXPR_VALUE_14 char ERROR_ROW_INDEX_OUT_OF_RANGE[] = "Row range is outside the row index.";
         CONSTEXPR_VALUE_14 char ERROR_CHAR_OVERLAP_PREFIX[] =
             "There should be no overlap between the quote character, "
             "the set of possible delimiters "
@@ -139,6 +143,32 @@ namespace csv {
             throw std::system_error(error, make_mmap_failure_message(filename, offset, length));
         }
 
+        [[noreturn]] inline void throw_file_read_failure(
+            int error,
+            const std::string& filename,
+            size_t offset,
+            size_t length
+        ) {
+            throw std::system_error(
+                std::error_code(error, std::generic_category()),
+                "Read failed during CSV parsing: file='" + filename
+                    + "' offset=" + std::to_string(offset)
+                    + " length=" + std::to_string(length)
+            );
+        }
+
+        [[noreturn]] inline void throw_decompression_failure(
+            const std::string& filename,
+            size_t offset,
+            const std::string& reason
+        ) {
+            throw std::runtime_error(
+                "Decompression failed during CSV parsing: file='" + filename
+                    + "' offset=" + std::to_string(offset)
+                    + ": " + reason
+            );
+        }
+
         [[noreturn]] inline void throw_row_too_large_for_chunk(size_t chunk_size) {
             throw std::runtime_error(make_row_larger_than_chunk_message(chunk_size));
         }
@@ -166,5 +196,17 @@ namespace csv {
         [[noreturn]] inline void throw_column_index_out_of_range() {
             throw std::out_of_range(ERROR_COLUMN_INDEX_OUT_OF_RANGE);
         }
+
+        [[noreturn]] inline void throw_invalid_row_index(const std::string& index_filename) {
+            throw std::runtime_error(make_prefixed_message(ERROR_ROW_INDEX_INVALID, index_filename));
+        }
+
+        [[noreturn]] inline void throw_stale_row_index(const std::string& filename) {
+            throw std::runtime_error(make_prefixed_message(ERROR_ROW_INDEX_STALE, filename));
+        }
+
+        [[noreturn]] inline void throw_row_index_out_of_range() {
+            throw std::out_of_range(ERROR_ROW_INDEX_OUT_OF_RANGE);
+        }
     }
 }
@@ -3,7 +3,9 @@
  */
 
 #pragma once
+#include <chrono>
 #include <iterator>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -13,7 +15,7 @@
 
 namespace csv {
     namespace internals {
-        template<typename RowSink, typename ParsePolicy, typename FieldPolicy, typename RowPolicy>
+        template<typename RowSink, typename ParsePolicy, typename FieldPolicy, typename RowPolicy, typename Dialect>
         class CSVParserCore;
         namespace parser {
             class CSVParserDriverBase;
@@ -21,6 +23,7 @@ namespace csv {
     }
 
     class CSVReader;
+    class ParseExecutor;
 
     /** Determines how to handle rows that are shorter or longer than the majority */
     enum class VariableColumnPolicy {
@@ -36,6 +39,18 @@ namespace csv {
         CASE_INSENSITIVE = 1  /**< Case-insensitive match */
     };
 
+    /** Selects how the parser locates field and row boundaries */
+    enum class ParserEngine {
+        STATE_MACHINE = 0,   /**< Byte-at-a-time DFA with SIMD skipping of plain runs (default) */
+        STRUCTURAL_INDEX = 1 /**< 64-byte block bitmaps of delimiters, newlines and quotes */
+    };
+
+    /** Selects how CSVReader reads a file it opens by name */
+    enum class FileReadMode {
+        MMAP = 0,       /**< Memory-map the file (default) */
+        ASYNC_READ = 1  /**< Keep aligned reads in flight ahead of the parser via io_uring or pread() */
+    };
+
     /** Stores the inferred format of a CSV file. */
     struct CSVGuessResult {
         char delim;
@@ -133,6 +148,18 @@ namespace csv {
             return *this;
         }
 
+        /** Selects the parser engine.
+         *
+         *  ParserEngine::STRUCTURAL_INDEX classifies 64-byte blocks at once and
+         *  walks the resulting bitmaps, which pays off on wide rows and long
+         *  quoted fields. Rows are identical to the default engine: blocks with
+         *  non-RFC 4180 quoting are handed back to the state machine.
+         */
+        CONSTEXPR_14 CSVFormat& parser_engine(ParserEngine engine) {
+            this->_parser_engine = engine;
+            return *this;
+        }
+
         /** Sets the chunk size used when reading the CSV
          *
          *  @param[in] size Chunk size in bytes (minimum: CSV_CHUNK_SIZE_FLOOR)
@@ -158,6 +185,92 @@ namespace csv {
             return *this;
         }
 
+        /** Set how many parsed chunks the background reader may keep ahead of the consumer.
+         *
+         *  With threading enabled, CSVReader keeps one parser thread alive for the
+         *  whole read. After each chunk it pauses until the consumer has left at
+         *  most `n_chunks` chunks' worth of rows queued, so memory stays bounded at
+         *  roughly `(n_chunks + 1) * chunk_size` of parsed data. A value of 0 waits
+         *  for the queue to drain before parsing the next chunk. Has no effect when
+         *  threading is disabled.
+         */
+        CONSTEXPR_14 CSVFormat& readahead_chunks(size_t n_chunks) {
+            this->_readahead_chunks = n_chunks;
+            return *this;
+        }
+
+        /** Map a file-backed source once instead of once per chunk.
+         *
+         *  By default CSVReader maps each chunk-sized window of a file separately,
+         *  which keeps address-space use small. With this option the whole file is
+         *  mapped once and chunks are views into that mapping. The kernel is told
+         *  the file is read sequentially, the next window is prefetched while the
+         *  current one is parsed, and pages of windows whose rows have all been
+         *  released are dropped from memory. If the file cannot be mapped in one
+         *  piece (e.g. a large file in a 32-bit process), windowed mapping is used.
+         *  Has no effect on stream sources.
+         */
+        CONSTEXPR_14 CSVFormat& mmap_whole_file(bool enabled = true) {
+            this->_mmap_whole_file = enabled;
+            return *this;
+        }
+
+        /** Ask for transparent huge pages on a whole-file mapping.
+         *
+         *  Best effort: only honored on Linux kernels that support huge pages for
+         *  read-only file mappings. Has no effect unless mmap_whole_file() is on.
+         */
+        CONSTEXPR_14 CSVFormat& mmap_huge_pages(bool enabled = true) {
+            this->_mmap_huge_pages = enabled;
+            return *this;
+        }
+
+        /** Choose how CSVReader reads a file it opens by name.
+         *
+         *  FileReadMode::ASYNC_READ reads the file into pooled buffers instead
+         *  of mapping it, keeping async_read_depth() large aligned reads in
+         *  flight ahead of the parser. A slow device then stalls the reads
+         *  rather than the parsing thread on page faults. Reads go through
+         *  io_uring when the kernel allows it and pread() otherwise. Only
+         *  POSIX builds have this mode; elsewhere the file is memory-mapped.
+         */
+        CONSTEXPR_14 CSVFormat& file_read_mode(FileReadMode mode) {
+            this->_file_read_mode = mode;
+            return *this;
+        }
+
+        /** Set how many reads FileReadMode::ASYNC_READ keeps in flight.
+         *
+         *  The default of 2 double-buffers: one window is read while the
+         *  previous one is parsed. A value of 0 is treated as 1.
+         */
+        CONSTEXPR_14 CSVFormat& async_read_depth(size_t depth) {
+            this->_async_read_depth = depth;
+            return *this;
+        }
+
+        /** Bypass the page cache (O_DIRECT) for FileReadMode::ASYNC_READ.
+         *
+         *  Best effort: if the file system refuses O_DIRECT, buffered reads
+         *  are used instead.
+         */
+        CONSTEXPR_14 CSVFormat& direct_io(bool enabled = true) {
+            this->_direct_io = enabled;
+            return *this;
+        }
+
+        /** Set how long a CSVDescriptorSource keeps reading before it parses.
+         *
+         *  Once the first bytes of a batch arrive, reads continue for up to
+         *  `delay`, or until a chunk is full, before the batch is parsed.
+         *  The default of zero parses every read for the lowest row latency;
+         *  a few milliseconds batch busy feeds into fewer, larger windows.
+         */
+        CONSTEXPR_14 CSVFormat& max_read_delay(std::chrono::microseconds delay) {
+            this->_max_read_delay = delay;
+            return *this;
+        }
+
         /** Set the worker count used by speculative parallel parsing.
          *
          *  A value of 0 means "choose automatically" when the reader is created.
@@ -173,6 +286,64 @@ namespace csv {
             return *this;
         }
 
+        /** Overlap speculative parsing of consecutive windows.
+         *
+         *  By default each speculative window is parsed by all workers, then
+         *  validated and released while the workers wait, and only then is the
+         *  next window read. With this option the workers parse window N+1 while
+         *  window N is validated and its rows are queued, and while the next
+         *  window is read from the source. Rows keep their source order. Has no
+         *  effect unless speculative parallel parsing is in use.
+         */
+        CONSTEXPR_14 CSVFormat& speculative_pipeline(bool enabled = true) {
+            this->_speculative_pipeline = enabled;
+            return *this;
+        }
+
+        /** Adapt speculative chunk sizes to how speculation is going.
+         *
+         *  By default a speculative window is always split into chunks of
+         *  chunk_size() bytes. With this option chunks shrink, down to 1/16 of
+         *  that, in regions where chunks need repairs or start ambiguously, and
+         *  grow back in clean regions. When speculation keeps failing, windows
+         *  are parsed serially for a while before it is tried again. Has no
+         *  effect unless speculative parallel parsing is in use.
+         */
+        CONSTEXPR_14 CSVFormat& speculative_adaptive_chunks(bool enabled = true) {
+            this->_speculative_adaptive_chunks = enabled;
+            return *this;
+        }
+
+        /** Run speculative parallel parsing on a shared ParseExecutor.
+         *
+         *  Readers created with this format submit chunk-parse tasks to
+         *  `executor` instead of starting their own worker threads. The number
+         *  of chunks a reader keeps in flight is still set by
+         *  speculative_parallel_threads(), capped at the executor's worker count;
+         *  0 lets a reader use every worker. Pass nullptr to fall back to
+         *  ParseExecutor::global() or to per-reader workers.
+         */
+        CSVFormat& parse_executor(std::shared_ptr<ParseExecutor> executor) {
+            this->_parse_executor = std::move(executor);
+            return *this;
+        }
+
+        /** Pin speculative parse workers to a CPU set.
+         *
+         *  Worker `i` of the reader's own pool runs on `cpus[i % cpus.size()]`.
+         *  Chunk rows are allocated by the worker that parses them, so on NUMA
+         *  hosts they land in memory local to that worker's node. When the
+         *  CPUs span several nodes, each chunk is handed to a worker on the
+         *  node that holds its bytes. Linux only; elsewhere, and for CPUs the
+         *  process may not use, workers stay unpinned. An empty set (the
+         *  default) leaves placement to the OS. Readers on a shared
+         *  ParseExecutor use the executor's CPU set instead.
+         */
+        CSVFormat& parse_worker_cpus(std::vector<int> cpus) {
+            this->_parse_worker_cpus = std::move(cpus);
+            return *this;
+        }
+
         /** Enable parser-time scalar classification for typed consumers.
          *
          *  Disabled by default so normal string-only parsing keeps the historical
@@ -183,6 +354,19 @@ namespace csv {
             return *this;
         }
 
+        /** Parse common dialects with a parser compiled for them.
+         *
+         *  When the delimiter resolves to `,` or `\t` with `"` quoting, the reader
+         *  uses a parser specialized on that dialect, so character classification
+         *  compiles to constant comparisons instead of table lookups. Other
+         *  dialects, and readers with this option off (the default), use the
+         *  runtime tables. Delimiter guessing still runs when it is enabled.
+         */
+        CONSTEXPR_14 CSVFormat& specialize_dialect(bool enabled = true) {
+            this->_specialize_dialect = enabled;
+            return *this;
+        }
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
         char get_delim() const {
             // This error should never be received by end users.
@@ -209,9 +393,22 @@ namespace csv {
             return false;
 #endif
         }
+        CONSTEXPR size_t get_readahead_chunks() const { return this->_readahead_chunks; }
+        CONSTEXPR bool is_mmap_whole_file_enabled() const { return this->_mmap_whole_file; }
+        CONSTEXPR bool is_mmap_huge_pages_enabled() const { return this->_mmap_huge_pages; }
+        CONSTEXPR FileReadMode get_file_read_mode() const { return this->_file_read_mode; }
+        CONSTEXPR size_t get_async_read_depth() const { return this->_async_read_depth; }
+        CONSTEXPR bool is_direct_io_enabled() const { return this->_direct_io; }
+        CONSTEXPR std::chrono::microseconds get_max_read_delay() const { return this->_max_read_delay; }
         CONSTEXPR size_t get_speculative_parallel_threads() const { return this->_speculative_parallel_threads; }
         CONSTEXPR size_t get_speculative_parallel_min_bytes() const { return this->_speculative_parallel_min_bytes; }
+        CONSTEXPR bool is_speculative_pipeline_enabled() const { return this->_speculative_pipeline; }
+        CONSTEXPR bool is_speculative_adaptive_chunks_enabled() const { return this->_speculative_adaptive_chunks; }
+        const std::shared_ptr<ParseExecutor>& get_parse_executor() const { return this->_parse_executor; }
+        const std::vector<int>& get_parse_worker_cpus() const { return this->_parse_worker_cpus; }
         CONSTEXPR bool is_eager_field_classification_enabled() const { return this->_eager_field_classification; }
+        CONSTEXPR ParserEngine get_parser_engine() const { return this->_parser_engine; }
+        CONSTEXPR bool is_dialect_specialization_enabled() const { return this->_specialize_dialect; }
         CONSTEXPR bool should_use_speculative_parallel(size_t source_size, size_t n_threads) const {
 #if CSV_ENABLE_THREADS
             return this->_threading
@@ -243,7 +440,7 @@ namespace csv {
         }
 
         friend CSVReader;
-        template<typename RowSink, typename ParsePolicy, typename FieldPolicy, typename RowPolicy>
+        template<typename RowSink, typename ParsePolicy, typename FieldPolicy, typename RowPolicy, typename Dialect>
         friend class internals::CSVParserCore;
         friend internals::parser::CSVParserDriverBase;
         
@@ -287,13 +484,52 @@ namespace csv {
         /**< Whether CSVReader may use runtime parser threads */
         bool _threading = true;
 
+        /**< Parsed chunks the background reader may hold ahead of the consumer */
+        size_t _readahead_chunks = 1;
+
+        /**< Map file sources once rather than per chunk */
+        bool _mmap_whole_file = false;
+
+        /**< Request transparent huge pages for whole-file mappings */
+        bool _mmap_huge_pages = false;
+
+        /**< How files opened by name are read */
+        FileReadMode _file_read_mode = FileReadMode::MMAP;
+
+        /**< Reads kept in flight by FileReadMode::ASYNC_READ */
+        size_t _async_read_depth = 2;
+
+        /**< Open files with O_DIRECT under FileReadMode::ASYNC_READ */
+        bool _direct_io = false;
+
+        /**< How long descriptor sources batch reads before parsing */
+        std::chrono::microseconds _max_read_delay{ 0 };
+
         /**< 0 means the reader may choose automatically */
         size_t _speculative_parallel_threads = 0;
 
         /**< Minimum source size before speculative parallel parsing is considered */
         size_t _speculative_parallel_min_bytes = internals::CSV_SPECULATIVE_PARALLEL_MIN_BYTES;
 
+        /**< Whether speculative windows are parsed while the previous one is released */
+        bool _speculative_pipeline = false;
+
+        /**< Whether speculative chunk sizes follow repair and ambiguity feedback */
+        bool _speculative_adaptive_chunks = false;
+
+        /**< Shared workers for speculative parsing; null means global or per-reader workers */
+        std::shared_ptr<ParseExecutor> _parse_executor;
+
+        /**< CPUs that speculative parse workers are pinned to; empty means unpinned */
+        std::vector<int> _parse_worker_cpus;
+
         /**< Whether to precompute field scalar classifications during parsing */
         bool _eager_field_classification = false;
+
+        /**< Field/row boundary engine */
+        ParserEngine _parser_engine = ParserEngine::STATE_MACHINE;
+
+        /**< Whether common dialects use a compile-time specialized parser */
+        bool _specialize_dialect = false;
     };
 }
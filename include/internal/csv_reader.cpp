@@ -21,21 +21,44 @@ namespace csv {
         this->read_scheduler_.join();
         this->read_scheduler_.rethrow_exception_if_any();
 
+        // The producer may have queued its last rows and exited between the
+        // emptiness check above and is_waitable().
+        if (!this->records->empty()) return true;
+
         if (this->parser->eof()) return false;
 
-        if (this->_read_requested && this->records->empty()) {
+        if (this->_read_requested && this->records->empty() && !this->parser->defers_rows()) {
             internals::throw_row_too_large_for_chunk(this->_chunk_size);
         }
 
-        this->read_scheduler_.run(
-            [this] { this->read_csv(this->_chunk_size); },
-            [this] { this->records->notify_all(); }
-        );
+        if (this->_format.is_threading_enabled()) {
+            // One producer runs until EOF; it only returns early when
+            // stop_read_ahead() interrupts it, and is restarted here.
+            this->read_scheduler_.run(
+                [this] { this->read_ahead(); },
+                [this] { this->records->notify_all(); }
+            );
+            return true;
+        }
+
+        this->read_scheduler_.run([this] { this->read_csv(this->_chunk_size); });
         this->read_scheduler_.rethrow_exception_if_any();
         this->_read_requested = true;
         return true;
     }
 
+    CSV_INLINE void CSVReader::stop_read_ahead() noexcept {
+        if (this->records) {
+            this->records->interrupt_producer();
+        }
+
+        if (this->parser) {
+            this->parser->interrupt_read();
+        }
+
+        this->read_scheduler_.join();
+    }
+
 #ifdef _MSC_VER
 #pragma endregion Reading helpers
 #endif
@@ -43,6 +66,94 @@ namespace csv {
 #ifdef _MSC_VER
 #pragma region Format and header helpers
 #endif
+    CSV_INLINE CSVReader::CSVReader(
+        csv::string_view filename,
+        size_t offset,
+        size_t length,
+        const CSVFormat& format
+    ) : _format(format),
+        read_scheduler_(format.is_threading_enabled()) {
+        CSVMemorySource file = internals::map_csv_file(filename);
+        const internals::parser::ByteRangeSplit split = internals::parser::find_byte_range_split(
+            file.data, offset, length, format);
+
+        // Every split takes its column names from the header, not from its own first row.
+        CSVFormat split_format = split.format;
+        if (split_format.get_header() >= 0) {
+            CSVFormat head_format = split.format;
+            head_format.header_row(split.format.get_header());
+            CSVReader head(CSVMemorySource(file.data.substr(0, split.body_start), file.owner), head_format);
+            split_format.column_names(head.get_col_names());
+        }
+
+        this->init_parser(std::unique_ptr<internals::parser::CSVParserDriverBase>(
+            new internals::parser::MemoryParser(
+                file.data.substr(split.begin, split.end - split.begin),
+                std::move(file.owner),
+                split_format,
+                this->col_names,
+                split.begin
+            )
+        ));
+    }
+
+#if CSV_FOLLOW_FILES
+    CSV_INLINE CSVReader::CSVReader(CSVFollowSource source, const CSVFormat& format)
+        : _format(format),
+          read_scheduler_(format.is_threading_enabled()) {
+        std::unique_ptr<internals::parser::FollowParser> follow(new internals::parser::FollowParser(
+            source.filename,
+            source.resume_from,
+            source.poll_interval,
+            format,
+            this->col_names
+        ));
+
+        // Reading may start anywhere, so the column names come from the header instead of the first rows.
+        const CSVFormat& resolved = follow->get_resolved_format().format;
+        if (resolved.get_header() >= 0) {
+            CSVReader head(CSVMemorySource(follow->header()), resolved);
+            follow->use_column_names(head.get_col_names());
+        }
+
+        this->follow_parser_ = follow.get();
+        this->init_parser(std::move(follow));
+    }
+
+    CSV_INLINE CSVCheckpoint CSVReader::checkpoint() {
+        if (!this->follow_parser_) {
+            throw std::logic_error(internals::ERROR_READER_NOT_FOLLOWING);
+        }
+
+        return this->follow_parser_->checkpoint(*this->records);
+    }
+#endif
+
+    CSV_INLINE CSVMemorySource internals::map_csv_file(csv::string_view filename) {
+        const std::string path(filename);
+#if !defined(__EMSCRIPTEN__)
+        std::error_code error;
+        auto mmap = std::make_shared<mio::mmap_source>();
+        mmap->map(path, 0, mio::map_entire_file, error);
+        if (!error) {
+            const csv::string_view data(mmap->data(), mmap->size());
+            return CSVMemorySource(data, std::move(mmap));
+        }
+#endif
+
+        // Empty files cannot be mapped.
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            internals::throw_cannot_open_file(filename);
+        }
+
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        auto buffer = std::make_shared<std::string>(contents.str());
+        const csv::string_view data(*buffer);
+        return CSVMemorySource(data, std::move(buffer));
+    }
+
     CSV_INLINE void CSVReader::init_parser(
         std::unique_ptr<internals::parser::CSVParserDriverBase> parser_impl
     ) {
@@ -181,6 +292,11 @@ namespace csv {
             this->parser->set_output(*this->records);
             this->parser->next(bytes);
 
+            // A pipelined parser releases a window's rows on the following call.
+            while (this->records->empty() && this->parser->defers_rows() && !this->parser->eof()) {
+                this->parser->next(bytes);
+            }
+
             if (!this->header_trimmed) {
                 this->trim_header();
             }
@@ -196,6 +312,58 @@ namespace csv {
         return true;
     }
 
+    /**
+     * Parse chunks until EOF on a long-lived worker thread.
+     *
+     * After each chunk the producer publishes it and pauses on back-pressure
+     * until at most CSVFormat::get_readahead_chunks() chunks' worth of rows
+     * remain queued, instead of exiting and waiting for check_for_rows() to
+     * spawn a new thread once the queue is empty.
+     *
+     * A chunk that produces no rows before EOF means a row is larger than the
+     * chunk size (Issue #218). The consumer-side guard in check_for_rows() only
+     * sees one chunk per worker cycle, so the producer checks this itself.
+     * Pipelined speculative parsing releases each window's rows on the next
+     * call and performs this check on the windows it releases instead.
+     */
+    CSV_INLINE void CSVReader::read_ahead() {
+        this->records->notify_all();
+
+        try {
+            this->parser->set_output(*this->records);
+
+            do {
+                const size_t pushed_before = this->records->pushed_count();
+                this->parser->next(this->_chunk_size);
+                const size_t chunk_rows = this->records->pushed_count() - pushed_before;
+
+                if (chunk_rows == 0 && !this->parser->eof() && !this->parser->defers_rows()) {
+                    // A parser waiting for its source to grow gives up when interrupted.
+                    if (this->records->producer_interrupted()) {
+                        break;
+                    }
+
+                    internals::throw_row_too_large_for_chunk(this->_chunk_size);
+                }
+
+                if (this->parser->eof()) {
+                    break;
+                }
+
+                if (!this->records->wait_for_capacity(
+                    this->_format.get_readahead_chunks() * chunk_rows)) {
+                    break;
+                }
+            } while (true);
+        }
+        catch (...) {
+            this->records->kill_all();
+            throw;
+        }
+
+        this->records->kill_all();
+    }
+
     CSV_INLINE bool CSVReader::read_row(CSVRow &row) {
         while (this->check_for_rows()) {
             if (this->records->empty())
@@ -19,12 +19,91 @@
 #include "csv_exceptions.hpp"
 #include "data_type.hpp"
 #include "csv_format.hpp"
+#include "parse_executor.hpp"
+#include "parser/async_file.hpp"
+#include "parser/byte_range.hpp"
+#include "parser/compressed.hpp"
+#include "parser/descriptor.hpp"
+#include "parser/follow.hpp"
+#include "parser/memory.hpp"
 #include "parser/mmap.hpp"
 #include "parser/scheduler.hpp"
 #include "parser/stream.hpp"
 
 /** The all encompassing namespace */
 namespace csv {
+    /** CSV bytes already in memory, for parsing in place with CSVReader.
+     *
+     *  `owner` is kept alive by the reader and by every row parsed from
+     *  `data`. With no owner, the caller must keep `data` valid and unchanged
+     *  until the reader and all of its rows are gone.
+     *
+     *  When `data` is a slice of a larger source, `offset` is where it starts
+     *  in that source, so CSVRow::byte_offset() stays relative to the source.
+     */
+    struct CSVMemorySource {
+        explicit CSVMemorySource(csv::string_view data, std::shared_ptr<void> owner = nullptr, size_t offset = 0)
+            : data(data), owner(std::move(owner)), offset(offset) {}
+
+        csv::string_view data;
+        std::shared_ptr<void> owner;
+        size_t offset;
+    };
+
+#if CSV_DESCRIPTOR_SOURCES
+    /** A readable file descriptor such as a pipe, socket or terminal, for
+     *  live feeds read with CSVReader.
+     *
+     *  The reader only reads from `fd`; the caller closes it after the
+     *  reader is gone.
+     */
+    struct CSVDescriptorSource {
+        explicit CSVDescriptorSource(int fd) : fd(fd) {}
+
+        int fd;
+    };
+#endif
+
+#if CSV_FOLLOW_FILES
+    /** A file to keep reading as it grows, like `tail -F`.
+     *
+     *  `resume_from` is a CSVReader::checkpoint() saved by an earlier reader
+     *  of the same path; by default reading starts after the header.
+     *  `poll_interval` bounds how long growth or rotation can go unnoticed
+     *  when change notifications are unavailable or miss it.
+     */
+    struct CSVFollowSource {
+        explicit CSVFollowSource(
+            csv::string_view filename,
+            const CSVCheckpoint& resume_from = CSVCheckpoint(),
+            std::chrono::milliseconds poll_interval = internals::parser::CSV_FOLLOW_POLL_INTERVAL
+        ) : filename(filename), resume_from(resume_from), poll_interval(poll_interval) {}
+
+        std::string filename;
+        CSVCheckpoint resume_from;
+        std::chrono::milliseconds poll_interval;
+    };
+#endif
+
+#if CSV_COMPRESSED_SOURCES
+    /** A gzip, BGZF or zstd compressed file, decompressed as it is read.
+     *
+     *  The codec of every member is detected from its magic bytes, so the
+     *  file name's extension does not matter. Available when the library
+     *  was built with zlib (gzip, BGZF) or libzstd (zstd).
+     */
+    struct CSVCompressedSource {
+        explicit CSVCompressedSource(csv::string_view filename) : filename(filename) {}
+
+        std::string filename;
+    };
+#endif
+
+    namespace internals {
+        /** The whole of `filename`: memory-mapped where possible, otherwise read into a buffer. */
+        CSVMemorySource map_csv_file(csv::string_view filename);
+    }
+
     /** @class CSVReader
      *  @brief Main class for parsing CSVs from files and in-memory sources
      *
@@ -35,7 +114,7 @@ namespace csv {
      *  **Streaming semantics:** CSVReader is a single-pass streaming reader. Every read
      *  operation — read_row(), the iterator interface — pulls rows permanently
      *  from the internal queue. Rows consumed by one interface are not visible to another.
-     *  There is no rewind or seek.
+     *  There is no rewind or seek; use CSVRowIndex to read parts of a file directly.
      *
     *  **Ownership and sharing:** CSVReader is non-copyable and move-enabled. It manages
     *  live parsing state (worker thread, internal queue, and optional owned stream), so
@@ -109,7 +188,8 @@ namespace csv {
          ///@{
         /** @brief Construct CSVReader from filename.
          * 
-         * Native builds use CODE PATH 1 of 2: MmapParser with mio for maximum performance.
+         * Native builds use CODE PATH 1 of 2: MmapParser with mio for maximum performance,
+         * or AsyncFileParser when CSVFormat::file_read_mode() asks for FileReadMode::ASYNC_READ.
          * Emscripten builds fall back to the stream-based implementation because mmap is unavailable.
          *
          * During construction, parser installation performs an initial synchronous metadata
@@ -133,12 +213,42 @@ namespace csv {
 
             this->init_from_stream(*this->owned_stream, format);
 #else
+#if CSV_ASYNC_FILE_READS
+            if (format.get_file_read_mode() == FileReadMode::ASYNC_READ) {
+                this->init_parser(std::unique_ptr<internals::parser::CSVParserDriverBase>(
+                    new internals::parser::AsyncFileParser(filename, format, this->col_names)
+                ));
+                return;
+            }
+#endif
             this->init_parser(std::unique_ptr<internals::parser::CSVParserDriverBase>(
                 new internals::parser::MmapParser(filename, format, this->col_names)
             ));
 #endif
         }
 
+        /** @brief Construct CSVReader over one byte range of a file
+         *
+         *  For splitting a file between processes. The reader returns the
+         *  records that start in [offset, offset + length): it begins at the
+         *  first record boundary at or after `offset` and reads through the
+         *  record that straddles `offset + length`, so splits that tile the
+         *  file return every row exactly once.
+         *
+         *  The delimiter, header and column names are resolved from the head
+         *  of the file, so every split agrees on them, and
+         *  CSVRow::byte_offset() stays relative to the start of the file.
+         *
+         *  @see internals::parser::RecordBoundaryFinder for how a boundary is
+         *       found when `offset` falls inside a quoted field
+         */
+        CSVReader(
+            csv::string_view filename,
+            size_t offset,
+            size_t length,
+            const CSVFormat& format = CSVFormat::guess_csv()
+        );
+
         /** @brief Construct CSVReader from std::istream
          * 
          * Uses StreamParser. On native builds this is CODE PATH 2 of 2 and remains independent
@@ -175,6 +285,84 @@ namespace csv {
 
             this->init_from_stream(*this->owned_stream, format);
         }
+
+        /** @brief Construct CSVReader over CSV bytes already in memory
+         *
+         *  Uses MemoryParser, which parses windows of `source.data` in place
+         *  instead of copying them out of a stream. The source size is known,
+         *  so large buffers use speculative parallel parsing like the filename
+         *  constructor.
+         *
+         *  @see csv::parse(), csv::parse_unsafe()
+         */
+        CSVReader(CSVMemorySource source, const CSVFormat& format = CSVFormat::guess_csv())
+            : _format(format),
+              read_scheduler_(format.is_threading_enabled()) {
+            this->init_parser(std::unique_ptr<internals::parser::CSVParserDriverBase>(
+                new internals::parser::MemoryParser(
+                    source.data, std::move(source.owner), format, this->col_names, source.offset)
+            ));
+        }
+
+#if CSV_DESCRIPTOR_SOURCES
+        /** @brief Construct CSVReader over a live feed on a file descriptor
+         *
+         *  Uses DescriptorParser, which parses whatever bytes each read()
+         *  returns, so rows are available as soon as they arrive instead of
+         *  once a whole chunk has been read. CSVFormat::max_read_delay()
+         *  batches reads for throughput. Set the delimiter and header row
+         *  explicitly to avoid waiting for a head to guess them from.
+         *
+         *  Only available on POSIX systems.
+         */
+        CSVReader(CSVDescriptorSource source, const CSVFormat& format = CSVFormat::guess_csv())
+            : _format(format),
+              read_scheduler_(format.is_threading_enabled()) {
+            this->init_parser(std::unique_ptr<internals::parser::CSVParserDriverBase>(
+                new internals::parser::DescriptorParser(source.fd, format, this->col_names)
+            ));
+        }
+#endif
+
+#if CSV_FOLLOW_FILES
+        /** @brief Construct CSVReader that follows a growing file
+         *
+         *  Uses FollowParser. At the end of the file, reads wait for more
+         *  rows instead of finishing: iteration only ends when the caller
+         *  stops it. An incomplete last row is held back until it is
+         *  finished. When the file is rotated or truncated, reading moves to
+         *  the new contents and skips their header rows.
+         *
+         *  Column names always come from the header at the top of the file,
+         *  so a reader resuming from a checkpoint matches the one that saved it.
+         *  The constructor waits until that header has been written.
+         *
+         *  Only available on POSIX systems; change notifications use inotify
+         *  on Linux and polling elsewhere.
+         *
+         *  @see checkpoint()
+         */
+        CSVReader(CSVFollowSource source, const CSVFormat& format = CSVFormat::guess_csv());
+#endif
+
+#if CSV_COMPRESSED_SOURCES
+        /** @brief Construct CSVReader over a compressed file
+         *
+         *  Uses CompressedFileParser, which decompresses straight into the
+         *  windows it parses instead of piping through a decompressor.
+         *  BGZF blocks (bgzip) and zstd frames that record their size
+         *  (pzstd) are decompressed in parallel on the speculative parser's
+         *  workers; plain gzip members and other zstd frames are
+         *  decompressed in order, one window at a time.
+         */
+        CSVReader(CSVCompressedSource source, const CSVFormat& format = CSVFormat::guess_csv())
+            : _format(format),
+              read_scheduler_(format.is_threading_enabled()) {
+            this->init_parser(std::unique_ptr<internals::parser::CSVParserDriverBase>(
+                new internals::parser::CompressedFileParser(source.filename, format, this->col_names)
+            ));
+        }
+#endif
         ///@}
 
         CSVReader(const CSVReader&) = delete;             ///< Not copyable
@@ -185,33 +373,34 @@ namespace csv {
          * Required so C++11 builds can return CSVReader by value from helpers like
          * csv::parse()/csv::parse_unsafe(), where copy elision is not guaranteed.
          *
-         * Any active read scheduler on the source is joined before moving parser state to
-         * avoid a thread continuing to run against the source object's address.
+         * Any active read-ahead worker on the source is stopped and joined before moving
+         * parser state to avoid a thread continuing to run against the source object's
+         * address. The destination restarts it on the next read.
          */
         CSVReader(CSVReader&& other) noexcept :
             read_scheduler_(other._format.is_threading_enabled()) {
-            other.read_scheduler_.join();
+            other.stop_read_ahead();
             this->move_state_from(other);
         }
 
         /** Move assignment.
          *
-         * Joins active workers on both sides before transferring parser state.
+         * Stops and joins active workers on both sides before transferring parser state.
          */
         CSVReader& operator=(CSVReader&& other) noexcept {
             if (this == &other) {
                 return *this;
             }
 
-            this->read_scheduler_.join();
-            other.read_scheduler_.join();
+            this->stop_read_ahead();
+            other.stop_read_ahead();
             this->move_state_from(other);
 
             return *this;
         }
 
         ~CSVReader() {
-            this->read_scheduler_.join();
+            this->stop_read_ahead();
         }
 
         /** @name Retrieving CSV Rows */
@@ -263,6 +452,18 @@ namespace csv {
 
         /** Returns true if we have reached end of file */
         bool eof() const noexcept { return this->parser->eof(); }
+
+#if CSV_FOLLOW_FILES
+        /** Where the rows this reader has not returned yet begin.
+         *
+         *  Pass it to CSVFollowSource to continue in a later reader without
+         *  rereading the file. With the iterators, the row last dereferenced
+         *  counts as returned.
+         *
+         *  @throws std::logic_error unless this reader was built from a CSVFollowSource
+         */
+        CSVCheckpoint checkpoint();
+#endif
         ///@}
 
         /** @name CSV Metadata */
@@ -343,6 +544,11 @@ namespace csv {
         /** Helper class which actually does the parsing */
         std::unique_ptr<internals::parser::CSVParserDriverBase> parser = nullptr;
 
+#if CSV_FOLLOW_FILES
+        /** `parser` when following a file, for checkpoint() */
+        internals::parser::FollowParser* follow_parser_ = nullptr;
+#endif
+
         /** Queue of parsed CSV rows */
         std::unique_ptr<RowCollection> records{new RowCollection(100)};
 
@@ -362,6 +568,9 @@ namespace csv {
          */
         ///@{
         bool read_csv(size_t bytes = internals::CSV_CHUNK_SIZE_DEFAULT);
+
+        /** Keep parsing chunks until EOF, pausing on queue back-pressure. */
+        void read_ahead();
         ///@}
 
         /**@}*/
@@ -381,6 +590,10 @@ namespace csv {
             this->_format = std::move(other._format);
             this->col_names = std::move(other.col_names);
             this->parser = std::move(other.parser);
+#if CSV_FOLLOW_FILES
+            this->follow_parser_ = other.follow_parser_;
+            other.follow_parser_ = nullptr;
+#endif
             this->records = std::move(other.records);
             this->owned_stream = std::move(other.owned_stream);
             this->n_cols = other.n_cols;
@@ -447,6 +660,9 @@ namespace csv {
          */
         bool check_for_rows();
 
+        /** Interrupt a read-ahead worker paused on back-pressure and join it. */
+        void stop_read_ahead() noexcept;
+
         /** Drain as many already-queued rows as possible into a caller-owned chunk buffer.
          *
          *  Applies the same variable-column filtering policy as read_row(), but amortizes
@@ -39,7 +39,7 @@
 
 namespace csv {
     namespace internals {
-        template<typename RowSink, typename ParsePolicy, typename FieldPolicy, typename RowPolicy>
+        template<typename RowSink, typename ParsePolicy, typename FieldPolicy, typename RowPolicy, typename Dialect>
         class CSVParserCore;
         struct CSVRowRowPolicy;
         namespace parser {
@@ -543,7 +543,7 @@ namespace csv {
     /** Data structure for representing CSV rows */
     class CSVRow {
     public:
-        template<typename RowSink, typename ParsePolicy, typename FieldPolicy, typename RowPolicy>
+        template<typename RowSink, typename ParsePolicy, typename FieldPolicy, typename RowPolicy, typename Dialect>
         friend class internals::CSVParserCore;
         friend struct internals::CSVRowRowPolicy;
         friend internals::parser::CSVParserDriverBase;
@@ -0,0 +1,556 @@
+/** @file
+ *  @brief A persistent index of row offsets for seeking within CSV files
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "csv_exceptions.hpp"
+#include "csv_format.hpp"
+#include "csv_reader.hpp"
+#include "csv_utility.hpp"
+#include "parser/row_counter.hpp"
+
+namespace csv {
+    /** Rows between the checkpoints of a CSVRowIndex built with default settings */
+    constexpr size_t CSV_ROW_INDEX_STRIDE_DEFAULT = 1024;
+
+    namespace internals {
+        CONSTEXPR_VALUE_14 char CSV_ROW_INDEX_MAGIC[] = "CSVROWIX";
+        constexpr uint64_t CSV_ROW_INDEX_VERSION = 1;
+
+        /** Size and modification time a CSVRowIndex was built against. */
+        struct CSVFileStamp {
+            uint64_t size = 0;
+            int64_t mtime_ns = 0;
+
+            bool operator==(const CSVFileStamp& other) const noexcept {
+                return this->size == other.size && this->mtime_ns == other.mtime_ns;
+            }
+
+            bool operator!=(const CSVFileStamp& other) const noexcept {
+                return !(*this == other);
+            }
+        };
+
+        /** Read the size and modification time of `filename`; false if it cannot be stat'ed. */
+        inline bool stat_csv_file(const std::string& filename, CSVFileStamp& stamp) {
+#if defined(_WIN32)
+            struct _stat64 info;
+            if (_stat64(filename.c_str(), &info) != 0) {
+                return false;
+            }
+
+            stamp.mtime_ns = static_cast<int64_t>(info.st_mtime) * 1000000000;
+#else
+            struct stat info;
+            if (stat(filename.c_str(), &info) != 0) {
+                return false;
+            }
+
+#if defined(__APPLE__)
+            stamp.mtime_ns = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+            stamp.mtime_ns = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+#endif
+            stamp.size = static_cast<uint64_t>(info.st_size);
+            return true;
+        }
+
+        /** Bytes [begin, end) of `filename`, mapped when possible. */
+        inline CSVMemorySource read_file_slice(const std::string& filename, size_t begin, size_t end) {
+            if (begin >= end) {
+                return CSVMemorySource(csv::string_view(), nullptr, begin);
+            }
+
+#if !defined(__EMSCRIPTEN__)
+            std::error_code error;
+            auto mmap = std::make_shared<mio::mmap_source>();
+            mmap->map(filename, begin, end - begin, error);
+            if (error) {
+                throw_mmap_failure(error, filename, begin, end - begin);
+            }
+
+            const csv::string_view data(mmap->data(), mmap->size());
+            return CSVMemorySource(data, std::move(mmap), begin);
+#else
+            std::ifstream file(filename, std::ios::binary);
+            if (!file) {
+                throw_cannot_open_file(filename);
+            }
+
+            auto buffer = std::make_shared<std::string>(end - begin, '\0');
+            file.seekg(static_cast<std::streamoff>(begin));
+            file.read(&(*buffer)[0], static_cast<std::streamsize>(buffer->size()));
+            if (static_cast<size_t>(file.gcount()) != buffer->size()) {
+                throw_stream_read_failure();
+            }
+
+            const csv::string_view data(*buffer);
+            return CSVMemorySource(data, std::move(buffer), begin);
+#endif
+        }
+
+        /** Fixed-width little-endian integers, so index files move between machines. */
+        inline void write_row_index_u64(std::ostream& out, uint64_t value) {
+            char bytes[8];
+            for (size_t i = 0; i < 8; ++i) {
+                bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+            }
+            out.write(bytes, 8);
+        }
+
+        inline bool read_row_index_u64(std::istream& in, uint64_t& value) {
+            unsigned char bytes[8];
+            if (!in.read(reinterpret_cast<char*>(bytes), 8)) {
+                return false;
+            }
+
+            value = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+            }
+            return true;
+        }
+    }
+
+    /** @class CSVRowIndex
+     *  @brief Byte offsets of every Nth row of a CSV file, for seeking without reparsing
+     *
+     *  Built once by a count_rows() pass, then saved next to the file and
+     *  reloaded on later runs. Every checkpoint is the start of a record, so
+     *  a parse can resume there with the DFA in its initial state: no
+     *  quote or partial-field state has to be stored.
+     *
+     *  read_rows() and seek_row() return an ordinary CSVReader over just the
+     *  requested rows, finding the exact start by scanning at most one
+     *  stride of rows from the nearest checkpoint. partition() splits the
+     *  file into byte ranges of about equal size for parallel readers.
+     *
+     *  @par Invalidation
+     *  The index records the file's size and modification time. load()
+     *  rejects an index whose file has changed, and read_rows() throws if
+     *  the file changes after the index was loaded.
+     *
+     *  @par Example
+     *  @code{.cpp}
+     *  CSVRowIndex index = CSVRowIndex::open("big.csv");
+     *  for (auto& row : index.read_rows(5000000, 5000100)) {
+     *      // Rows 5000000 through 5000099, parsed from the nearest checkpoint
+     *  }
+     *  @endcode
+     */
+    class CSVRowIndex {
+    public:
+        /** A row whose starting byte offset is stored in the index */
+        struct Checkpoint {
+            size_t row;
+            size_t offset;
+        };
+
+        /** Rows [first_row, last_row), which occupy bytes [begin, end) of the file */
+        struct Range {
+            size_t first_row;
+            size_t last_row;
+            size_t begin;
+            size_t end;
+        };
+
+        /** Scan `filename` and index every `stride`-th row.
+         *
+         *  Rows are numbered as a CSVReader with `format` would return them,
+         *  so header rows and rows dropped by the VariableColumnPolicy are
+         *  not counted.
+         */
+        static CSVRowIndex build(
+            const std::string& filename,
+            const CSVFormat& format = CSVFormat::guess_csv(),
+            size_t stride = CSV_ROW_INDEX_STRIDE_DEFAULT
+        ) {
+            CSVRowIndex index;
+            index.filename_ = filename;
+            index.base_format_ = format;
+            index.stride_ = (std::max)(stride, size_t(1));
+            if (!internals::stat_csv_file(filename, index.stamp_)) {
+                internals::throw_cannot_open_file(filename);
+            }
+
+            CSVRowCount count = internals::count_file_rows(filename, format, index.stride_);
+            index.n_rows_ = count.n_rows;
+            index.n_cols_ = count.n_cols;
+            index.delimiter_ = count.format.get_delim();
+            index.quote_char_ = count.format.get_quote_char();
+            index.quoting_ = count.format.is_quoting_enabled();
+            index.header_ = count.format.get_header();
+            index.policy_ = count.format.get_variable_column_policy();
+            index.col_names_ = index.header_ >= 0
+                ? csv::get_col_names(filename, count.format)
+                : count.format.get_col_names();
+
+            index.checkpoints_.reserve(count.row_offsets.size());
+            for (size_t i = 0; i < count.row_offsets.size(); ++i) {
+                const size_t row = count.row_offset_rows.empty() ? i : count.row_offset_rows[i];
+                index.checkpoints_.push_back({ row, count.row_offsets[i] });
+            }
+
+            return index;
+        }
+
+        /** Load an index saved by save().
+         *
+         *  @param[in] format Supplies the options that do not affect row
+         *                    boundaries, such as trimming, to readers
+         *                    returned by read_rows().
+         *
+         *  @throws std::runtime_error If the index cannot be read, or
+         *                             `filename` has changed since it was built.
+         */
+        static CSVRowIndex load(
+            const std::string& filename,
+            const std::string& index_filename,
+            const CSVFormat& format = CSVFormat::guess_csv()
+        ) {
+            std::ifstream in(index_filename, std::ios::binary);
+            if (!in) {
+                internals::throw_cannot_open_file(index_filename);
+            }
+
+            char magic[sizeof(internals::CSV_ROW_INDEX_MAGIC) - 1];
+            uint64_t version = 0;
+            if (!in.read(magic, sizeof(magic))
+                || std::string(magic, sizeof(magic)) != internals::CSV_ROW_INDEX_MAGIC
+                || !internals::read_row_index_u64(in, version)
+                || version != internals::CSV_ROW_INDEX_VERSION) {
+                internals::throw_invalid_row_index(index_filename);
+            }
+
+            CSVRowIndex index;
+            index.filename_ = filename;
+            index.base_format_ = format;
+
+            uint64_t fields[11];
+            for (uint64_t& field : fields) {
+                if (!internals::read_row_index_u64(in, field)) {
+                    internals::throw_invalid_row_index(index_filename);
+                }
+            }
+
+            index.stamp_.size = fields[0];
+            index.stamp_.mtime_ns = static_cast<int64_t>(fields[1]);
+            index.stride_ = static_cast<size_t>(fields[2]);
+            index.n_rows_ = static_cast<size_t>(fields[3]);
+            index.n_cols_ = static_cast<size_t>(fields[4]);
+            index.delimiter_ = static_cast<char>(fields[5]);
+            index.quote_char_ = static_cast<char>(fields[6]);
+            index.quoting_ = fields[7] != 0;
+            index.header_ = static_cast<int>(static_cast<int64_t>(fields[8]));
+            index.policy_ = static_cast<VariableColumnPolicy>(fields[9]);
+
+            const uint64_t n_col_names = fields[10];
+            for (uint64_t i = 0; i < n_col_names; ++i) {
+                uint64_t length = 0;
+                if (!internals::read_row_index_u64(in, length) || length > index.stamp_.size) {
+                    internals::throw_invalid_row_index(index_filename);
+                }
+
+                std::string name(static_cast<size_t>(length), '\0');
+                if (length > 0 && !in.read(&name[0], static_cast<std::streamsize>(length))) {
+                    internals::throw_invalid_row_index(index_filename);
+                }
+                index.col_names_.push_back(std::move(name));
+            }
+
+            uint64_t n_checkpoints = 0;
+            if (!internals::read_row_index_u64(in, n_checkpoints) || n_checkpoints > index.n_rows_) {
+                internals::throw_invalid_row_index(index_filename);
+            }
+
+            index.checkpoints_.reserve(static_cast<size_t>(n_checkpoints));
+            for (uint64_t i = 0; i < n_checkpoints; ++i) {
+                uint64_t row = 0, offset = 0;
+                if (!internals::read_row_index_u64(in, row) || !internals::read_row_index_u64(in, offset)
+                    || row >= index.n_rows_ || offset > index.stamp_.size) {
+                    internals::throw_invalid_row_index(index_filename);
+                }
+                index.checkpoints_.push_back({ static_cast<size_t>(row), static_cast<size_t>(offset) });
+            }
+
+            if (!index.is_current()) {
+                internals::throw_stale_row_index(filename);
+            }
+
+            return index;
+        }
+
+        /** Load the sidecar index of `filename`, or build and save one if it
+         *  is missing, stale, or was built with a different delimiter,
+         *  quoting, VariableColumnPolicy or stride.
+         *
+         *  A sidecar that cannot be written, e.g. in a read-only directory,
+         *  is not an error; the index is then rebuilt on every open().
+         */
+        static CSVRowIndex open(
+            const std::string& filename,
+            const CSVFormat& format = CSVFormat::guess_csv(),
+            size_t stride = CSV_ROW_INDEX_STRIDE_DEFAULT
+        ) {
+            const std::string index_filename = sidecar_path(filename);
+            try {
+                CSVRowIndex index = load(filename, index_filename, format);
+                if (index.matches(format, (std::max)(stride, size_t(1)))) {
+                    return index;
+                }
+            }
+            catch (const std::runtime_error&) {}
+
+            CSVRowIndex index = build(filename, format, stride);
+            try {
+                index.save(index_filename);
+            }
+            catch (const std::runtime_error&) {}
+
+            return index;
+        }
+
+        /** Where open() keeps the index of `filename` */
+        static std::string sidecar_path(const std::string& filename) {
+            return filename + ".rowidx";
+        }
+
+        /** Write the index to `index_filename` */
+        void save(const std::string& index_filename) const {
+            std::ofstream out(index_filename, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                internals::throw_failed_open_for_writing(index_filename);
+            }
+
+            out.write(internals::CSV_ROW_INDEX_MAGIC, sizeof(internals::CSV_ROW_INDEX_MAGIC) - 1);
+            internals::write_row_index_u64(out, internals::CSV_ROW_INDEX_VERSION);
+            internals::write_row_index_u64(out, this->stamp_.size);
+            internals::write_row_index_u64(out, static_cast<uint64_t>(this->stamp_.mtime_ns));
+            internals::write_row_index_u64(out, this->stride_);
+            internals::write_row_index_u64(out, this->n_rows_);
+            internals::write_row_index_u64(out, this->n_cols_);
+            internals::write_row_index_u64(out, static_cast<unsigned char>(this->delimiter_));
+            internals::write_row_index_u64(out, static_cast<unsigned char>(this->quote_char_));
+            internals::write_row_index_u64(out, this->quoting_ ? 1 : 0);
+            internals::write_row_index_u64(out, static_cast<uint64_t>(static_cast<int64_t>(this->header_)));
+            internals::write_row_index_u64(out, static_cast<uint64_t>(this->policy_));
+
+            internals::write_row_index_u64(out, this->col_names_.size());
+            for (const std::string& name : this->col_names_) {
+                internals::write_row_index_u64(out, name.size());
+                out.write(name.data(), static_cast<std::streamsize>(name.size()));
+            }
+
+            internals::write_row_index_u64(out, this->checkpoints_.size());
+            for (const Checkpoint& checkpoint : this->checkpoints_) {
+                internals::write_row_index_u64(out, checkpoint.row);
+                internals::write_row_index_u64(out, checkpoint.offset);
+            }
+
+            if (!out.flush()) {
+                internals::throw_failed_open_for_writing(index_filename);
+            }
+        }
+
+        /** Whether the file still has the size and modification time the index was built against */
+        bool is_current() const {
+            internals::CSVFileStamp stamp;
+            return internals::stat_csv_file(this->filename_, stamp) && stamp == this->stamp_;
+        }
+
+        const std::string& filename() const noexcept { return this->filename_; }
+        size_t n_rows() const noexcept { return this->n_rows_; }
+        size_t stride() const noexcept { return this->stride_; }
+        size_t file_size() const noexcept { return static_cast<size_t>(this->stamp_.size); }
+        const std::vector<std::string>& get_col_names() const noexcept { return this->col_names_; }
+        const std::vector<Checkpoint>& checkpoints() const noexcept { return this->checkpoints_; }
+
+        /** Byte offset where `row` starts, or the file size for `row == n_rows()`.
+         *
+         *  Rows that are checkpoints are looked up directly; any other row is
+         *  found by counting forward from the checkpoint before it.
+         */
+        size_t row_offset(size_t row) const {
+            if (row > this->n_rows_) {
+                internals::throw_row_index_out_of_range();
+            }
+
+            if (row == this->n_rows_) {
+                return this->file_size();
+            }
+
+            auto next = std::upper_bound(
+                this->checkpoints_.begin(), this->checkpoints_.end(), row,
+                [](size_t target, const Checkpoint& checkpoint) { return target < checkpoint.row; }
+            );
+            if (next == this->checkpoints_.begin()) {
+                internals::throw_row_index_out_of_range();
+            }
+
+            const Checkpoint& checkpoint = *(next - 1);
+            if (checkpoint.row == row) {
+                return checkpoint.offset;
+            }
+
+            const size_t end = next == this->checkpoints_.end() ? this->file_size() : next->offset;
+            const CSVMemorySource slice = internals::read_file_slice(this->filename_, checkpoint.offset, end);
+
+            using namespace internals::parser;
+            const RowCountScanner scanner(this->delimiter_, this->quote_char_, this->quoting_);
+            RowCountPolicy policy;
+            policy.policy = this->policy_;
+            policy.n_cols = this->n_cols_;
+
+            RowCountChunk chunk;
+            chunk.offset = checkpoint.offset;
+            chunk.bytes = slice.data;
+            chunk.start_state = row_count_start_state(false, checkpoint.offset);
+            count_row_chunk(scanner, chunk, policy, 1);
+            if (chunk.end_state.row_has_bytes) {
+                // The file's last record, without a line ending
+                tally_row(chunk, policy, 1, chunk.end_state.row_start, end, chunk.end_state.row_delimiters + 1);
+            }
+
+            const size_t skip = row - checkpoint.row;
+            if (skip >= chunk.row_offsets.size()) {
+                internals::throw_stale_row_index(this->filename_);
+            }
+
+            return chunk.row_offsets[skip];
+        }
+
+        /** A CSVReader over rows [first, last) only.
+         *
+         *  Rows keep the file's column names, and CSVRow::byte_offset() still
+         *  reports offsets from the start of the file.
+         *
+         *  @throws std::out_of_range If the range is not within [0, n_rows()]
+         *  @throws std::runtime_error If the file has changed since the index was built
+         */
+        CSVReader read_rows(size_t first, size_t last) const {
+            if (first > last || last > this->n_rows_) {
+                internals::throw_row_index_out_of_range();
+            }
+
+            if (!this->is_current()) {
+                internals::throw_stale_row_index(this->filename_);
+            }
+
+            const size_t begin = this->row_offset(first);
+            const size_t end = this->row_offset(last);
+            return CSVReader(internals::read_file_slice(this->filename_, begin, end), this->range_format());
+        }
+
+        /** A CSVReader from `row` to the end of the file */
+        CSVReader seek_row(size_t row) const {
+            return this->read_rows(row, this->n_rows_);
+        }
+
+        /** Split the rows into at most `n_ranges` ranges of about equal byte size.
+         *
+         *  Ranges start at checkpoints, so reading each with read_rows() needs
+         *  no scanning. Fewer ranges are returned when there are fewer
+         *  checkpoints than requested.
+         */
+        std::vector<Range> partition(size_t n_ranges) const {
+            std::vector<Range> ranges;
+            if (this->checkpoints_.empty() || n_ranges == 0) {
+                return ranges;
+            }
+
+            const size_t body_begin = this->checkpoints_.front().offset;
+            const size_t body_size = this->file_size() - body_begin;
+            Range current = { 0, 0, body_begin, 0 };
+            auto cut = this->checkpoints_.begin() + 1;
+            for (size_t i = 1; i < n_ranges; ++i) {
+                const size_t target = body_begin + static_cast<size_t>(
+                    static_cast<double>(body_size) * static_cast<double>(i) / static_cast<double>(n_ranges));
+                cut = std::lower_bound(
+                    cut, this->checkpoints_.end(), target,
+                    [](const Checkpoint& checkpoint, size_t offset) { return checkpoint.offset < offset; }
+                );
+                if (cut == this->checkpoints_.end()) {
+                    break;
+                }
+
+                current.last_row = cut->row;
+                current.end = cut->offset;
+                ranges.push_back(current);
+                current = { cut->row, 0, cut->offset, 0 };
+                ++cut;
+            }
+
+            current.last_row = this->n_rows_;
+            current.end = this->file_size();
+            ranges.push_back(current);
+            return ranges;
+        }
+
+    private:
+        CSVRowIndex() = default;
+
+        /** Whether an index loaded from disk can serve a request for `format` and `stride` */
+        bool matches(const CSVFormat& format, size_t stride) const {
+            if (stride != this->stride_
+                || format.is_quoting_enabled() != this->quoting_
+                || (this->quoting_ && format.get_quote_char() != this->quote_char_)
+                || format.get_variable_column_policy() != this->policy_) {
+                return false;
+            }
+
+            if (!format.guess_delim() && format.get_delim() != this->delimiter_) {
+                return false;
+            }
+
+            return format.get_col_names().empty() || format.get_col_names() == this->col_names_;
+        }
+
+        /** The caller's format with the delimiter, quoting and header the index was built with */
+        CSVFormat range_format() const {
+            CSVFormat format = this->base_format_;
+            format.delimiter(this->delimiter_);
+            if (this->quoting_) {
+                format.quote(this->quote_char_);
+            }
+            else {
+                format.quote(false);
+            }
+
+            if (!this->col_names_.empty()) {
+                format.column_names(this->col_names_);
+            }
+            else {
+                format.no_header();
+            }
+
+            format.variable_columns(this->policy_);
+            return format;
+        }
+
+        std::string filename_;
+        internals::CSVFileStamp stamp_;
+        CSVFormat base_format_;
+        size_t stride_ = CSV_ROW_INDEX_STRIDE_DEFAULT;
+        size_t n_rows_ = 0;
+        size_t n_cols_ = 0;
+        char delimiter_ = ',';
+        char quote_char_ = '"';
+        bool quoting_ = true;
+        int header_ = 0;
+        VariableColumnPolicy policy_ = VariableColumnPolicy::IGNORE_ROW;
+        std::vector<std::string> col_names_;
+        std::vector<Checkpoint> checkpoints_;
+    };
+}
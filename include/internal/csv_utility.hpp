@@ -5,8 +5,10 @@
 #include "csv_reader.hpp"
 #include "data_frame.hpp"
 #include "data_type.hpp"
+#include "parser/row_counter.hpp"
 #include "string_view_stream.hpp"
 
+#include <fstream>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -34,28 +36,28 @@ namespace csv {
     /** Parse CSV from a string view, copying the input into an owned buffer.
      *
      *  Safe for any string_view regardless of the caller's ownership of the
-     *  underlying memory.
+     *  underlying memory. The input is copied once; rows then reference that
+     *  copy, which lives as long as the reader or any row from it.
      *
      *  @par Example
      *  @snippet tests/test_read_csv.cpp Parse Example
      */
     inline CSVReader parse(csv::string_view in, const CSVFormat& format = CSVFormat::guess_csv()) {
-        std::unique_ptr<std::istream> ss(new std::stringstream(std::string(in)));
-        return CSVReader(std::move(ss), format);
+        std::shared_ptr<std::string> buffer = std::make_shared<std::string>(in);
+        const csv::string_view data(*buffer);
+        return CSVReader(CSVMemorySource(data, std::move(buffer)), format);
     }
 
     /** Parse CSV from an in-memory view with zero copy.
      *
-     *  WARNING: Non-owning path. The caller must ensure `in`'s backing memory
-     *  remains valid and immutable while the reader may request additional rows
-     *  from the source stream.
+     *  WARNING: Non-owning path. Rows reference `in` directly, so the caller
+     *  must keep its backing memory valid and immutable while the reader or
+     *  any row obtained from it is in use.
      *
-     *  Rows already obtained from the reader remain valid, but unread rows
-     *  still depend on the source view staying alive.
+     *  Large inputs use speculative parallel parsing, as file sources do.
      */
     inline CSVReader parse_unsafe(csv::string_view in, CSVFormat format = CSVFormat::guess_csv()) {
-        std::unique_ptr<std::istream> stream(new internals::StringViewStream(in));
-        return CSVReader(std::move(stream), format);
+        return CSVReader(CSVMemorySource(in), format);
     }
 
     /** Parses a CSV string with no headers. */
@@ -170,37 +172,77 @@ namespace csv {
         chunk_parallel_apply(reader, executor, states, std::forward<Fn>(fn), chunk_size);
     }
 
+    /** Get the column names of a CSV file using just the first 500KB. */
+    inline std::vector<std::string> get_col_names(
+        csv::string_view filename,
+        const CSVFormat& format = CSVFormat::guess_csv()) {
+        auto head = internals::parser::get_csv_head(filename);
+        return parse_unsafe(head, format).get_col_names();
+    }
+
+    /** Count the rows of in-memory CSV without building CSVRow objects.
+     *
+     *  Returns the number of rows a CSVReader with `format` would return,
+     *  found with a quote-aware block scan that only visits quotes and line
+     *  endings. Large inputs are counted in parallel under the same
+     *  threading settings as speculative parsing. With `with_offsets`, also
+     *  returns the byte offset where each of those rows starts.
+     *
+     *  @note Like CSVReader, throws if a row has the wrong number of fields
+     *        under VariableColumnPolicy::THROW.
+     */
+    inline CSVRowCount count_rows(
+        CSVMemorySource source,
+        const CSVFormat& format = CSVFormat::guess_csv(),
+        bool with_offsets = false
+    ) {
+        return internals::parser::count_rows_in(source.data, format, with_offsets ? 1 : 0);
+    }
+
+    namespace internals {
+        /** Map `filename` whole and count its rows with count_rows_in(). */
+        inline CSVRowCount count_file_rows(
+            const std::string& filename,
+            const CSVFormat& format,
+            size_t offset_stride
+        ) {
+            const CSVMemorySource file = map_csv_file(filename);
+            return parser::count_rows_in(file.data, format, offset_stride);
+        }
+    }
+
+    /** Count the rows of a CSV file without building CSVRow objects.
+     *
+     *  The file is mapped whole and scanned in place.
+     *  @see count_rows(CSVMemorySource, const CSVFormat&, bool)
+     */
+    inline CSVRowCount count_rows(
+        const std::string& filename,
+        const CSVFormat& format = CSVFormat::guess_csv(),
+        bool with_offsets = false
+    ) {
+        return internals::count_file_rows(filename, format, with_offsets ? 1 : 0);
+    }
+
     /** Get basic information about a CSV file
      *  @include programs/csv_info.cpp
      */
     inline CSVFileInfo get_file_info(const std::string& filename) {
-        CSVFormat reader_format = CSVFormat::guess_csv();
-
-        CSVReader reader(filename, reader_format);
-        CSVFormat format = reader.get_format();
-
-        std::vector<CSVRow> rows;
-        while (reader.read_chunk(rows, 50000)) {}
+        CSVRowCount count = count_rows(filename);
+        std::vector<std::string> col_names = get_col_names(filename, count.format);
+        const size_t n_cols = col_names.size();
 
         return {
             filename,
-            reader.get_col_names(),
-            format.get_delim(),
-            reader.n_rows(),
-            reader.get_col_names().size(),
-            reader.parse_worker_count(),
-            reader.speculative_diagnostics()
+            std::move(col_names),
+            count.format.get_delim(),
+            count.n_rows,
+            n_cols,
+            count.parse_worker_count,
+            count.speculative_diagnostics
         };
     }
 
-    /** Get the column names of a CSV file using just the first 500KB. */
-    inline std::vector<std::string> get_col_names(
-        csv::string_view filename,
-        const CSVFormat& format = CSVFormat::guess_csv()) {
-        auto head = internals::parser::get_csv_head(filename);
-        return parse_unsafe(head, format).get_col_names();
-    }
-
     /** Find the position of a column in a CSV file or CSV_NOT_FOUND otherwise. */
     inline long long get_col_pos(csv::string_view filename, csv::string_view col_name,
         const CSVFormat& format = CSVFormat::guess_csv()) {
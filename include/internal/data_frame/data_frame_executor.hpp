@@ -4,7 +4,7 @@
 #include <utility>
 
 #include "../common.hpp"
-#include "../parallel/indexed_task_pool.hpp"
+#include "../parallel/work_stealing_pool.hpp"
 
 namespace csv {
     class DataFrameExecutor {
@@ -59,6 +59,6 @@ namespace csv {
 #endif
         }
 
-        internals::parallel::IndexedTaskPool task_pool_;
+        internals::parallel::WorkStealingPool task_pool_;
     };
 }
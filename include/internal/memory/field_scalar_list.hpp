@@ -29,10 +29,8 @@ namespace csv {
             public:
                 CSVFieldScalarList(size_t single_buffer_capacity = (size_t)(internals::PAGE_SIZE / sizeof(CSVFieldScalar))) :
                     block_capacity_(single_buffer_capacity == 0 ? 1 : single_buffer_capacity) {
-                    const size_t max_fields = internals::CSV_CHUNK_SIZE_DEFAULT + 1;
-                    const size_t block_count = (max_fields + this->block_capacity_ - 1) / this->block_capacity_;
-                    this->blocks_.reserve(block_count);
-                    this->blocks_.resize(block_count);
+                    // The block table is sized per chunk by reserve_for_source_size(),
+                    // so small chunks don't pay for a full-size table.
                 }
 
                 CSVFieldScalarList(const CSVFieldScalarList&) = delete;
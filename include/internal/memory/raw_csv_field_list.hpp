@@ -29,7 +29,7 @@ namespace csv {
              * 
              *  @par Thread Safety
              *  Cross-thread visibility for field contents is provided by the records
-             *  queue mutex in ThreadSafeDeque. The fixed arena publishes size/block
+             *  queue's release/acquire row publication (SPSCRowQueue). The fixed arena publishes size/block
              *  state with atomics so readers can safely resolve already-emitted rows
              *  while the parser appends later fields from the same RawCSVData.
              */
@@ -38,10 +38,8 @@ namespace csv {
                 /** Construct a RawCSVFieldList which allocates blocks of a certain size */
                 RawCSVFieldList(size_t single_buffer_capacity = (size_t)(internals::PAGE_SIZE / sizeof(RawCSVField))) :
                     block_capacity_(single_buffer_capacity == 0 ? 1 : single_buffer_capacity) {
-                    const size_t max_fields = internals::CSV_CHUNK_SIZE_DEFAULT + 1;
-                    const size_t block_count = (max_fields + this->block_capacity_ - 1) / this->block_capacity_;
-                    this->blocks_.reserve(block_count);
-                    this->blocks_.resize(block_count);
+                    // The block table is sized per chunk by reserve_for_source_size(),
+                    // so small chunks don't pay for a full-size table.
                 }
 
                 // No copy constructor
@@ -0,0 +1,124 @@
+/** @file
+ *  @brief Recycled byte buffers backing StreamParser chunks
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../common.hpp"
+
+namespace csv {
+    namespace internals {
+        namespace memory {
+            /** Fixed-capacity byte buffer that stream chunks are read into.
+             *
+             *  `alignment` (a power of two) aligns data(), as O_DIRECT reads need.
+             */
+            class StreamBuffer {
+            public:
+                explicit StreamBuffer(size_t capacity, size_t alignment = 1)
+                    : storage_(new char[capacity + alignment - 1]),
+                      capacity_(capacity),
+                      alignment_(alignment) {
+                    const uintptr_t address = reinterpret_cast<uintptr_t>(this->storage_.get());
+                    const uintptr_t aligned = (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+                    this->data_ = this->storage_.get() + (aligned - address);
+                }
+
+                StreamBuffer(const StreamBuffer&) = delete;
+                StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+                char* data() noexcept { return this->data_; }
+                const char* data() const noexcept { return this->data_; }
+                size_t capacity() const noexcept { return this->capacity_; }
+                size_t alignment() const noexcept { return this->alignment_; }
+
+            private:
+                std::unique_ptr<char[]> storage_;
+                char* data_ = nullptr;
+                size_t capacity_ = 0;
+                size_t alignment_ = 1;
+            };
+
+            /** Pool of StreamBuffers handed out as shared chunk owners.
+             *
+             *  CSVRow keeps its chunk alive through a std::shared_ptr<void>, so a
+             *  buffer can only be reused once every row parsed from it is gone. The
+             *  deleter of an acquired buffer returns it here instead of freeing it,
+             *  which avoids page-faulting a freshly allocated multi-megabyte buffer
+             *  for every chunk. Rows may be destroyed on the consumer thread while
+             *  the parser thread acquires, so the free list is locked.
+             *
+             *  Buffers outliving the pool are simply deleted.
+             */
+            class StreamBufferPool : public std::enable_shared_from_this<StreamBufferPool> {
+            public:
+                explicit StreamBufferPool(size_t max_free_buffers = 2)
+                    : max_free_buffers_(max_free_buffers) {}
+
+                StreamBufferPool(const StreamBufferPool&) = delete;
+                StreamBufferPool& operator=(const StreamBufferPool&) = delete;
+
+                /** Return a buffer of at least `min_capacity` bytes, reusing a free one if possible. */
+                std::shared_ptr<StreamBuffer> acquire(size_t min_capacity, size_t alignment = 1) {
+                    std::unique_ptr<StreamBuffer> buffer;
+                    {
+#if CSV_ENABLE_THREADS
+                        std::lock_guard<std::mutex> lock(this->lock_);
+#endif
+                        auto it = std::find_if(this->free_.begin(), this->free_.end(),
+                            [min_capacity, alignment](const std::unique_ptr<StreamBuffer>& candidate) {
+                                return candidate->capacity() >= min_capacity && candidate->alignment() >= alignment;
+                            });
+
+                        if (it != this->free_.end()) {
+                            buffer = std::move(*it);
+                            this->free_.erase(it);
+                        }
+                    }
+
+                    if (!buffer) {
+                        buffer.reset(new StreamBuffer(min_capacity, alignment));
+                    }
+
+                    std::weak_ptr<StreamBufferPool> pool = this->shared_from_this();
+                    return std::shared_ptr<StreamBuffer>(buffer.release(), [pool](StreamBuffer* released) {
+                        std::unique_ptr<StreamBuffer> owned(released);
+                        if (auto live_pool = pool.lock()) {
+                            live_pool->release(owned);
+                        }
+                    });
+                }
+
+                size_t free_buffer_count() const {
+#if CSV_ENABLE_THREADS
+                    std::lock_guard<std::mutex> lock(this->lock_);
+#endif
+                    return this->free_.size();
+                }
+
+            private:
+                /** Keep `buffer` for reuse if there is room; otherwise the caller frees it outside the lock. */
+                void release(std::unique_ptr<StreamBuffer>& buffer) {
+#if CSV_ENABLE_THREADS
+                    std::lock_guard<std::mutex> lock(this->lock_);
+#endif
+                    if (this->free_.size() < this->max_free_buffers_) {
+                        this->free_.push_back(std::move(buffer));
+                    }
+                }
+
+                size_t max_free_buffers_ = 2;
+                std::vector<std::unique_ptr<StreamBuffer>> free_;
+#if CSV_ENABLE_THREADS
+                mutable std::mutex lock_;
+#endif
+            };
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <string>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace csv {
+    namespace internals {
+        namespace parallel {
+        /** NUMA node of a pinned worker, page or CPU that could not be determined. */
+        constexpr int CSV_UNKNOWN_NUMA_NODE = -1;
+
+        /** Restrict the calling thread to `cpu`.
+         *
+         *  Returns false when the CPU does not exist or is outside the process's
+         *  allowed set, and on platforms without thread affinity; the thread
+         *  then keeps floating.
+         */
+        inline bool pin_current_thread(int cpu) noexcept {
+#if defined(__linux__)
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                return false;
+            }
+
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(cpu, &cpus);
+            return sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#else
+            (void)cpu;
+            return false;
+#endif
+        }
+
+        /** NUMA node that `cpu` belongs to, read from sysfs. */
+        inline int cpu_numa_node(int cpu) {
+#if defined(__linux__)
+            if (cpu < 0) {
+                return CSV_UNKNOWN_NUMA_NODE;
+            }
+
+            // Each CPU directory holds a "node<N>" link to its node.
+            const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+            DIR* dir = opendir(path.c_str());
+            if (dir == nullptr) {
+                return CSV_UNKNOWN_NUMA_NODE;
+            }
+
+            int node = CSV_UNKNOWN_NUMA_NODE;
+            while (dirent* entry = readdir(dir)) {
+                const char* name = entry->d_name;
+                if (std::strncmp(name, "node", 4) != 0 || name[4] < '0' || name[4] > '9') {
+                    continue;
+                }
+
+                char* end = nullptr;
+                const long value = std::strtol(name + 4, &end, 10);
+                if (*end == '\0') {
+                    node = static_cast<int>(value);
+                    break;
+                }
+            }
+
+            closedir(dir);
+            return node;
+#else
+            (void)cpu;
+            return CSV_UNKNOWN_NUMA_NODE;
+#endif
+        }
+
+        /** NUMA node holding the page at `address`.
+         *
+         *  Uses the raw get_mempolicy() system call, so no libnuma is needed.
+         *  A page that has not been touched yet is faulted in by the query,
+         *  which costs nothing extra for bytes that are about to be parsed.
+         */
+        inline int page_numa_node(const void* address) noexcept {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+            if (address == nullptr) {
+                return CSV_UNKNOWN_NUMA_NODE;
+            }
+
+            // MPOL_F_NODE | MPOL_F_ADDR from <linux/mempolicy.h>.
+            const unsigned long flags = 1 | 2;
+            int node = CSV_UNKNOWN_NUMA_NODE;
+            const int saved_errno = errno;
+            if (syscall(SYS_get_mempolicy, &node, nullptr, 0UL, address, flags) != 0) {
+                errno = saved_errno;
+                return CSV_UNKNOWN_NUMA_NODE;
+            }
+
+            return node;
+#else
+            (void)address;
+            return CSV_UNKNOWN_NUMA_NODE;
+#endif
+        }
+        }
+    }
+}
@@ -0,0 +1,512 @@
+#pragma once
+
+#include "../common.hpp"
+#include "placement.hpp"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#if CSV_ENABLE_THREADS
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace csv {
+    namespace internals {
+        namespace parallel {
+
+        class WorkStealingPool;
+
+        /** Completion counter for a set of tasks spawned on a WorkStealingPool.
+         *
+         *  Tasks may spawn more tasks into the same group (nested tasks) or into
+         *  another group (continuations); wait() returns once every task counted
+         *  against the group has finished. The first exception thrown by a task
+         *  cancels the group's tasks that have not started yet and is rethrown
+         *  by wait(), after which the group can be reused.
+         *
+         *  A group must outlive the tasks spawned into it.
+         */
+        class TaskGroup {
+        public:
+            TaskGroup() = default;
+            TaskGroup(const TaskGroup&) = delete;
+            TaskGroup& operator=(const TaskGroup&) = delete;
+
+            bool done() const noexcept {
+                return this->pending_.load(std::memory_order_acquire) == 0;
+            }
+
+        private:
+            friend class WorkStealingPool;
+
+            void capture(std::exception_ptr eptr) noexcept {
+#if CSV_ENABLE_THREADS
+                std::lock_guard<std::mutex> lock(this->exception_lock_);
+#endif
+                if (!this->exception_) {
+                    this->exception_ = std::move(eptr);
+                }
+                this->cancelled_.store(true, std::memory_order_relaxed);
+            }
+
+            std::exception_ptr take_exception() noexcept {
+#if CSV_ENABLE_THREADS
+                std::lock_guard<std::mutex> lock(this->exception_lock_);
+#endif
+                std::exception_ptr eptr = std::move(this->exception_);
+                this->exception_ = nullptr;
+                this->cancelled_.store(false, std::memory_order_relaxed);
+                return eptr;
+            }
+
+            std::atomic<size_t> pending_{ 0 };
+            std::atomic<bool> cancelled_{ false };
+            std::exception_ptr exception_ = nullptr;
+#if CSV_ENABLE_THREADS
+            std::mutex exception_lock_;
+#endif
+        };
+
+        /** Work-stealing task scheduler shared by speculative parsing and DataFrameExecutor.
+         *
+         *  Each worker owns a deque of tasks. A worker pops its own deque from the
+         *  back (most recently spawned first, which keeps split ranges cache-warm)
+         *  and, when it runs dry, steals from the front of another worker's deque.
+         *  Tasks spawned from inside a task go to the spawning worker's deque;
+         *  tasks spawned from other threads are dealt round-robin.
+         *
+         *  Unlike a generation barrier, any number of task groups may be in flight,
+         *  so a long task from one batch does not keep idle workers from starting
+         *  the next batch. A worker that waits on a group keeps running tasks
+         *  until the group finishes, so nested waits cannot deadlock the pool;
+         *  other threads block until the group finishes.
+         *
+         *  Worker indices passed to tasks are in [0, worker_count()), and no two
+         *  tasks run on the same index at once unless a task waits on a group,
+         *  in which case its worker runs other tasks under the same index before
+         *  resuming it. Tasks that keep per-worker state must not wait.
+         *  With fewer than two workers no threads are started and every task runs
+         *  inline on the spawning thread with worker index 0.
+         *
+         *  Workers can be pinned to a CPU set, worker `i` to `cpus[i % size]`.
+         *  Pinned workers know their NUMA node, and spawn_on() lets callers
+         *  queue a task with a worker on the node that holds its data.
+         */
+        class WorkStealingPool {
+        public:
+            using Task = std::function<void(size_t)>;
+
+            explicit WorkStealingPool(size_t worker_count, std::vector<int> cpus = std::vector<int>())
+#if CSV_ENABLE_THREADS
+                : worker_count_(worker_count),
+                  cpus_(std::move(cpus))
+#endif
+            {
+#if !CSV_ENABLE_THREADS
+                (void)cpus;
+#endif
+                this->start_workers(worker_count);
+            }
+
+            WorkStealingPool(const WorkStealingPool&) = delete;
+            WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+            ~WorkStealingPool() {
+                this->stop_workers();
+            }
+
+            size_t worker_count() const noexcept {
+#if CSV_ENABLE_THREADS
+                return this->worker_count_;
+#else
+                return 0;
+#endif
+            }
+
+            /** NUMA node of a pinned worker, or CSV_UNKNOWN_NUMA_NODE. */
+            int worker_node(size_t worker_index) const noexcept {
+#if CSV_ENABLE_THREADS
+                if (worker_index < this->worker_nodes_.size()) {
+                    return this->worker_nodes_[worker_index];
+                }
+#else
+                (void)worker_index;
+#endif
+                return CSV_UNKNOWN_NUMA_NODE;
+            }
+
+            /** Whether pinned workers sit on more than one known NUMA node. */
+            bool spans_numa_nodes() const noexcept {
+#if CSV_ENABLE_THREADS
+                return this->spans_numa_nodes_;
+#else
+                return false;
+#endif
+            }
+
+            /** Pick a worker on `node`, rotating among them; returns worker_count() if none is. */
+            size_t next_worker_on_node(int node) noexcept {
+#if CSV_ENABLE_THREADS
+                const size_t worker_count = this->worker_nodes_.size();
+                if (node != CSV_UNKNOWN_NUMA_NODE && worker_count > 0) {
+                    const size_t start = this->next_node_worker_.fetch_add(1, std::memory_order_relaxed);
+                    for (size_t i = 0; i < worker_count; ++i) {
+                        const size_t worker_index = (start + i) % worker_count;
+                        if (this->worker_nodes_[worker_index] == node) {
+                            return worker_index;
+                        }
+                    }
+                }
+#else
+                (void)node;
+#endif
+                return this->worker_count();
+            }
+
+            /** Run `task(worker_index)` on the pool, counted against `group`. */
+            void spawn(TaskGroup& group, Task task) {
+#if CSV_ENABLE_THREADS
+                if (!this->workers_.empty()) {
+                    group.pending_.fetch_add(1, std::memory_order_relaxed);
+                    this->push(QueuedTask(std::move(task), &group));
+                    return;
+                }
+#endif
+                this->run_inline(group, task);
+            }
+
+            /** Like spawn(), but queue the task with `worker_index`.
+             *
+             *  The task still runs elsewhere if another worker goes idle and
+             *  steals it first. Out-of-range indices fall back to spawn().
+             */
+            void spawn_on(TaskGroup& group, size_t worker_index, Task task) {
+#if CSV_ENABLE_THREADS
+                if (!this->workers_.empty() && worker_index < this->queues_.size()) {
+                    group.pending_.fetch_add(1, std::memory_order_relaxed);
+                    this->push_to(worker_index, QueuedTask(std::move(task), &group));
+                    return;
+                }
+#else
+                (void)worker_index;
+#endif
+                this->spawn(group, std::move(task));
+            }
+
+            /** Spawn `fn(worker_index, task_index)` for every index in [0, task_count).
+             *
+             *  The index range is split in halves lazily, so idle workers steal
+             *  large ranges first and a single slow index only delays itself.
+             *  Returns without waiting; `fn` is copied and kept alive by the tasks.
+             */
+            template<typename Fn>
+            void spawn_for(TaskGroup& group, size_t task_count, Fn fn) {
+                if (task_count == 0) {
+                    return;
+                }
+
+#if CSV_ENABLE_THREADS
+                if (this->workers_.empty())
+#endif
+                {
+                    // Inline fallback: visit indices in order like a plain loop.
+                    for (size_t task_index = 0; task_index < task_count; ++task_index) {
+                        this->run_inline(group, [&fn, task_index](size_t worker_index) {
+                            fn(worker_index, task_index);
+                        });
+                    }
+                    return;
+                }
+
+#if CSV_ENABLE_THREADS
+                std::shared_ptr<Fn> shared_fn = std::make_shared<Fn>(std::move(fn));
+                this->spawn_range(group, 0, task_count, shared_fn);
+#endif
+            }
+
+            /** Block until every task of `group` has finished, rethrowing the first task exception. */
+            void wait(TaskGroup& group) {
+#if CSV_ENABLE_THREADS
+                if (!group.done()) {
+                    if (current_worker().pool == this) {
+                        this->help_until_done(group, current_worker().index);
+                    }
+                    else {
+                        std::unique_lock<std::mutex> lock(this->done_lock_);
+                        this->group_done_.wait(lock, [&group]() {
+                            return group.done();
+                        });
+                    }
+                }
+#endif
+
+                if (std::exception_ptr eptr = group.take_exception()) {
+                    std::rethrow_exception(eptr);
+                }
+            }
+
+            /** Run `fn(worker_index, task_index)` for every index and wait for all of them. */
+            template<typename Fn>
+            void parallel_for(size_t task_count, Fn&& fn) {
+                TaskGroup group;
+                this->spawn_for(group, task_count, std::forward<Fn>(fn));
+                this->wait(group);
+            }
+
+        private:
+            template<typename Fn>
+            void spawn_range(TaskGroup& group, size_t begin, size_t end, const std::shared_ptr<Fn>& fn) {
+                WorkStealingPool* pool = this;
+                TaskGroup* target = &group;
+                this->spawn(group, [pool, target, begin, end, fn](size_t worker_index) {
+                    size_t range_end = end;
+                    while (range_end - begin > 1) {
+                        const size_t mid = begin + (range_end - begin) / 2;
+                        pool->spawn_range(*target, mid, range_end, fn);
+                        range_end = mid;
+                    }
+
+                    (*fn)(worker_index, begin);
+                });
+            }
+
+            void run_inline(TaskGroup& group, const Task& task) {
+                if (group.cancelled_.load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                try {
+                    task(0);
+                }
+                catch (...) {
+                    group.capture(std::current_exception());
+                }
+            }
+
+#if CSV_ENABLE_THREADS
+            struct QueuedTask {
+                QueuedTask() = default;
+                QueuedTask(Task fn_, TaskGroup* group_) : fn(std::move(fn_)), group(group_) {}
+
+                Task fn;
+                TaskGroup* group = nullptr;
+            };
+
+            struct WorkerQueue {
+                std::mutex lock;
+                std::deque<QueuedTask> tasks;
+            };
+
+            struct WorkerContext {
+                const WorkStealingPool* pool = nullptr;
+                size_t index = 0;
+            };
+
+            static WorkerContext& current_worker() noexcept {
+                static thread_local WorkerContext context;
+                return context;
+            }
+
+            void start_workers(size_t worker_count) {
+                if (worker_count <= 1) {
+                    return;
+                }
+
+                this->queues_.reserve(worker_count);
+                for (size_t i = 0; i < worker_count; ++i) {
+                    this->queues_.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+                }
+
+                if (!this->cpus_.empty()) {
+                    this->worker_nodes_.reserve(worker_count);
+                    int first_node = CSV_UNKNOWN_NUMA_NODE;
+                    for (size_t i = 0; i < worker_count; ++i) {
+                        const int node = cpu_numa_node(this->cpus_[i % this->cpus_.size()]);
+                        this->worker_nodes_.push_back(node);
+                        if (node == CSV_UNKNOWN_NUMA_NODE) {
+                            continue;
+                        }
+
+                        if (first_node == CSV_UNKNOWN_NUMA_NODE) {
+                            first_node = node;
+                        }
+                        else if (node != first_node) {
+                            this->spans_numa_nodes_ = true;
+                        }
+                    }
+                }
+
+                this->workers_.reserve(worker_count);
+                for (size_t worker_index = 0; worker_index < worker_count; ++worker_index) {
+                    this->workers_.push_back(std::thread(&WorkStealingPool::worker_loop, this, worker_index));
+                }
+            }
+
+            void stop_workers() {
+                if (this->workers_.empty()) {
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(this->sleep_lock_);
+                    this->stop_ = true;
+                }
+
+                this->work_available_.notify_all();
+                for (size_t i = 0; i < this->workers_.size(); ++i) {
+                    if (this->workers_[i].joinable()) {
+                        this->workers_[i].join();
+                    }
+                }
+            }
+
+            void push(QueuedTask task) {
+                const WorkerContext& context = current_worker();
+                const size_t queue_index = context.pool == this
+                    ? context.index
+                    : this->next_queue_.fetch_add(1, std::memory_order_relaxed) % this->queues_.size();
+                this->push_to(queue_index, std::move(task));
+            }
+
+            void push_to(size_t queue_index, QueuedTask task) {
+                {
+                    WorkerQueue& queue = *this->queues_[queue_index];
+                    std::lock_guard<std::mutex> lock(queue.lock);
+                    queue.tasks.push_back(std::move(task));
+                }
+
+                // Pairs with the sleeper count in worker_loop(): either the
+                // worker sees this task before sleeping, or we see it asleep.
+                this->queued_.fetch_add(1, std::memory_order_seq_cst);
+                if (this->sleepers_.load(std::memory_order_seq_cst) > 0) {
+                    std::lock_guard<std::mutex> lock(this->sleep_lock_);
+                    this->work_available_.notify_one();
+                }
+            }
+
+            bool pop_local(size_t worker_index, QueuedTask& out) {
+                WorkerQueue& queue = *this->queues_[worker_index];
+                std::lock_guard<std::mutex> lock(queue.lock);
+                if (queue.tasks.empty()) {
+                    return false;
+                }
+
+                out = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                this->queued_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            bool steal(size_t worker_index, QueuedTask& out) {
+                const size_t queue_count = this->queues_.size();
+                for (size_t offset = 1; offset < queue_count; ++offset) {
+                    WorkerQueue& victim = *this->queues_[(worker_index + offset) % queue_count];
+                    std::lock_guard<std::mutex> lock(victim.lock);
+                    if (victim.tasks.empty()) {
+                        continue;
+                    }
+
+                    out = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    this->queued_.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+
+                return false;
+            }
+
+            bool try_run_one(size_t worker_index) {
+                QueuedTask task;
+                if (!this->pop_local(worker_index, task) && !this->steal(worker_index, task)) {
+                    return false;
+                }
+
+                this->run(task, worker_index);
+                return true;
+            }
+
+            void run(QueuedTask& task, size_t worker_index) {
+                TaskGroup& group = *task.group;
+                if (!group.cancelled_.load(std::memory_order_relaxed)) {
+                    try {
+                        task.fn(worker_index);
+                    }
+                    catch (...) {
+                        group.capture(std::current_exception());
+                    }
+                }
+
+                // Release the callable before the group can be observed done.
+                task.fn = Task();
+                if (group.pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(this->done_lock_);
+                    this->group_done_.notify_all();
+                }
+            }
+
+            void help_until_done(TaskGroup& group, size_t worker_index) {
+                while (!group.done()) {
+                    if (!this->try_run_one(worker_index)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            void worker_loop(size_t worker_index) {
+                current_worker().pool = this;
+                current_worker().index = worker_index;
+
+                // Buffers this worker allocates are then first touched on its node.
+                if (!this->cpus_.empty()) {
+                    pin_current_thread(this->cpus_[worker_index % this->cpus_.size()]);
+                }
+
+                for (;;) {
+                    if (this->try_run_one(worker_index)) {
+                        continue;
+                    }
+
+                    std::unique_lock<std::mutex> lock(this->sleep_lock_);
+                    this->sleepers_.fetch_add(1, std::memory_order_seq_cst);
+                    this->work_available_.wait(lock, [this]() {
+                        return this->stop_ || this->queued_.load(std::memory_order_seq_cst) > 0;
+                    });
+                    this->sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+
+                    if (this->stop_ && this->queued_.load(std::memory_order_seq_cst) == 0) {
+                        return;
+                    }
+                }
+            }
+
+            size_t worker_count_ = 0;
+            std::vector<int> cpus_;
+            std::vector<int> worker_nodes_;
+            bool spans_numa_nodes_ = false;
+            std::atomic<size_t> next_node_worker_{ 0 };
+            std::vector<std::unique_ptr<WorkerQueue>> queues_;
+            std::vector<std::thread> workers_;
+            std::atomic<size_t> next_queue_{ 0 };
+            std::atomic<size_t> queued_{ 0 };
+            std::atomic<size_t> sleepers_{ 0 };
+            std::mutex sleep_lock_;
+            std::condition_variable work_available_;
+            std::mutex done_lock_;
+            std::condition_variable group_done_;
+            bool stop_ = false;
+#else
+            void start_workers(size_t) {}
+            void stop_workers() {}
+#endif
+        };
+
+        }
+    }
+}
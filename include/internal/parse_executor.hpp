@@ -0,0 +1,118 @@
+/** @file
+ *  @brief Worker pool shared by the speculative parsers of many readers
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#if CSV_ENABLE_THREADS
+#include <mutex>
+#include <thread>
+#endif
+
+#include "common.hpp"
+#include "parallel/work_stealing_pool.hpp"
+
+namespace csv {
+    /** Worker threads that speculative parsing can share across readers.
+     *
+     *  By default every reader using speculative parallel parsing starts its
+     *  own workers, so opening many large files at once runs many times more
+     *  threads than there are cores. Readers given the same executor, through
+     *  CSVFormat::parse_executor() or ParseExecutor::set_global(), submit their
+     *  chunk-parse tasks to one pool instead.
+     *
+     *  Scheduling is fair at window granularity: a reader submits one task per
+     *  chunk of its current window, tasks from different readers are dealt
+     *  across the workers' queues, and idle workers steal the oldest task
+     *  first, so no reader waits behind more than one window of another.
+     *  A reader never has more chunks in flight than its configured
+     *  speculative_parallel_threads(), which caps its share of the pool.
+     *
+     *  The executor is kept alive by every reader using it.
+     *
+     *  @par Example
+     *  @code
+     *  auto executor = std::make_shared<csv::ParseExecutor>(8);
+     *  csv::CSVFormat format;
+     *  format.parse_executor(executor).speculative_parallel_threads(4);
+     *
+     *  // Both readers parse on the same eight threads, up to four chunks each.
+     *  csv::CSVReader a("a.csv", format), b("b.csv", format);
+     *  @endcode
+     */
+    class ParseExecutor {
+    public:
+        /** Start `worker_count` workers; 0 uses std::thread::hardware_concurrency(). */
+        explicit ParseExecutor(size_t worker_count = 0)
+            : pool_(new internals::parallel::WorkStealingPool(resolve_worker_count(worker_count))) {}
+
+        /** Start `worker_count` workers pinned to `cpus`, worker `i` to `cpus[i % cpus.size()]`.
+         *
+         *  @see CSVFormat::parse_worker_cpus()
+         */
+        ParseExecutor(size_t worker_count, std::vector<int> cpus)
+            : pool_(new internals::parallel::WorkStealingPool(resolve_worker_count(worker_count), std::move(cpus))) {}
+
+        ParseExecutor(const ParseExecutor&) = delete;
+        ParseExecutor& operator=(const ParseExecutor&) = delete;
+
+        /** Number of worker threads (0 when built without threads). */
+        size_t worker_count() const noexcept {
+            return this->pool_->worker_count();
+        }
+
+        /** Set the executor used by readers whose CSVFormat does not name one.
+         *
+         *  Pass nullptr to go back to per-reader workers. Readers that are
+         *  already open keep the executor they started with.
+         */
+        static void set_global(std::shared_ptr<ParseExecutor> executor) {
+#if CSV_ENABLE_THREADS
+            std::lock_guard<std::mutex> lock(global_lock());
+#endif
+            global_slot() = std::move(executor);
+        }
+
+        /** Return the executor set by set_global(), or nullptr. */
+        static std::shared_ptr<ParseExecutor> global() {
+#if CSV_ENABLE_THREADS
+            std::lock_guard<std::mutex> lock(global_lock());
+#endif
+            return global_slot();
+        }
+
+        /** The pool that chunk-parse tasks are spawned on. */
+        const std::shared_ptr<internals::parallel::WorkStealingPool>& pool() const noexcept {
+            return this->pool_;
+        }
+
+    private:
+        static size_t resolve_worker_count(size_t worker_count) {
+#if CSV_ENABLE_THREADS
+            if (worker_count == 0) {
+                const unsigned int hardware_threads = std::thread::hardware_concurrency();
+                worker_count = hardware_threads == 0 ? 2 : static_cast<size_t>(hardware_threads);
+            }
+#endif
+            return worker_count;
+        }
+
+        static std::shared_ptr<ParseExecutor>& global_slot() {
+            static std::shared_ptr<ParseExecutor> executor;
+            return executor;
+        }
+
+#if CSV_ENABLE_THREADS
+        static std::mutex& global_lock() {
+            static std::mutex lock;
+            return lock;
+        }
+#endif
+
+        std::shared_ptr<internals::parallel::WorkStealingPool> pool_;
+    };
+}
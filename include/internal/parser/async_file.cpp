@@ -0,0 +1,545 @@
+#include "async_file.hpp"
+#include "orchestrator.hpp"
+#include "stream.hpp"
+
+#if CSV_ASYNC_FILE_READS
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+// IORING_FEAT_RW_CUR_POS arrived with IORING_OP_READ in Linux 5.6.
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(IORING_FEAT_RW_CUR_POS)
+#define CSV_IO_URING 1
+#endif
+#endif
+#endif
+
+#if !defined(CSV_IO_URING)
+#define CSV_IO_URING 0
+#endif
+
+namespace csv {
+    namespace internals {
+        namespace parser {
+        /** Submission and completion rings of one io_uring instance.
+         *
+         *  Only used by the thread that owns the AsyncFileReader, so the ring
+         *  indices need no lock; the acquire/release accesses order them with
+         *  the kernel.
+         */
+        struct AsyncFileReader::IoUringRing {
+#if CSV_IO_URING
+            int fd = -1;
+            void* sq_map = nullptr;
+            size_t sq_map_size = 0;
+            void* cq_map = nullptr;
+            size_t cq_map_size = 0;
+            io_uring_sqe* sqes = nullptr;
+            size_t sqes_size = 0;
+
+            unsigned* sq_tail = nullptr;
+            unsigned* sq_mask = nullptr;
+            unsigned* sq_array = nullptr;
+            unsigned* cq_head = nullptr;
+            unsigned* cq_tail = nullptr;
+            unsigned* cq_mask = nullptr;
+            io_uring_cqe* cqes = nullptr;
+
+            /** Set up a ring with room for `entries` reads; false if refused. */
+            bool open(unsigned entries) {
+                io_uring_params params;
+                std::memset(&params, 0, sizeof(params));
+                const long ring_fd = ::syscall(__NR_io_uring_setup, entries, &params);
+                if (ring_fd < 0) {
+                    return false;
+                }
+                this->fd = static_cast<int>(ring_fd);
+
+                this->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                this->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                const bool single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (single_map) {
+                    this->sq_map_size = (std::max)(this->sq_map_size, this->cq_map_size);
+                }
+
+                this->sq_map = ::mmap(nullptr, this->sq_map_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_SQ_RING);
+                if (this->sq_map == MAP_FAILED) {
+                    this->sq_map = nullptr;
+                    return false;
+                }
+
+                if (single_map) {
+                    this->cq_map = this->sq_map;
+                }
+                else {
+                    this->cq_map = ::mmap(nullptr, this->cq_map_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_CQ_RING);
+                    if (this->cq_map == MAP_FAILED) {
+                        this->cq_map = nullptr;
+                        return false;
+                    }
+                }
+
+                this->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+                void* sqes_map = ::mmap(nullptr, this->sqes_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_SQES);
+                if (sqes_map == MAP_FAILED) {
+                    return false;
+                }
+                this->sqes = static_cast<io_uring_sqe*>(sqes_map);
+
+                char* sq = static_cast<char*>(this->sq_map);
+                char* cq = static_cast<char*>(this->cq_map);
+                this->sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+                this->sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+                this->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+                this->cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+                this->cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+                this->cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+                this->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+                return true;
+            }
+
+            /** Queue and submit one read; false if the kernel rejected it. */
+            bool submit_read(int file_fd, char* dst, size_t offset, size_t length, void* tag) {
+                const unsigned tail = *this->sq_tail;
+                const unsigned index = tail & *this->sq_mask;
+                io_uring_sqe* sqe = this->sqes + index;
+                std::memset(sqe, 0, sizeof(*sqe));
+                sqe->opcode = IORING_OP_READ;
+                sqe->fd = file_fd;
+                sqe->addr = reinterpret_cast<uint64_t>(dst);
+                sqe->len = static_cast<uint32_t>(length);
+                sqe->off = offset;
+                sqe->user_data = reinterpret_cast<uint64_t>(tag);
+                this->sq_array[index] = index;
+                __atomic_store_n(this->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+                for (;;) {
+                    const long submitted = ::syscall(__NR_io_uring_enter, this->fd, 1, 0, 0, nullptr, 0);
+                    if (submitted == 1) {
+                        return true;
+                    }
+                    if (submitted == 0 || (errno != EINTR && errno != EAGAIN)) {
+                        // Take the entry back so the ring stays consistent.
+                        __atomic_store_n(this->sq_tail, tail, __ATOMIC_RELEASE);
+                        return false;
+                    }
+                }
+            }
+
+            /** Block for the next completion and return its tag and result. */
+            void* wait_completion(int& result) {
+                for (;;) {
+                    const unsigned head = *this->cq_head;
+                    if (head != __atomic_load_n(this->cq_tail, __ATOMIC_ACQUIRE)) {
+                        const io_uring_cqe& cqe = this->cqes[head & *this->cq_mask];
+                        void* tag = reinterpret_cast<void*>(static_cast<uintptr_t>(cqe.user_data));
+                        result = cqe.res;
+                        __atomic_store_n(this->cq_head, head + 1, __ATOMIC_RELEASE);
+                        return tag;
+                    }
+
+                    const long waited = ::syscall(__NR_io_uring_enter, this->fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                    if (waited < 0 && errno != EINTR) {
+                        throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+                    }
+                }
+            }
+
+            ~IoUringRing() {
+                if (this->sqes) ::munmap(this->sqes, this->sqes_size);
+                if (this->cq_map && this->cq_map != this->sq_map) ::munmap(this->cq_map, this->cq_map_size);
+                if (this->sq_map) ::munmap(this->sq_map, this->sq_map_size);
+                if (this->fd >= 0) ::close(this->fd);
+            }
+#endif
+        };
+
+        CSV_INLINE AsyncFileReader::AsyncFileReader(
+            const std::string& filename,
+            size_t queue_depth,
+            bool direct_io,
+            bool allow_io_uring
+        ) : filename_(filename) {
+            queue_depth = (std::max)(queue_depth, size_t(1));
+            this->fd_ = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+            if (this->fd_ < 0) {
+                throw_cannot_open_file(filename);
+            }
+
+            struct stat info;
+            if (::fstat(this->fd_, &info) != 0) {
+                const int error = errno;
+                ::close(this->fd_);
+                throw_file_read_failure(error, filename, 0, 0);
+            }
+            this->size_ = static_cast<size_t>(info.st_size);
+
+#if defined(O_DIRECT)
+            if (direct_io) {
+                // Refused by tmpfs and some network file systems; reads then
+                // simply stay on fd_.
+                this->direct_fd_ = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+                this->direct_usable_ = this->direct_fd_ >= 0;
+            }
+#else
+            (void)direct_io;
+#endif
+
+#if CSV_IO_URING
+            if (allow_io_uring) {
+                this->ring_.reset(new IoUringRing());
+                this->ring_usable_ = this->ring_->open(static_cast<unsigned>(queue_depth + 1));
+                if (!this->ring_usable_) {
+                    this->ring_.reset();
+                }
+            }
+#else
+            (void)allow_io_uring;
+#endif
+
+#if CSV_ENABLE_THREADS
+            this->queue_depth_ = queue_depth;
+#endif
+        }
+
+        CSV_INLINE AsyncFileReader::~AsyncFileReader() {
+            // Reads still in flight write into buffers their caller is about
+            // to free, so finish them first.
+#if CSV_IO_URING
+            while (this->ring_in_flight_ > 0) {
+                int result = 0;
+                try {
+                    this->ring_->wait_completion(result);
+                }
+                catch (...) {
+                    break;
+                }
+                this->ring_in_flight_--;
+            }
+#endif
+
+#if CSV_ENABLE_THREADS
+            {
+                std::lock_guard<std::mutex> lock(this->lock_);
+                this->stopping_ = true;
+                this->thread_queue_.clear();
+            }
+            this->work_ready_.notify_all();
+            for (auto& worker : this->workers_) {
+                worker.join();
+            }
+#endif
+
+            this->ring_.reset();
+            if (this->direct_fd_ >= 0) ::close(this->direct_fd_);
+            if (this->fd_ >= 0) ::close(this->fd_);
+        }
+
+        CSV_INLINE bool AsyncFileReader::uses_io_uring() const noexcept {
+            return this->ring_usable_;
+        }
+
+        CSV_INLINE bool AsyncFileReader::uses_direct_io() const noexcept {
+            return this->direct_usable_;
+        }
+
+        CSV_INLINE int AsyncFileReader::read_fd() const noexcept {
+            return this->direct_usable_ ? this->direct_fd_ : this->fd_;
+        }
+
+        /** Read whatever is left of `request` with pread(). */
+        CSV_INLINE void AsyncFileReader::read_now(Request& request) {
+            while (request.done < request.length) {
+                const int fd = this->read_fd();
+                const ssize_t n = ::pread(
+                    fd,
+                    request.dst + request.done,
+                    request.length - request.done,
+                    static_cast<off_t>(request.offset + request.done)
+                );
+
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+
+                    if (errno == EINVAL && fd == this->direct_fd_) {
+                        this->direct_usable_ = false;
+                        continue;
+                    }
+
+                    request.error = errno;
+                    return;
+                }
+
+                if (n == 0) {
+                    return;
+                }
+
+                request.done += static_cast<size_t>(n);
+            }
+        }
+
+        CSV_INLINE void AsyncFileReader::finish_ring_read(Request& request, int result) {
+            request.on_ring = false;
+            if (result < 0) {
+                if (result == -EINVAL || result == -EOPNOTSUPP) {
+                    if (this->direct_usable_) {
+                        this->direct_usable_ = false;
+                    }
+                    else {
+                        this->ring_usable_ = false;
+                    }
+                }
+                else if (result != -EINTR && result != -EAGAIN) {
+                    request.error = -result;
+                    request.complete = true;
+                    return;
+                }
+            }
+            else {
+                request.done = static_cast<size_t>(result);
+            }
+
+            // Short of the end of the file, or retrying on the fallback path.
+            if (request.done < request.length && request.offset + request.done < this->size_) {
+                this->read_now(request);
+            }
+            request.complete = true;
+        }
+
+        CSV_INLINE void AsyncFileReader::reap_ring() {
+#if CSV_IO_URING
+            int result = 0;
+            Request* request = static_cast<Request*>(this->ring_->wait_completion(result));
+            this->ring_in_flight_--;
+            this->finish_ring_read(*request, result);
+#endif
+        }
+
+        CSV_INLINE void AsyncFileReader::submit(char* dst, size_t offset, size_t length) {
+            this->requests_.emplace_back();
+            Request& request = this->requests_.back();
+            request.dst = dst;
+            request.offset = offset;
+            request.length = length;
+
+#if CSV_IO_URING
+            if (this->ring_usable_ && length <= (std::numeric_limits<uint32_t>::max)()) {
+                if (this->ring_->submit_read(this->read_fd(), dst, offset, length, &request)) {
+                    request.on_ring = true;
+                    this->ring_in_flight_++;
+                    return;
+                }
+                this->ring_usable_ = false;
+            }
+#endif
+
+            this->submit_to_threads(request);
+        }
+
+        CSV_INLINE size_t AsyncFileReader::wait() {
+            Request& request = this->requests_.front();
+            while (request.on_ring) {
+                this->reap_ring();
+            }
+
+#if CSV_ENABLE_THREADS
+            {
+                std::unique_lock<std::mutex> lock(this->lock_);
+                this->read_done_.wait(lock, [&request]() { return request.complete; });
+            }
+#else
+            if (!request.complete) {
+                this->read_now(request);
+                request.complete = true;
+            }
+#endif
+
+            const Request finished = request;
+            this->requests_.pop_front();
+            if (finished.error != 0) {
+                throw_file_read_failure(finished.error, this->filename_, finished.offset, finished.length);
+            }
+            return finished.done;
+        }
+
+#if CSV_ENABLE_THREADS
+        CSV_INLINE void AsyncFileReader::submit_to_threads(Request& request) {
+            {
+                std::lock_guard<std::mutex> lock(this->lock_);
+                this->thread_queue_.push_back(&request);
+                if (this->workers_.size() < this->queue_depth_) {
+                    this->workers_.emplace_back(&AsyncFileReader::worker_loop, this);
+                }
+            }
+            this->work_ready_.notify_one();
+        }
+
+        CSV_INLINE void AsyncFileReader::worker_loop() {
+            std::unique_lock<std::mutex> lock(this->lock_);
+            for (;;) {
+                this->work_ready_.wait(lock, [this]() {
+                    return this->stopping_ || !this->thread_queue_.empty();
+                });
+                if (this->stopping_) {
+                    return;
+                }
+
+                Request* request = this->thread_queue_.front();
+                this->thread_queue_.pop_front();
+
+                lock.unlock();
+                this->read_now(*request);
+                lock.lock();
+
+                request->complete = true;
+                this->read_done_.notify_all();
+            }
+        }
+#else
+        CSV_INLINE void AsyncFileReader::submit_to_threads(Request&) {
+            // Read synchronously in wait().
+        }
+#endif
+
+        CSV_INLINE AsyncFileParser::AsyncFileParser(
+            csv::string_view filename,
+            const CSVFormat& format,
+            const ColNamesPtr& col_names,
+            bool allow_io_uring
+        ) : CSVParserDriverBase(format, col_names),
+            read_depth_((std::max)(format.get_async_read_depth(), size_t(1))),
+            buffer_pool_(std::make_shared<memory::StreamBufferPool>(read_depth_ + 1)),
+            reader_(new AsyncFileReader(
+                std::string(filename),
+                read_depth_,
+                format.is_direct_io_enabled(),
+                allow_io_uring
+            )) {
+            this->source_size_ = this->reader_->size();
+
+            // Same head size as the other drivers; O_DIRECT needs a whole
+            // number of blocks.
+            const size_t head_size = (std::min)(this->source_size_, size_t(500000));
+            if (head_size > 0) {
+                const size_t head_read = (head_size + CSV_ASYNC_READ_ALIGNMENT - 1)
+                    / CSV_ASYNC_READ_ALIGNMENT * CSV_ASYNC_READ_ALIGNMENT;
+                auto head_buffer = this->buffer_pool_->acquire(head_read, CSV_ASYNC_READ_ALIGNMENT);
+                this->reader_->submit(head_buffer->data(), 0, head_read);
+                const size_t n = this->reader_->wait();
+                this->head_.assign(head_buffer->data(), (std::min)(n, head_size));
+            }
+
+            this->resolve_format_from_head(format);
+            std::string().swap(this->head_);
+
+            this->parse_orchestrator_ = make_csv_parse_orchestrator(
+                this->parse_flags_,
+                this->whitespace_flags(),
+                format,
+                this->source_size_,
+                col_names,
+                true
+            );
+        }
+
+        CSV_INLINE AsyncFileParser::~AsyncFileParser() = default;
+
+        /** Keep read_depth_ reads of `read_size` bytes in flight. */
+        CSV_INLINE void AsyncFileParser::issue_reads(size_t read_size) {
+            // Room for a typical incomplete row in front of each read.
+            const size_t headroom = (std::max)(read_size / 8, size_t(64 * 1024))
+                / CSV_ASYNC_READ_ALIGNMENT * CSV_ASYNC_READ_ALIGNMENT;
+
+            while (this->pending_.size() < this->read_depth_ && this->next_read_offset_ < this->source_size_) {
+                PendingRead read;
+                read.headroom = headroom;
+                read.offset = this->next_read_offset_;
+                read.length = read_size;
+                read.buffer = this->buffer_pool_->acquire(headroom + read_size, CSV_ASYNC_READ_ALIGNMENT);
+
+                this->reader_->submit(read.buffer->data() + headroom, read.offset, read.length);
+                this->next_read_offset_ += read_size;
+                this->pending_.push_back(std::move(read));
+            }
+        }
+
+        CSV_INLINE void AsyncFileParser::next(size_t bytes = CSV_CHUNK_SIZE_DEFAULT) {
+            if (this->eof()) return;
+
+            const size_t window_size = (std::min)(
+                this->parse_orchestrator_->read_window_size(bytes),
+                (std::max)(bytes, CSV_STREAM_WINDOW_SIZE_MAX)
+            );
+            const size_t read_size = (window_size + CSV_ASYNC_READ_ALIGNMENT - 1)
+                / CSV_ASYNC_READ_ALIGNMENT * CSV_ASYNC_READ_ALIGNMENT;
+
+            this->issue_reads(read_size);
+            if (this->pending_.empty()) {
+                // Empty file
+                this->eof_ = true;
+                this->end_feed();
+                return;
+            }
+
+            PendingRead read = std::move(this->pending_.front());
+            this->pending_.pop_front();
+            const size_t n = this->reader_->wait();
+            const bool source_exhausted = n < read.length || read.offset + n >= this->source_size_;
+
+            // Put the previous window's incomplete row in front of this read.
+            char* data = read.buffer->data() + read.headroom;
+            std::shared_ptr<memory::StreamBuffer> owner = read.buffer;
+            char* window = data - this->tail_size_;
+            if (this->tail_size_ > read.headroom) {
+                owner = this->buffer_pool_->acquire(this->tail_size_ + n);
+                window = owner->data();
+                std::memcpy(window + this->tail_size_, data, n);
+            }
+            if (this->tail_size_ > 0) {
+                std::memcpy(window, this->tail_, this->tail_size_);
+            }
+            this->tail_owner_.reset();
+            read.buffer.reset();
+
+            // Keep the device busy while this window is parsed.
+            if (!source_exhausted) {
+                this->issue_reads(read_size);
+            }
+
+            const csv::string_view chunk(window, this->tail_size_ + n);
+            const CSVParseWindowResult result = this->parse_orchestrator_->parse_window(
+                chunk,
+                owner,
+                this->stream_pos_,
+                bytes,
+                source_exhausted,
+                this->output()
+            );
+
+            if (source_exhausted) {
+                this->eof_ = true;
+                this->tail_size_ = 0;
+            }
+            else {
+                this->tail_ = chunk.data() + result.complete_prefix_length;
+                this->tail_size_ = chunk.size() - result.complete_prefix_length;
+                this->stream_pos_ += result.complete_prefix_length;
+                this->tail_owner_ = std::move(owner);
+            }
+        }
+        }
+    }
+}
+#endif
@@ -0,0 +1,199 @@
+/** @file
+ *  @brief Read-ahead file source for CSVReader using io_uring or pread()
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "../memory/stream_buffer_pool.hpp"
+#include "driver.hpp"
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#define CSV_ASYNC_FILE_READS 1
+#else
+#define CSV_ASYNC_FILE_READS 0
+#endif
+
+#if CSV_ASYNC_FILE_READS
+#if CSV_ENABLE_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#endif
+
+namespace csv {
+    namespace internals {
+        namespace parser {
+        /** Offset, length and address alignment of every async read, which
+         *  covers the logical block size O_DIRECT needs on common devices.
+         */
+        constexpr size_t CSV_ASYNC_READ_ALIGNMENT = 4096;
+
+        /** Runs reads of one file in the background and hands them back in
+         *  submission order.
+         *
+         *  @par Backends
+         *  On Linux, reads go to an io_uring instance set up with raw system
+         *  calls, so no liburing is needed. If the kernel or a seccomp policy
+         *  refuses io_uring, or a ring read fails with EINVAL or EOPNOTSUPP
+         *  (kernels before 5.6 lack IORING_OP_READ), reads move to a small
+         *  pool of pread() threads. Without CSV_ENABLE_THREADS, pread() runs
+         *  in wait() instead.
+         *
+         *  @par O_DIRECT
+         *  With `direct_io`, reads use a second descriptor opened with
+         *  O_DIRECT. Callers must then align buffers, offsets and lengths to
+         *  CSV_ASYNC_READ_ALIGNMENT. If the open or any read fails with
+         *  EINVAL, every later read goes through the page cache instead.
+         *
+         *  Short reads before the end of the file are finished with pread().
+         */
+        class AsyncFileReader {
+        public:
+            AsyncFileReader(
+                const std::string& filename,
+                size_t queue_depth,
+                bool direct_io,
+                bool allow_io_uring = true
+            );
+
+            ~AsyncFileReader();
+
+            AsyncFileReader(const AsyncFileReader&) = delete;
+            AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+            /** Size of the file when it was opened */
+            size_t size() const noexcept { return this->size_; }
+
+            bool uses_io_uring() const noexcept;
+            bool uses_direct_io() const noexcept;
+
+            /** Start reading [offset, offset + length) into `dst`. */
+            void submit(char* dst, size_t offset, size_t length);
+
+            /** Wait for the oldest outstanding read and return its byte count,
+             *  which is only short at the end of the file.
+             */
+            size_t wait();
+
+        private:
+            struct Request {
+                char* dst = nullptr;
+                size_t offset = 0;
+                size_t length = 0;
+                size_t done = 0;
+                int error = 0;
+                bool on_ring = false;
+                bool complete = false;
+            };
+
+            struct IoUringRing;
+
+            int read_fd() const noexcept;
+            void read_now(Request& request);
+            void finish_ring_read(Request& request, int result);
+            void reap_ring();
+            void submit_to_threads(Request& request);
+
+            std::string filename_;
+            size_t size_ = 0;
+            int fd_ = -1;
+            int direct_fd_ = -1;
+
+            // Requests in submission order; deque keeps their addresses stable.
+            std::deque<Request> requests_;
+
+            std::unique_ptr<IoUringRing> ring_;
+            bool ring_usable_ = false;
+            size_t ring_in_flight_ = 0;
+
+#if CSV_ENABLE_THREADS
+            void worker_loop();
+
+            // direct_fd_ may be abandoned by any worker.
+            std::atomic<bool> direct_usable_{ false };
+            size_t queue_depth_ = 1;
+            std::deque<Request*> thread_queue_;
+            std::vector<std::thread> workers_;
+            std::mutex lock_;
+            std::condition_variable work_ready_;
+            std::condition_variable read_done_;
+            bool stopping_ = false;
+#else
+            bool direct_usable_ = false;
+#endif
+        };
+
+        /** Parser for files read ahead into pooled buffers.
+         *
+         *  @par Implementation
+         *  Selected by CSVFormat::file_read_mode(FileReadMode::ASYNC_READ).
+         *  Up to CSVFormat::async_read_depth() window-sized reads are kept in
+         *  flight by an AsyncFileReader. Each read lands in a
+         *  memory::StreamBuffer behind a block of headroom. When a read
+         *  completes, the incomplete row left by the previous window is copied
+         *  into that headroom, so the window is contiguous. The next read is
+         *  issued before the window is parsed.
+         *
+         *  @par Buffer lifetime
+         *  Each window's buffer is the owner of the rows parsed from it and
+         *  returns to the pool when the last of those rows is destroyed.
+         *
+         *  @par Format resolution
+         *  The constructor reads the head of the file with the same reader,
+         *  so format guessing never touches a memory map.
+         */
+        class AsyncFileParser : public CSVParserDriverBase {
+        public:
+            AsyncFileParser(
+                csv::string_view filename,
+                const CSVFormat& format,
+                const ColNamesPtr& col_names = nullptr,
+                bool allow_io_uring = true
+            );
+
+            ~AsyncFileParser();
+
+            std::string& get_csv_head() override {
+                return this->head_;
+            }
+
+            void next(size_t bytes) override;
+
+            const AsyncFileReader& file_reader() const noexcept { return *this->reader_; }
+
+        private:
+            struct PendingRead {
+                std::shared_ptr<memory::StreamBuffer> buffer;
+                size_t headroom = 0;
+                size_t offset = 0;
+                size_t length = 0;
+            };
+
+            void issue_reads(size_t read_size);
+
+            std::string head_;
+            size_t read_depth_ = 2;
+
+            std::shared_ptr<memory::StreamBufferPool> buffer_pool_;
+            std::deque<PendingRead> pending_;
+            size_t next_read_offset_ = 0;
+
+            // Incomplete row at the end of the last parsed window, kept alive
+            // by tail_owner_.
+            std::shared_ptr<memory::StreamBuffer> tail_owner_;
+            const char* tail_ = nullptr;
+            size_t tail_size_ = 0;
+            size_t stream_pos_ = 0;
+
+            // Declared last so in-flight reads finish before buffers are freed.
+            std::unique_ptr<AsyncFileReader> reader_;
+        };
+        }
+    }
+}
+#endif
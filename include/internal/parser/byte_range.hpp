@@ -0,0 +1,175 @@
+/** @file
+ *  @brief Record boundaries for reading one byte range of a CSV file
+ */
+
+#pragma once
+
+#include <cstring>
+
+#include "row_counter.hpp"
+
+namespace csv {
+    namespace internals {
+        namespace parser {
+        /** Bytes before a split offset examined to recover the quote state there */
+        constexpr size_t CSV_BYTE_RANGE_RESYNC_WINDOW = 1024 * 1024;
+
+        /** First record start at or after `target`, assuming a record or a
+         *  quoted field continues at `anchor` depending on `quoted`.
+         *
+         *  Returns `data.size()` when no record starts in [target, end).
+         */
+        inline size_t next_record_start(
+            const RowCountScanner& scanner,
+            csv::string_view data,
+            size_t anchor,
+            bool quoted,
+            size_t target
+        ) {
+            if (!quoted && anchor >= target) {
+                return anchor;
+            }
+
+            size_t boundary = data.size();
+            auto visit = [&](size_t, size_t end, size_t) {
+                size_t next = end + 1;
+                if (data[end] == '\r' && next < data.size() && data[next] == '\n') {
+                    next++;
+                }
+
+                if (next >= target) {
+                    boundary = next;
+                    return false;
+                }
+                return true;
+            };
+
+            RowCountState state = row_count_start_state(quoted, anchor);
+            scanner.scan(data.substr(anchor), anchor, state, visit);
+            return (std::min)(boundary, data.size());
+        }
+
+        /** Finds the first true record boundary at or after a byte offset.
+         *
+         *  The search backs up at most CSV_BYTE_RANGE_RESYNC_WINDOW bytes to a
+         *  line feed and runs the record DFA forward from there twice: once
+         *  as if that line feed ended a record, once as if it was inside a
+         *  quoted field. If both runs reach the same boundary, it is exact.
+         *  Otherwise SpeculativeScanner decides which run to believe, from the
+         *  bytes after the line feed.
+         *
+         *  Without threads, where SpeculativeScanner is not built, and when
+         *  the window holds no line feed at all, the search instead scans
+         *  from the start of the body.
+         */
+        class RecordBoundaryFinder {
+        public:
+            RecordBoundaryFinder(csv::string_view data, const CSVFormat& format, size_t body_start)
+                : data_(data),
+                  body_start_(body_start),
+                  scanner_(format.get_delim(), format.get_quote_char(), format.is_quoting_enabled()),
+                  quoting_(format.is_quoting_enabled() && format.get_quote_char() != format.get_delim())
+#if CSV_ENABLE_THREADS
+                , speculator_(format.is_quoting_enabled()
+                    ? make_parse_flags(format.get_delim(), format.get_quote_char())
+                    : make_parse_flags(format.get_delim()))
+#endif
+            {}
+
+            size_t find(size_t target) const {
+                if (target <= this->body_start_) {
+                    return this->body_start_;
+                }
+
+                if (target >= this->data_.size()) {
+                    return this->data_.size();
+                }
+
+                const size_t window_begin = target - (std::min)(target - this->body_start_, CSV_BYTE_RANGE_RESYNC_WINDOW);
+                if (window_begin == this->body_start_) {
+                    return next_record_start(this->scanner_, this->data_, this->body_start_, false, target);
+                }
+
+                const void* lf = std::memchr(this->data_.data() + window_begin, '\n', target - window_begin);
+                if (lf == nullptr) {
+                    return next_record_start(this->scanner_, this->data_, this->body_start_, false, target);
+                }
+
+                const size_t anchor = static_cast<size_t>(static_cast<const char*>(lf) - this->data_.data()) + 1;
+                const size_t outside = next_record_start(this->scanner_, this->data_, anchor, false, target);
+                if (!this->quoting_) {
+                    return outside;
+                }
+
+                const size_t inside = next_record_start(this->scanner_, this->data_, anchor, true, target);
+                if (inside == outside) {
+                    return outside;
+                }
+
+#if CSV_ENABLE_THREADS
+                const speculative::ChunkSpeculation speculation = this->speculator_.speculate(
+                    0, anchor, this->data_.substr(anchor));
+                return speculation.assumed_start_state.quote_escape ? inside : outside;
+#else
+                return next_record_start(this->scanner_, this->data_, this->body_start_, false, target);
+#endif
+            }
+
+        private:
+            csv::string_view data_;
+            size_t body_start_;
+            RowCountScanner scanner_;
+            bool quoting_;
+#if CSV_ENABLE_THREADS
+            speculative::SpeculativeScanner speculator_;
+#endif
+        };
+
+        /** The part of a file a split-reading CSVReader parses. */
+        struct ByteRangeSplit {
+            /** The format resolved from the head of the file. */
+            CSVFormat format;
+
+            /** Where the rows after the header start. */
+            size_t body_start = 0;
+
+            /** The records starting in [begin, end) belong to the split. */
+            size_t begin = 0;
+            size_t end = 0;
+        };
+
+        /** Resolve the split [offset, offset + length) of `data` to record boundaries.
+         *
+         *  A split owns the records that start inside it: it begins at the
+         *  first record boundary at or after `offset` and reads through the
+         *  record that straddles `offset + length`. Both ends are found the
+         *  same way, so adjacent splits never share or drop a record.
+         */
+        inline ByteRangeSplit find_byte_range_split(
+            csv::string_view data,
+            size_t offset,
+            size_t length,
+            const CSVFormat& source_format
+        ) {
+            ByteRangeSplit split;
+            split.format = CSVParserDriverBase::resolve_format(data.substr(0, 500000), source_format).format;
+
+            const RowCountScanner scanner(
+                split.format.get_delim(),
+                split.format.get_quote_char(),
+                split.format.is_quoting_enabled()
+            );
+            split.body_start = scan_header_rows(scanner, data, split.format.get_header()).body_start;
+
+            const RecordBoundaryFinder boundaries(data, split.format, split.body_start);
+            const size_t limit = length >= data.size() - (std::min)(offset, data.size())
+                ? data.size()
+                : offset + length;
+
+            split.begin = offset == 0 ? split.body_start : boundaries.find(offset);
+            split.end = (std::max)(boundaries.find(limit), split.begin);
+            return split;
+        }
+        }
+    }
+}
@@ -0,0 +1,623 @@
+#include "compressed.hpp"
+#include "orchestrator.hpp"
+#include "stream.hpp"
+
+#if CSV_COMPRESSED_SOURCES
+#include <climits>
+#include <cstring>
+#include <new>
+
+#if CSV_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#if CSV_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace csv {
+    namespace internals {
+        namespace parser {
+        CSV_INLINE uint32_t read_le16(const char* bytes) noexcept {
+            const unsigned char* b = reinterpret_cast<const unsigned char*>(bytes);
+            return static_cast<uint32_t>(b[0]) | static_cast<uint32_t>(b[1]) << 8;
+        }
+
+        CSV_INLINE uint32_t read_le32(const char* bytes) noexcept {
+            return read_le16(bytes) | read_le16(bytes + 2) << 16;
+        }
+
+        CSV_INLINE bool is_gzip_member(const char* bytes, size_t remaining) noexcept {
+            const unsigned char* b = reinterpret_cast<const unsigned char*>(bytes);
+            return remaining >= 3 && b[0] == 0x1f && b[1] == 0x8b && b[2] == 8;
+        }
+
+        CSV_INLINE bool is_zstd_frame(const char* bytes, size_t remaining) noexcept {
+            if (remaining < 4) {
+                return false;
+            }
+
+            const uint32_t magic = read_le32(bytes);
+            return magic == 0xFD2FB528u || (magic & 0xFFFFFFF0u) == 0x184D2A50u;
+        }
+
+        /** Compressed size of a BGZF block from the BC subfield of its gzip
+         *  header, or 0 if the member is not a BGZF block.
+         */
+        CSV_INLINE size_t bgzf_block_size(const char* header, size_t remaining) noexcept {
+            const unsigned char FEXTRA = 4;
+            if (remaining < 18 || !(static_cast<unsigned char>(header[3]) & FEXTRA)) {
+                return 0;
+            }
+
+            const size_t extra_length = read_le16(header + 10);
+            if (remaining < 12 + extra_length) {
+                return 0;
+            }
+
+            const char* field = header + 12;
+            const char* const end = field + extra_length;
+            while (end - field >= 4) {
+                const size_t field_length = read_le16(field + 2);
+                if (field[0] == 'B' && field[1] == 'C' && field_length == 2 && end - field >= 6) {
+                    return static_cast<size_t>(read_le16(field + 4)) + 1;
+                }
+                field += 4 + field_length;
+            }
+
+            return 0;
+        }
+
+        /** Decompresses whole members whose sizes are known, reusing its
+         *  codec state across the members of one task.
+         */
+        class MemberDecoder {
+        public:
+            MemberDecoder() = default;
+            MemberDecoder(const MemberDecoder&) = delete;
+            MemberDecoder& operator=(const MemberDecoder&) = delete;
+
+            ~MemberDecoder() {
+#if CSV_HAS_ZLIB
+                if (this->inflate_ready_) {
+                    inflateEnd(&this->inflate_);
+                }
+#endif
+#if CSV_HAS_ZSTD
+                ZSTD_freeDCtx(this->zstd_);
+#endif
+            }
+
+            /** Decompress `member` of `file` into exactly `member.output_size` bytes at `dst`. */
+            void decode(
+                const char* file,
+                const CompressedMember& member,
+                char* dst,
+                const std::string& filename
+            ) {
+#if CSV_HAS_ZLIB
+                if (member.codec == CompressionCodec::GZIP) {
+                    this->inflate_member(file, member, dst, filename);
+                    return;
+                }
+#endif
+#if CSV_HAS_ZSTD
+                if (member.codec == CompressionCodec::ZSTD) {
+                    if (!this->zstd_) {
+                        this->zstd_ = ZSTD_createDCtx();
+                        if (!this->zstd_) {
+                            throw std::bad_alloc();
+                        }
+                    }
+
+                    const size_t n = ZSTD_decompressDCtx(
+                        this->zstd_, dst, member.output_size, file + member.offset, member.length
+                    );
+                    if (ZSTD_isError(n)) {
+                        throw_decompression_failure(filename, member.offset, ZSTD_getErrorName(n));
+                    }
+                    if (n != member.output_size) {
+                        throw_decompression_failure(filename, member.offset, "frame is shorter than its content size");
+                    }
+                    return;
+                }
+#endif
+                (void)file;
+                (void)dst;
+                throw_decompression_failure(filename, member.offset, "unsupported codec");
+            }
+
+        private:
+#if CSV_HAS_ZLIB
+            void inflate_member(
+                const char* file,
+                const CompressedMember& member,
+                char* dst,
+                const std::string& filename
+            ) {
+                if (!this->inflate_ready_) {
+                    std::memset(&this->inflate_, 0, sizeof(this->inflate_));
+                    // 16 + MAX_WBITS: expect and check the gzip header and trailer.
+                    if (inflateInit2(&this->inflate_, 16 + MAX_WBITS) != Z_OK) {
+                        throw std::bad_alloc();
+                    }
+                    this->inflate_ready_ = true;
+                }
+                else {
+                    inflateReset(&this->inflate_);
+                }
+
+                // BGZF blocks are at most 64KB either way.
+                this->inflate_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(file + member.offset));
+                this->inflate_.avail_in = static_cast<uInt>(member.length);
+                this->inflate_.next_out = reinterpret_cast<Bytef*>(dst);
+                this->inflate_.avail_out = static_cast<uInt>(member.output_size);
+
+                const int status = inflate(&this->inflate_, Z_FINISH);
+                if (status != Z_STREAM_END) {
+                    throw_decompression_failure(filename, member.offset,
+                        this->inflate_.msg ? this->inflate_.msg : "truncated or corrupt gzip member");
+                }
+                if (this->inflate_.avail_out != 0 || this->inflate_.avail_in != 0) {
+                    throw_decompression_failure(filename, member.offset, "BGZF block sizes do not match its contents");
+                }
+            }
+
+            z_stream inflate_;
+            bool inflate_ready_ = false;
+#endif
+#if CSV_HAS_ZSTD
+            ZSTD_DCtx* zstd_ = nullptr;
+#endif
+        };
+
+        /** Members of one window, where each lands in the window buffer,
+         *  and which of them each decode task handles.
+         */
+        struct WindowPlan {
+            std::vector<CompressedMember> members;
+            std::vector<size_t> output_offsets;
+            std::vector<size_t> task_begin;
+        };
+
+        CSV_INLINE CompressedMember read_compressed_member(
+            csv::string_view file,
+            size_t offset,
+            const std::string& filename
+        ) {
+            CompressedMember member;
+            member.offset = offset;
+
+            const char* bytes = file.data() + offset;
+            const size_t remaining = file.size() - offset;
+            if (is_gzip_member(bytes, remaining)) {
+#if CSV_HAS_ZLIB
+                member.codec = CompressionCodec::GZIP;
+                member.length = remaining;
+
+                // The smallest gzip member is an 18-byte header plus an 8-byte trailer.
+                const size_t block_size = bgzf_block_size(bytes, remaining);
+                if (block_size >= 26 && block_size <= remaining) {
+                    member.length = block_size;
+                    member.output_size = read_le32(bytes + block_size - 4);
+                    member.output_size_known = true;
+                }
+                return member;
+#else
+                throw_decompression_failure(filename, offset, "reading gzip needs a build with zlib");
+#endif
+            }
+
+            if (is_zstd_frame(bytes, remaining)) {
+#if CSV_HAS_ZSTD
+                member.codec = CompressionCodec::ZSTD;
+                member.length = remaining;
+
+                // Only frames that can be split need their end found up
+                // front; that walks every block header of the frame.
+                // Skippable frames report a content size of zero.
+                const unsigned long long content_size = ZSTD_getFrameContentSize(bytes, remaining);
+                if (content_size != ZSTD_CONTENTSIZE_UNKNOWN
+                    && content_size != ZSTD_CONTENTSIZE_ERROR
+                    && content_size <= (std::numeric_limits<size_t>::max)()) {
+                    member.length = ZSTD_findFrameCompressedSize(bytes, remaining);
+                    if (ZSTD_isError(member.length)) {
+                        throw_decompression_failure(filename, offset, ZSTD_getErrorName(member.length));
+                    }
+                    member.output_size = static_cast<size_t>(content_size);
+                    member.output_size_known = true;
+                }
+                return member;
+#else
+                throw_decompression_failure(filename, offset, "reading zstd needs a build with libzstd");
+#endif
+            }
+
+            throw_decompression_failure(filename, offset, "not a gzip member or zstd frame");
+        }
+
+        /** Decompresses one member in order, a window at a time. */
+        struct CompressedFileParser::StreamDecoder {
+            StreamDecoder(const CompressedMember& member, const char* file, const std::string& filename)
+                : member(member), input(file + member.offset), filename(filename) {
+#if CSV_HAS_ZLIB
+                if (member.codec == CompressionCodec::GZIP) {
+                    std::memset(&this->inflate_, 0, sizeof(this->inflate_));
+                    if (inflateInit2(&this->inflate_, 16 + MAX_WBITS) != Z_OK) {
+                        throw std::bad_alloc();
+                    }
+                    this->inflate_ready_ = true;
+                }
+#endif
+#if CSV_HAS_ZSTD
+                if (member.codec == CompressionCodec::ZSTD) {
+                    this->zstd_ = ZSTD_createDStream();
+                    if (!this->zstd_) {
+                        throw std::bad_alloc();
+                    }
+                    ZSTD_initDStream(this->zstd_);
+                }
+#endif
+            }
+
+            StreamDecoder(const StreamDecoder&) = delete;
+            StreamDecoder& operator=(const StreamDecoder&) = delete;
+
+            ~StreamDecoder() {
+#if CSV_HAS_ZLIB
+                if (this->inflate_ready_) {
+                    inflateEnd(&this->inflate_);
+                }
+#endif
+#if CSV_HAS_ZSTD
+                ZSTD_freeDStream(this->zstd_);
+#endif
+            }
+
+            /** Decompress up to `capacity` bytes into `dst` and return how many
+             *  were written; sets `finished` once the member has ended.
+             */
+            size_t read(char* dst, size_t capacity) {
+#if CSV_HAS_ZLIB
+                if (this->member.codec == CompressionCodec::GZIP) {
+                    return this->inflate_some(dst, capacity);
+                }
+#endif
+#if CSV_HAS_ZSTD
+                if (this->member.codec == CompressionCodec::ZSTD) {
+                    ZSTD_inBuffer in = { this->input, this->member.length, this->consumed };
+                    ZSTD_outBuffer out = { dst, capacity, 0 };
+                    while (out.pos < out.size && !this->finished) {
+                        const size_t in_before = in.pos;
+                        const size_t out_before = out.pos;
+                        const size_t hint = ZSTD_decompressStream(this->zstd_, &out, &in);
+                        if (ZSTD_isError(hint)) {
+                            throw_decompression_failure(this->filename, this->member.offset + in.pos, ZSTD_getErrorName(hint));
+                        }
+
+                        if (hint == 0) {
+                            this->finished = true;
+                        }
+                        else if (in.pos == in_before && out.pos == out_before) {
+                            throw_decompression_failure(this->filename, this->member.offset + in.pos, "truncated zstd frame");
+                        }
+                    }
+
+                    this->consumed = in.pos;
+                    return out.pos;
+                }
+#endif
+                (void)dst;
+                (void)capacity;
+                throw_decompression_failure(this->filename, this->member.offset, "unsupported codec");
+            }
+
+            CompressedMember member;
+            const char* input = nullptr;
+            const std::string& filename;
+
+            /** Compressed bytes used so far; where the member ends once finished. */
+            size_t consumed = 0;
+            bool finished = false;
+
+        private:
+#if CSV_HAS_ZLIB
+            size_t inflate_some(char* dst, size_t capacity) {
+                size_t produced = 0;
+                while (produced < capacity && !this->finished) {
+                    // avail_in and avail_out are 32-bit, so feed huge members in pieces.
+                    const uInt in_size = static_cast<uInt>((std::min)(this->member.length - this->consumed, size_t(UINT_MAX)));
+                    const uInt out_size = static_cast<uInt>((std::min)(capacity - produced, size_t(UINT_MAX)));
+                    this->inflate_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(this->input + this->consumed));
+                    this->inflate_.avail_in = in_size;
+                    this->inflate_.next_out = reinterpret_cast<Bytef*>(dst + produced);
+                    this->inflate_.avail_out = out_size;
+
+                    const int status = inflate(&this->inflate_, Z_NO_FLUSH);
+                    this->consumed += in_size - this->inflate_.avail_in;
+                    produced += out_size - this->inflate_.avail_out;
+
+                    if (status == Z_STREAM_END) {
+                        this->finished = true;
+                    }
+                    else if (status != Z_OK && status != Z_BUF_ERROR) {
+                        throw_decompression_failure(this->filename, this->member.offset + this->consumed,
+                            this->inflate_.msg ? this->inflate_.msg : "corrupt gzip member");
+                    }
+                    else if (in_size == this->inflate_.avail_in && out_size == this->inflate_.avail_out) {
+                        throw_decompression_failure(this->filename, this->member.offset + this->consumed, "truncated gzip member");
+                    }
+                }
+
+                return produced;
+            }
+
+            z_stream inflate_;
+            bool inflate_ready_ = false;
+#endif
+#if CSV_HAS_ZSTD
+            ZSTD_DStream* zstd_ = nullptr;
+#endif
+        };
+
+        CSV_INLINE CompressedFileParser::CompressedFileParser(
+            csv::string_view filename,
+            const CSVFormat& format,
+            const ColNamesPtr& col_names
+        ) : CSVParserDriverBase(format, col_names),
+            filename_(filename),
+            needs_head_(needs_format_guess(format)),
+            buffer_pool_(std::make_shared<memory::StreamBufferPool>(CSV_DECOMPRESS_READ_AHEAD + 1)) {
+            std::error_code error;
+            auto map = mio::make_mmap_source(this->filename_, 0, mio::map_entire_file, error);
+            if (error) {
+                throw_cannot_open_file(filename);
+            }
+            this->file_ = std::make_shared<mio::basic_mmap_source<char>>(std::move(map));
+            this->source_size_ = this->file_->size();
+
+            this->resolve_format_from_head(format);
+            std::string().swap(this->head_);
+
+            // Decompression shares the speculative parser's workers rather
+            // than starting a second set.
+            CSVFormat parse_format = this->format.format;
+#if CSV_ENABLE_THREADS
+            if (format.is_threading_enabled()) {
+                std::shared_ptr<ParseExecutor> executor = format.get_parse_executor();
+                if (!executor) {
+                    executor = ParseExecutor::global();
+                }
+                if (!executor) {
+                    executor = std::make_shared<ParseExecutor>(
+                        format.get_speculative_parallel_threads(),
+                        format.get_parse_worker_cpus()
+                    );
+                }
+
+                parse_format.parse_executor(executor);
+                this->pool_ = executor->pool();
+            }
+#endif
+            if (!this->pool_) {
+                this->pool_ = std::make_shared<parallel::WorkStealingPool>(0);
+            }
+
+            this->parse_orchestrator_ = make_csv_parse_orchestrator(
+                this->parse_flags_,
+                this->whitespace_flags(),
+                parse_format,
+                0,
+                col_names,
+                true,
+                false
+            );
+        }
+
+        CSV_INLINE CompressedFileParser::~CompressedFileParser() {
+            // Decode tasks still write into window buffers and read the mapping.
+            for (auto& window : this->pending_) {
+                try {
+                    this->pool_->wait(*window.decoded);
+                }
+                catch (...) {}
+            }
+        }
+
+        CSV_INLINE std::string& CompressedFileParser::get_csv_head() {
+            if (!this->needs_head_) {
+                return this->head_;
+            }
+
+            // Same head size as the other drivers.
+            std::string head(500000, '\0');
+            size_t size = 0;
+            size_t offset = 0;
+            while (size < head.size() && offset < this->file_->size()) {
+                const csv::string_view file(this->file_->data(), this->file_->size());
+                StreamDecoder decoder(read_compressed_member(file, offset, this->filename_), file.data(), this->filename_);
+                while (size < head.size() && !decoder.finished) {
+                    size += decoder.read(&head[size], head.size() - size);
+                }
+
+                offset += decoder.consumed;
+            }
+
+            head.resize(size);
+            this->head_ = std::move(head);
+            return this->head_;
+        }
+
+        CSV_INLINE bool CompressedFileParser::source_remaining() const noexcept {
+            return this->stream_ || this->scan_pos_ < this->file_->size();
+        }
+
+        CSV_INLINE size_t CompressedFileParser::headroom(size_t window_size) const noexcept {
+            // Room for a typical incomplete row in front of each window.
+            return (std::max)(window_size / 8, size_t(64 * 1024));
+        }
+
+        CSV_INLINE void CompressedFileParser::plan_windows(size_t window_size) {
+            // Where a member decoded in order ends is only known once it has.
+            if (this->stream_) {
+                return;
+            }
+
+            const csv::string_view file(this->file_->data(), this->file_->size());
+            while (this->pending_.size() < CSV_DECOMPRESS_READ_AHEAD && this->scan_pos_ < file.size()) {
+                std::shared_ptr<WindowPlan> plan = std::make_shared<WindowPlan>();
+                size_t size = 0;
+                size_t task_size = 0;
+                size_t pos = this->scan_pos_;
+                while (pos < file.size() && size < window_size) {
+                    const CompressedMember member = read_compressed_member(file, pos, this->filename_);
+                    if (!member.output_size_known || member.output_size > window_size) {
+                        break;
+                    }
+
+                    if (plan->task_begin.empty() || task_size >= CSV_DECOMPRESS_TASK_SIZE) {
+                        plan->task_begin.push_back(plan->members.size());
+                        task_size = 0;
+                    }
+
+                    plan->members.push_back(member);
+                    plan->output_offsets.push_back(size);
+                    size += member.output_size;
+                    task_size += member.output_size;
+                    pos += member.length;
+                }
+
+                if (plan->members.empty()) {
+                    return;
+                }
+                plan->task_begin.push_back(plan->members.size());
+                this->scan_pos_ = pos;
+
+                PendingWindow window;
+                window.headroom = this->headroom(window_size);
+                window.size = size;
+                window.buffer = this->buffer_pool_->acquire(window.headroom + size);
+                window.decoded.reset(new parallel::TaskGroup());
+
+                char* output = window.buffer->data() + window.headroom;
+                std::shared_ptr<mio::basic_mmap_source<char>> source = this->file_;
+                const std::string filename = this->filename_;
+                this->pool_->spawn_for(*window.decoded, plan->task_begin.size() - 1,
+                    [plan, source, output, filename](size_t, size_t task) {
+                        MemberDecoder decoder;
+                        for (size_t i = plan->task_begin[task]; i < plan->task_begin[task + 1]; ++i) {
+                            decoder.decode(source->data(), plan->members[i], output + plan->output_offsets[i], filename);
+                        }
+                    });
+
+                this->pending_.push_back(std::move(window));
+            }
+        }
+
+        CSV_INLINE CompressedFileParser::PendingWindow CompressedFileParser::decode_sequential(size_t window_size) {
+            PendingWindow window;
+            window.headroom = (std::max)(this->headroom(window_size), this->tail_size_);
+            window.buffer = this->buffer_pool_->acquire(window.headroom + window_size);
+
+            const csv::string_view file(this->file_->data(), this->file_->size());
+            char* output = window.buffer->data() + window.headroom;
+            while (window.size < window_size) {
+                if (!this->stream_) {
+                    if (this->scan_pos_ >= file.size()) {
+                        break;
+                    }
+
+                    const CompressedMember member = read_compressed_member(file, this->scan_pos_, this->filename_);
+                    if (member.output_size_known && member.output_size <= window_size) {
+                        // Left to plan_windows() to decode in parallel.
+                        break;
+                    }
+                    this->stream_.reset(new StreamDecoder(member, file.data(), this->filename_));
+                }
+
+                window.size += this->stream_->read(output + window.size, window_size - window.size);
+                if (this->stream_->finished) {
+                    this->scan_pos_ = this->stream_->member.offset + this->stream_->consumed;
+                    this->stream_.reset();
+                }
+            }
+
+            return window;
+        }
+
+        CSV_INLINE void CompressedFileParser::next(size_t bytes = CSV_CHUNK_SIZE_DEFAULT) {
+            if (this->eof()) return;
+
+            const size_t window_size = (std::min)(
+                this->parse_orchestrator_->read_window_size(bytes),
+                (std::max)(bytes, CSV_STREAM_WINDOW_SIZE_MAX)
+            );
+
+            // A window may not complete a row, e.g. one empty member, so keep
+            // going until one does.
+            for (;;) {
+                this->plan_windows(window_size);
+
+                PendingWindow window;
+                if (!this->pending_.empty()) {
+                    window = std::move(this->pending_.front());
+                    this->pending_.pop_front();
+                    this->pool_->wait(*window.decoded);
+                }
+                else if (this->source_remaining()) {
+                    window = this->decode_sequential(window_size);
+                }
+                else {
+                    // Empty file
+                    this->eof_ = true;
+                    this->end_feed();
+                    return;
+                }
+
+                // Keep the workers busy while this window is parsed.
+                this->plan_windows(window_size);
+                const bool source_exhausted = this->pending_.empty() && !this->source_remaining();
+
+                // Put the previous window's incomplete row in front of this one.
+                char* data = window.buffer->data() + window.headroom;
+                std::shared_ptr<memory::StreamBuffer> owner = std::move(window.buffer);
+                char* chunk_begin = data - this->tail_size_;
+                if (this->tail_size_ > window.headroom) {
+                    owner = this->buffer_pool_->acquire(this->tail_size_ + window.size);
+                    chunk_begin = owner->data();
+                    std::memcpy(chunk_begin + this->tail_size_, data, window.size);
+                }
+                if (this->tail_size_ > 0) {
+                    std::memcpy(chunk_begin, this->tail_, this->tail_size_);
+                }
+                this->tail_owner_.reset();
+
+                const csv::string_view chunk(chunk_begin, this->tail_size_ + window.size);
+                const CSVParseWindowResult result = this->parse_orchestrator_->parse_window(
+                    chunk,
+                    owner,
+                    this->stream_pos_,
+                    bytes,
+                    source_exhausted,
+                    this->output()
+                );
+
+                if (source_exhausted) {
+                    this->eof_ = true;
+                    this->tail_size_ = 0;
+                    return;
+                }
+
+                this->tail_ = chunk.data() + result.complete_prefix_length;
+                this->tail_size_ = chunk.size() - result.complete_prefix_length;
+                this->stream_pos_ += result.complete_prefix_length;
+                this->tail_owner_ = std::move(owner);
+                if (result.complete_prefix_length > 0) {
+                    return;
+                }
+            }
+        }
+        }
+    }
+}
+#endif
@@ -0,0 +1,158 @@
+/** @file
+ *  @brief Parser for gzip, BGZF and zstd compressed files, decompressed in parallel
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../memory/stream_buffer_pool.hpp"
+#include "../parallel/work_stealing_pool.hpp"
+#include "driver.hpp"
+
+// Defined by the CMake build when it finds zlib or libzstd; single-header
+// users define them and link the library themselves.
+#ifndef CSV_HAS_ZLIB
+#define CSV_HAS_ZLIB 0
+#endif
+
+#ifndef CSV_HAS_ZSTD
+#define CSV_HAS_ZSTD 0
+#endif
+
+#if (CSV_HAS_ZLIB || CSV_HAS_ZSTD) && !defined(__EMSCRIPTEN__)
+#define CSV_COMPRESSED_SOURCES 1
+#else
+#define CSV_COMPRESSED_SOURCES 0
+#endif
+
+#if CSV_COMPRESSED_SOURCES
+namespace csv {
+    namespace internals {
+        namespace parser {
+        /** Decompressed bytes each decode task aims for, so a window of small
+         *  BGZF blocks does not become thousands of tasks.
+         */
+        constexpr size_t CSV_DECOMPRESS_TASK_SIZE = 1024 * 1024;
+
+        /** Windows being decompressed ahead of the one being parsed. */
+        constexpr size_t CSV_DECOMPRESS_READ_AHEAD = 2;
+
+        enum class CompressionCodec {
+            GZIP,
+            ZSTD
+        };
+
+        /** One independently decodable piece of a compressed file: a gzip
+         *  member or a zstd frame.
+         */
+        struct CompressedMember {
+            CompressionCodec codec = CompressionCodec::GZIP;
+            size_t offset = 0;
+
+            /** Compressed bytes. Without a recorded output size (a plain gzip
+             *  member or a zstd frame without a content size) the end is only
+             *  found by decoding, so this runs to the end of the file.
+             */
+            size_t length = 0;
+
+            /** Decompressed bytes, if the header records them. */
+            size_t output_size = 0;
+            bool output_size_known = false;
+        };
+
+        /** Describe the member starting at `offset` of `file`.
+         *
+         *  Throws if the bytes there are neither gzip nor zstd, or if the
+         *  codec was not built in.
+         */
+        CompressedMember read_compressed_member(
+            csv::string_view file,
+            size_t offset,
+            const std::string& filename
+        );
+
+        /** Parser for compressed files that decompresses into the windows it parses.
+         *
+         *  @par Parallel decompression
+         *  Members whose header records both their compressed and their
+         *  decompressed size (BGZF blocks, as written by bgzip, and zstd
+         *  frames with a content size, as written by pzstd) can be decoded
+         *  independently. Runs of them are grouped into windows; every member
+         *  is decompressed straight to its offset in the window's buffer by
+         *  tasks on the speculative parser's WorkStealingPool, so the buffer
+         *  is parsed in place with no copy between decompressor and parser.
+         *  While one window is parsed, the next one is being decompressed.
+         *
+         *  @par Sequential decompression
+         *  Plain gzip members (which only end where their deflate stream
+         *  does), zstd frames without a content size and members larger than
+         *  a window are decompressed in order on the reading thread, like
+         *  zcat, but still into the window buffer itself.
+         *
+         *  @par Windows
+         *  As in AsyncFileParser, each window buffer starts with headroom that
+         *  the previous window's incomplete row is copied into, and is the
+         *  owner of the rows parsed from it.
+         */
+        class CompressedFileParser : public CSVParserDriverBase {
+        public:
+            CompressedFileParser(
+                csv::string_view filename,
+                const CSVFormat& format,
+                const ColNamesPtr& col_names = nullptr
+            );
+
+            ~CompressedFileParser();
+
+            std::string& get_csv_head() override;
+
+            void next(size_t bytes) override;
+
+        private:
+            struct StreamDecoder;
+
+            struct PendingWindow {
+                std::shared_ptr<memory::StreamBuffer> buffer;
+                size_t headroom = 0;
+                size_t size = 0;
+                std::unique_ptr<parallel::TaskGroup> decoded;
+            };
+
+            /** Start decompressing windows of `window_size` bytes ahead of the parser. */
+            void plan_windows(size_t window_size);
+
+            /** Decompress up to `window_size` bytes of the members that cannot be split. */
+            PendingWindow decode_sequential(size_t window_size);
+
+            bool source_remaining() const noexcept;
+
+            size_t headroom(size_t window_size) const noexcept;
+
+            std::string filename_;
+            std::shared_ptr<mio::basic_mmap_source<char>> file_;
+            std::string head_;
+            bool needs_head_ = true;
+
+            /** Where the next member not yet planned starts. */
+            size_t scan_pos_ = 0;
+            std::unique_ptr<StreamDecoder> stream_;
+
+            std::shared_ptr<parallel::WorkStealingPool> pool_;
+            std::shared_ptr<memory::StreamBufferPool> buffer_pool_;
+            std::deque<PendingWindow> pending_;
+
+            // Incomplete row at the end of the last parsed window, kept alive
+            // by tail_owner_.
+            std::shared_ptr<memory::StreamBuffer> tail_owner_;
+            const char* tail_ = nullptr;
+            size_t tail_size_ = 0;
+            size_t stream_pos_ = 0;
+        };
+        }
+    }
+}
+#endif
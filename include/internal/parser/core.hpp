@@ -18,6 +18,7 @@
 #include "../csv_format.hpp"
 #include "../csv_row.hpp"
 #include "../row_deque.hpp"
+#include "structural_index.hpp"
 
 namespace csv {
     namespace internals {
@@ -98,6 +99,31 @@ namespace csv {
         /** Return the number of leading BOM bytes to skip, or throw for unsupported Unicode encodings. */
         CSV_INLINE size_t get_bom_skip_or_throw(csv::string_view data, bool& utf8_bom);
 
+        /** Default dialect: parse flags are looked up in the runtime ParseFlagMap. */
+        struct RuntimeDialect {
+            static CONSTEXPR_17 ParseFlags parse_flag(const ParseFlagMap& parse_flags, const char ch) noexcept {
+                return parse_flags.data()[ch + CHAR_OFFSET];
+            }
+        };
+
+        /** Dialect fixed at compile time.
+         *
+         *  parse_flag() ignores the runtime map and classifies with constant
+         *  comparisons, so the DFA switch folds into direct character tests.
+         *  The runtime map must still describe the same dialect because it is
+         *  copied into RawCSVData and used by the speculative scanner.
+         */
+        template<char Delim, char Quote = '"', bool Quoting = true>
+        struct StaticDialect {
+            static constexpr ParseFlags parse_flag(const ParseFlagMap&, const char ch) noexcept {
+                return (Quoting && ch == Quote) ? ParseFlags::QUOTE
+                    : ch == '\n' ? ParseFlags::NEWLINE
+                    : ch == '\r' ? ParseFlags::CARRIAGE_RETURN
+                    : ch == Delim ? ParseFlags::DELIMITER
+                    : ParseFlags::NOT_SPECIAL;
+            }
+        };
+
         /** Explicit DFA state at a parse boundary.
          *
          *  This is intentionally about parser control flow, not field metadata.
@@ -165,8 +191,12 @@ namespace csv {
         };
     }
 
-    /** Standard type for storing collection of rows. */
-    using RowCollection = internals::ThreadSafeDeque<CSVRow>;
+    /** Standard type for storing collection of rows.
+     *
+     *  The reader pipeline is one parser thread feeding one consumer, so this is
+     *  the lock-free SPSC queue (SingleThreadDeque in no-thread builds).
+     */
+    using RowCollection = internals::SPSCRowQueue<CSVRow>;
 
     namespace internals {
         /** Default parse policy hook.
@@ -196,13 +226,14 @@ namespace csv {
                 const WhitespaceMap& ws_flags,
                 bool has_ws_trimming,
                 const ColNamesPtr& col_names
-            ) const {
+            ) {
                 data_ptr = std::make_shared<RawCSVData>();
                 data_ptr->parse_flags = parse_flags;
                 data_ptr->ws_flags = ws_flags;
                 data_ptr->has_ws_trimming = has_ws_trimming;
                 data_ptr->col_names = col_names;
                 fields = &(data_ptr->fields);
+                this->quote_char_ = infer_quote_char(parse_flags, infer_delimiter(parse_flags));
             }
 
             const RawCSVField& push_field(
@@ -279,28 +310,19 @@ namespace csv {
                 size_t field_length,
                 size_t& realized_length
             ) const {
-                using internals::ParseFlags;
-
                 const csv::string_view field_str = csv::string_view(data.data).substr(field_start, field_length);
                 // Allocate the original length as an upper bound, then compact doubled
                 // quotes in one pass. Wasting a byte per escaped quote pair is cheaper
                 // than scanning quote-heavy fields twice in the parser hot path.
                 auto allocation = data.quote_arena.allocate_contiguous(field_str.size());
-                char* out = allocation.data;
-                for (size_t i = 0; i < field_str.size(); ++i) {
-                    if (data.parse_flags[field_str[i] + CHAR_OFFSET] == ParseFlags::QUOTE
-                        && i + 1 < field_str.size()
-                        && data.parse_flags[field_str[i + 1] + CHAR_OFFSET] == ParseFlags::QUOTE) {
-                        *(out++) = field_str[i++];
-                        continue;
-                    }
-
-                    *(out++) = field_str[i];
-                }
-
-                realized_length = static_cast<size_t>(out - allocation.data);
+                realized_length = compact_doubled_quotes(field_str, this->quote_char_, allocation.data);
                 return allocation.offset;
             }
+
+            /** Only fields flagged with escaped quotes reach the compaction kernel,
+             *  so this is never consulted in no_quote mode.
+             */
+            char quote_char_ = '"';
         };
 
         /** Default row policy for the CSVRow path. */
@@ -354,7 +376,8 @@ namespace csv {
             typename RowSink = RowCollection,
             typename ParsePolicy = PermissiveParsePolicy,
             typename FieldPolicy = CSVRowFieldPolicy<false>,
-            typename RowPolicy = CSVRowRowPolicy>
+            typename RowPolicy = CSVRowRowPolicy,
+            typename Dialect = RuntimeDialect>
         class CSVParserCore {
         public:
             CSVParserCore() = default;
@@ -411,8 +434,17 @@ namespace csv {
                 }
             }
 
+            /** Select the field/row boundary engine used by subsequent chunks. */
+            void set_parser_engine(ParserEngine engine) noexcept {
+                this->parser_engine_ = engine;
+            }
+
+            ParserEngine parser_engine() const noexcept {
+                return this->parser_engine_;
+            }
+
             CONSTEXPR_17 ParseFlags parse_flag(const char ch) const noexcept {
-                return parse_flags_.data()[ch + CHAR_OFFSET];
+                return Dialect::parse_flag(this->parse_flags_, ch);
             }
 
             CONSTEXPR_17 ParseFlags compound_parse_flag(const char ch) const noexcept {
@@ -562,73 +594,14 @@ namespace csv {
                 this->resolve_pending_linefeed_at_start(in);
                 this->resolve_pending_quote_at_start(in);
 
-                while (this->data_pos_ < in.size()) {
-                    const size_t raw_end = this->data_pos_;
-                    switch (compound_parse_flag(in[this->data_pos_])) {
-                    case ParseFlags::DELIMITER:
-                        this->push_field();
-                        this->data_pos_++;
-                        break;
-
-                    case ParseFlags::CARRIAGE_RETURN:
-                        if (this->data_pos_ + 1 == in.size()) {
-                            this->pending_linefeed_ = true;
-                            this->data_pos_++;
-                            this->finish_row(raw_end);
-                            break;
-                        }
-                        else if (parse_flag(in[this->data_pos_ + 1]) == ParseFlags::NEWLINE) {
-                            this->data_pos_++;
-                        }
-
-                        CSV_FALLTHROUGH;
-
-                    case ParseFlags::NEWLINE:
-                        this->data_pos_++;
-                        this->finish_row(raw_end);
-                        break;
-
-                    case ParseFlags::NOT_SPECIAL:
-                        this->parse_field();
-                        break;
-
-                    case ParseFlags::QUOTE_ESCAPE_QUOTE:
-                        if (data_pos_ + 1 == in.size()) {
-                            this->pending_quote_ = true;
-                            return this->finish_parse(this->current_row_start());
-                        }
-                        else if (data_pos_ + 1 < in.size()) {
-                            auto next_ch = parse_flag(in[data_pos_ + 1]);
-                            if (next_ch >= ParseFlags::DELIMITER) {
-                                quote_escape_ = false;
-                                data_pos_++;
-                                break;
-                            }
-                            else if (next_ch == ParseFlags::QUOTE) {
-                                data_pos_ += 2;
-                                this->field_length_ += 2;
-                                this->field_has_double_quote_ = true;
-                                break;
-                            }
-                        }
-
-                        this->field_length_++;
-                        data_pos_++;
-                        break;
-
-                    default:
-                        if (this->field_length_ == 0) {
-                            quote_escape_ = true;
-                            data_pos_++;
-                            if (field_start_ == UNINITIALIZED_FIELD && data_pos_ < in.size() && !ws_flag(in[data_pos_]))
-                                field_start_ = (int)(data_pos_ - current_row_start());
-                            break;
-                        }
-
-                        this->field_length_++;
-                        data_pos_++;
-                        break;
-                    }
+                if (!this->quoting_enabled()) {
+                    this->parse_unquoted(in);
+                }
+                else if (this->parser_engine_ == ParserEngine::STRUCTURAL_INDEX) {
+                    this->parse_structural(in);
+                }
+                else {
+                    this->run_state_machine<false>(in, 0);
                 }
 
                 return this->finish_parse(this->current_row_start());
@@ -673,6 +646,7 @@ namespace csv {
             ParserDFAState initial_state_;
             ParserDFAState ending_state_;
             bool scan_bom_for_current_chunk_ = true;
+            ParserEngine parser_engine_ = ParserEngine::STATE_MACHINE;
 
             /** Where we are in the current data block. */
             size_t data_pos_ = 0;
@@ -743,7 +717,9 @@ namespace csv {
                     field_start_ = (int)(data_pos_ - current_row_start());
 
 #if !defined(CSV_NO_SIMD)
-                data_pos_ = find_next_non_special(in, data_pos_, this->simd_sentinels_);
+                data_pos_ = this->quote_escape_
+                    ? find_next_quote(in, data_pos_, this->simd_sentinels_)
+                    : find_next_non_special(in, data_pos_, this->simd_sentinels_);
 #endif
 
                 while (data_pos_ < in.size() && compound_parse_flag(in[data_pos_]) == ParseFlags::NOT_SPECIAL)
@@ -752,6 +728,272 @@ namespace csv {
                 field_length_ = data_pos_ - (field_start_ + current_row_start());
             }
 
+            /** Run the DFA from data_pos_.
+             *
+             *  With StopAtBoundary, returns true as soon as a field or row ends at or
+             *  past `stop_at`, leaving the parser at a clean field boundary. Returns false
+             *  once the chunk is exhausted.
+             */
+            template<bool StopAtBoundary>
+            bool run_state_machine(csv::string_view in, size_t stop_at) {
+                using internals::ParseFlags;
+
+                while (this->data_pos_ < in.size()) {
+                    const size_t raw_end = this->data_pos_;
+                    switch (compound_parse_flag(in[this->data_pos_])) {
+                    case ParseFlags::DELIMITER:
+                        this->push_field();
+                        this->data_pos_++;
+                        IF_CONSTEXPR(StopAtBoundary) {
+                            if (this->data_pos_ >= stop_at) return true;
+                        }
+                        break;
+
+                    case ParseFlags::CARRIAGE_RETURN:
+                        if (this->data_pos_ + 1 == in.size()) {
+                            this->pending_linefeed_ = true;
+                            this->data_pos_++;
+                            this->finish_row(raw_end);
+                            break;
+                        }
+                        else if (parse_flag(in[this->data_pos_ + 1]) == ParseFlags::NEWLINE) {
+                            this->data_pos_++;
+                        }
+
+                        CSV_FALLTHROUGH;
+
+                    case ParseFlags::NEWLINE:
+                        this->data_pos_++;
+                        this->finish_row(raw_end);
+                        IF_CONSTEXPR(StopAtBoundary) {
+                            if (this->data_pos_ >= stop_at) return true;
+                        }
+                        break;
+
+                    case ParseFlags::NOT_SPECIAL:
+                        this->parse_field();
+                        break;
+
+                    case ParseFlags::QUOTE_ESCAPE_QUOTE:
+                        if (data_pos_ + 1 == in.size()) {
+                            this->pending_quote_ = true;
+                            return false;
+                        }
+                        else if (data_pos_ + 1 < in.size()) {
+                            auto next_ch = parse_flag(in[data_pos_ + 1]);
+                            if (next_ch >= ParseFlags::DELIMITER) {
+                                quote_escape_ = false;
+                                data_pos_++;
+                                break;
+                            }
+                            else if (next_ch == ParseFlags::QUOTE) {
+                                data_pos_ += 2;
+                                this->field_length_ += 2;
+                                this->field_has_double_quote_ = true;
+                                break;
+                            }
+                        }
+
+                        this->field_length_++;
+                        data_pos_++;
+                        break;
+
+                    default:
+                        if (this->field_length_ == 0) {
+                            quote_escape_ = true;
+                            data_pos_++;
+                            if (field_start_ == UNINITIALIZED_FIELD && data_pos_ < in.size() && !ws_flag(in[data_pos_]))
+                                field_start_ = (int)(data_pos_ - current_row_start());
+                            break;
+                        }
+
+                        this->field_length_++;
+                        data_pos_++;
+                        break;
+                    }
+                }
+
+                return false;
+            }
+
+            bool at_field_boundary() const noexcept {
+                return !this->quote_escape_
+                    && !this->pending_quote_
+                    && this->field_start_ == UNINITIALIZED_FIELD
+                    && this->field_length_ == 0;
+            }
+
+            /** Parse the chunk with the structural-index engine.
+             *
+             *  Whole blocks are handled by parse_structural_blocks(). The DFA takes
+             *  over wherever that cannot: up to the first field boundary when a chunk
+             *  starts mid-field, across blocks with irregular quoting, and for the
+             *  final partial block.
+             */
+            void parse_structural(csv::string_view in) {
+                if (!this->at_field_boundary() && !this->run_state_machine<true>(in, this->data_pos_)) {
+                    return;
+                }
+
+                for (;;) {
+                    const size_t irregular_end = this->parse_structural_blocks(in);
+                    if (irregular_end == csv::string_view::npos) {
+                        break;
+                    }
+
+                    if (!this->run_state_machine<true>(in, irregular_end)) {
+                        return;
+                    }
+                }
+
+                this->run_state_machine<false>(in, 0);
+            }
+
+            /** Whether the quote sentinel is live; no_quote mode aliases it to the delimiter. */
+            bool quoting_enabled() const noexcept {
+                return this->simd_sentinels_.v_quote[0] != this->simd_sentinels_.v_delim[0];
+            }
+
+            /** Parse a chunk with quoting disabled.
+             *
+             *  Without quotes every delimiter and line ending is structural, so
+             *  whole blocks are split using only delimiter/CR/LF bitmaps. Fields are
+             *  pushed straight from the terminator bits, with no quote counting or
+             *  per-byte DFA steps. The DFA finishes the final partial block.
+             */
+            void parse_unquoted(csv::string_view in) {
+#if !defined(CSV_NO_SIMD)
+                if (!this->at_field_boundary() && !this->run_state_machine<true>(in, this->data_pos_)) {
+                    return;
+                }
+
+                this->parse_unquoted_blocks(in);
+#endif
+                this->run_state_machine<false>(in, 0);
+            }
+
+            /** Consume complete fields from unquoted 64-byte blocks starting at a field boundary.
+             *
+             *  Stops, with data_pos_ at the start of the unfinished field, once less
+             *  than a block plus one lookahead byte remains.
+             */
+            void parse_unquoted_blocks(csv::string_view in) {
+                size_t field_begin = this->data_pos_;
+                uint64_t prev_cr = 0;
+
+                for (size_t block_pos = field_begin; block_pos + STRUCTURAL_BLOCK_SIZE < in.size();
+                    block_pos += STRUCTURAL_BLOCK_SIZE) {
+                    StructuralBlockMasks masks;
+                    find_structural_masks<false>(in.data() + block_pos, this->simd_sentinels_, masks);
+
+                    const uint64_t lf_after_cr = masks.lf & ((masks.cr << 1) | prev_cr);
+                    const uint64_t row_ends = masks.cr | (masks.lf & ~lf_after_cr);
+                    prev_cr = masks.cr >> 63;
+
+                    uint64_t terminators = masks.delim | row_ends;
+                    while (terminators != 0) {
+                        const unsigned bit = trailing_zeros64(terminators);
+                        const size_t field_end = block_pos + bit;
+                        if (field_end > field_begin) {
+                            this->field_start_ = (int)(field_begin - this->current_row_start());
+                            this->field_length_ = field_end - field_begin;
+                        }
+
+                        this->data_pos_ = field_end + 1;
+                        if ((masks.delim >> bit) & 1) {
+                            this->push_field();
+                        }
+                        else {
+                            // A CR at bit 63 can still see its LF through the lookahead byte.
+                            if (in[field_end] == '\r' && in[field_end + 1] == '\n') {
+                                this->data_pos_++;
+                            }
+
+                            this->finish_row(field_end);
+                        }
+
+                        field_begin = this->data_pos_;
+                        terminators &= terminators - 1;
+                    }
+                }
+
+                this->data_pos_ = field_begin;
+            }
+
+            /** Consume complete fields from 64-byte blocks starting at a field boundary.
+             *
+             *  Stops, with data_pos_ at the start of the unfinished field, either when
+             *  less than a block plus one lookahead byte remains (returns npos) or at a
+             *  block the indexer rejects (returns the end of that block).
+             */
+            size_t parse_structural_blocks(csv::string_view in) {
+                parser::StructuralIndexer indexer(this->simd_sentinels_);
+                size_t field_begin = this->data_pos_;
+                size_t field_quotes = 0;
+
+                for (size_t block_pos = field_begin; block_pos + STRUCTURAL_BLOCK_SIZE < in.size();
+                    block_pos += STRUCTURAL_BLOCK_SIZE) {
+                    parser::StructuralBlock block;
+                    if (!indexer.classify(in.data() + block_pos, in[block_pos + STRUCTURAL_BLOCK_SIZE], block)) {
+                        this->data_pos_ = field_begin;
+                        return block_pos + STRUCTURAL_BLOCK_SIZE;
+                    }
+
+                    uint64_t terminators = block.field_ends | block.row_ends;
+                    while (terminators != 0) {
+                        const unsigned bit = trailing_zeros64(terminators);
+                        const uint64_t before = (uint64_t(1) << bit) - 1;
+                        field_quotes += popcount64(block.quotes & before);
+                        block.quotes &= ~before;
+
+                        const size_t field_end = block_pos + bit;
+                        this->load_structural_field(field_begin, field_end, field_quotes);
+                        field_quotes = 0;
+
+                        if ((block.field_ends >> bit) & 1) {
+                            this->push_field();
+                            this->data_pos_ = field_end + 1;
+                        }
+                        else {
+                            // A CR at bit 63 can still see its LF through the lookahead byte.
+                            this->data_pos_ = field_end + 1;
+                            if (in[field_end] == '\r' && in[field_end + 1] == '\n') {
+                                this->data_pos_++;
+                            }
+
+                            this->finish_row(field_end);
+                        }
+
+                        field_begin = this->data_pos_;
+                        terminators &= terminators - 1;
+                    }
+
+                    field_quotes += popcount64(block.quotes);
+                }
+
+                this->data_pos_ = field_begin;
+                return csv::string_view::npos;
+            }
+
+            /** Set the field state the DFA would have built for in[begin, end).
+             *
+             *  The indexer only accepts quotes that open a field, close it right
+             *  before its terminator, or form escaped pairs, so any quote means the
+             *  field is quoted from `begin` to `end - 1`.
+             */
+            void load_structural_field(size_t begin, size_t end, size_t quote_count) noexcept {
+                const size_t row_start = this->current_row_start();
+                if (quote_count > 0) {
+                    this->field_start_ = (int)(begin + 1 - row_start);
+                    this->field_length_ = end - begin - 2;
+                    this->field_has_double_quote_ = quote_count > 2;
+                }
+                else if (end > begin) {
+                    this->field_start_ = (int)(begin - row_start);
+                    this->field_length_ = end - begin;
+                }
+            }
+
             /** Finish parsing the current field. */
             void push_field() {
                 const RawCSVField& field = this->field_policy_.push_field(
@@ -0,0 +1,229 @@
+#include "descriptor.hpp"
+#include "orchestrator.hpp"
+
+#if CSV_DESCRIPTOR_SOURCES
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace csv {
+    namespace internals {
+        namespace parser {
+        CSV_INLINE DescriptorParser::DescriptorParser(
+            int fd,
+            const CSVFormat& format,
+            const ColNamesPtr& col_names
+        ) : CSVParserDriverBase(format, col_names),
+            fd_(fd),
+            max_read_delay_(format.get_max_read_delay()),
+            needs_head_(needs_format_guess(format)) {
+            // poll() skips negative descriptors instead of failing on them.
+            if (fd < 0 || ::fcntl(fd, F_GETFL) < 0) {
+                throw_stream_read_failure();
+            }
+
+            this->resolve_format_from_head(format);
+
+            // Speculative windows would hold rows back until they fill.
+            this->parse_orchestrator_ = make_csv_parse_orchestrator(
+                this->parse_flags_,
+                this->whitespace_flags(),
+                this->format.format,
+                0,
+                col_names,
+                false,
+                false
+            );
+        }
+
+        CSV_INLINE std::string& DescriptorParser::get_csv_head() {
+            if (!this->needs_head_) {
+                return this->head_;
+            }
+
+            // Same head size as the other drivers.
+            std::string head(500000, '\0');
+            size_t size = 0;
+            while (size < head.size() && !this->source_ended_) {
+                const bool has_line = std::memchr(head.data(), '\n', size) != nullptr;
+                const size_t n = this->read_some(
+                    &head[size],
+                    head.size() - size,
+                    has_line ? static_cast<int>(CSV_DESCRIPTOR_HEAD_IDLE.count()) : -1
+                );
+
+                if (n == 0) {
+                    break;
+                }
+                size += n;
+            }
+
+            head.resize(size);
+            this->head_ = std::move(head);
+            return this->head_;
+        }
+
+        CSV_INLINE size_t DescriptorParser::read_some(char* dst, size_t capacity, int timeout_ms) {
+            for (;;) {
+                pollfd request;
+                request.fd = this->fd_;
+                request.events = POLLIN;
+                request.revents = 0;
+
+                const int ready = ::poll(&request, 1, timeout_ms);
+                if (ready < 0) {
+                    if (errno == EINTR) continue;
+                    throw_stream_read_failure();
+                }
+
+                if (ready == 0) {
+                    return 0;
+                }
+
+                const ssize_t n = ::read(this->fd_, dst, capacity);
+                if (n > 0) {
+                    return static_cast<size_t>(n);
+                }
+
+                if (n == 0) {
+                    this->source_ended_ = true;
+                    return 0;
+                }
+
+                if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
+                    throw_stream_read_failure();
+                }
+            }
+        }
+
+        CSV_INLINE size_t DescriptorParser::read_available(
+            char* dst,
+            size_t capacity,
+            std::chrono::microseconds delay
+        ) {
+            size_t total = this->read_some(dst, capacity, -1);
+            if (total == 0 || delay.count() <= 0) {
+                return total;
+            }
+
+            const auto deadline = std::chrono::steady_clock::now() + delay;
+            while (total < capacity && !this->source_ended_) {
+                const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                    deadline - std::chrono::steady_clock::now()
+                );
+                if (remaining.count() <= 0) {
+                    break;
+                }
+
+                const int timeout_ms = static_cast<int>((remaining.count() + 999) / 1000);
+                const size_t n = this->read_some(dst + total, capacity - total, timeout_ms);
+                if (n == 0) {
+                    break;
+                }
+                total += n;
+            }
+
+            return total;
+        }
+
+        /** Make room for `bytes` more bytes behind the pending tail, moving
+         *  the tail to a fresh pooled buffer when the current one is full.
+         */
+        CSV_INLINE void DescriptorParser::reserve_read_space(size_t bytes) {
+            if (this->buffer_ && this->buffer_->capacity() - this->buffer_end_ >= bytes) {
+                return;
+            }
+
+            const size_t tail_size = this->buffer_end_ - this->tail_begin_;
+            std::shared_ptr<memory::StreamBuffer> next_buffer = this->buffer_pool_->acquire(
+                tail_size + 2 * bytes
+            );
+            if (tail_size > 0) {
+                std::memcpy(next_buffer->data(), this->buffer_->data() + this->tail_begin_, tail_size);
+            }
+
+            this->buffer_ = std::move(next_buffer);
+            this->tail_begin_ = 0;
+            this->buffer_end_ = tail_size;
+        }
+
+        CSV_INLINE void DescriptorParser::next(size_t bytes = CSV_CHUNK_SIZE_DEFAULT) {
+            if (this->eof()) return;
+
+            // The first rows must also cover the header CSVReader trims, or
+            // it would find nothing left to read.
+            const int header = this->format.format.get_header();
+            const size_t rows_wanted = (std::max)(
+                this->output().pushed_count() + 1,
+                header >= 0 ? static_cast<size_t>(header) + 2 : size_t(1)
+            );
+            for (;;) {
+                size_t n = 0;
+                if (!this->head_.empty()) {
+                    this->reserve_read_space((std::max)(bytes, this->head_.size()));
+                    std::memcpy(this->buffer_->data() + this->buffer_end_, this->head_.data(), this->head_.size());
+                    n = this->head_.size();
+                    std::string().swap(this->head_);
+                }
+                else {
+                    this->reserve_read_space(bytes);
+                    if (!this->source_ended_) {
+                        n = this->read_available(
+                            this->buffer_->data() + this->buffer_end_,
+                            bytes,
+                            this->max_read_delay_
+                        );
+                    }
+                }
+
+                const char* fresh = this->buffer_->data() + this->buffer_end_;
+                this->buffer_end_ += n;
+                const csv::string_view chunk(
+                    this->buffer_->data() + this->tail_begin_,
+                    this->buffer_end_ - this->tail_begin_
+                );
+
+                if (this->source_ended_) {
+                    this->parse_orchestrator_->parse_window(
+                        chunk,
+                        this->buffer_,
+                        this->stream_pos_,
+                        bytes,
+                        true,
+                        this->output()
+                    );
+                    this->eof_ = true;
+                    this->buffer_.reset();
+                    return;
+                }
+
+                // No row can end without a line break among the new bytes.
+                if (std::memchr(fresh, '\n', n) || std::memchr(fresh, '\r', n)) {
+                    const CSVParseWindowResult result = this->parse_orchestrator_->parse_window(
+                        chunk,
+                        this->buffer_,
+                        this->stream_pos_,
+                        bytes,
+                        false,
+                        this->output()
+                    );
+                    this->tail_begin_ += result.complete_prefix_length;
+                    this->stream_pos_ += result.complete_prefix_length;
+
+                    if (this->output().pushed_count() >= rows_wanted) {
+                        return;
+                    }
+                }
+
+                // A whole chunk without a row: CSVReader reports the oversized row.
+                if (this->buffer_end_ - this->tail_begin_ >= bytes) {
+                    return;
+                }
+            }
+        }
+        }
+    }
+}
+#endif
@@ -0,0 +1,101 @@
+/** @file
+ *  @brief Low-latency parser for pipes, sockets and other file descriptors
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "../memory/stream_buffer_pool.hpp"
+#include "driver.hpp"
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#define CSV_DESCRIPTOR_SOURCES 1
+#else
+#define CSV_DESCRIPTOR_SOURCES 0
+#endif
+
+#if CSV_DESCRIPTOR_SOURCES
+namespace csv {
+    namespace internals {
+        namespace parser {
+        /** How long a live source must stay quiet before its head is used for
+         *  format guessing, once the head holds at least one line.
+         */
+        constexpr std::chrono::milliseconds CSV_DESCRIPTOR_HEAD_IDLE{ 100 };
+
+        /** Parser for a readable file descriptor that surfaces rows as soon
+         *  as their bytes arrive.
+         *
+         *  @par Implementation
+         *  StreamParser fills a whole window with istream::read() before
+         *  parsing, so a slow feed shows no rows until hundreds of KB arrive.
+         *  This parser instead takes whatever one read() returns and parses
+         *  the pending bytes whenever the new ones hold a line break. next()
+         *  returns as soon as a window yields a complete row, so the reader
+         *  sees each row one read after it is written.
+         *
+         *  @par Latency and throughput
+         *  CSVFormat::max_read_delay() trades the two: after the first bytes
+         *  arrive, reads continue for up to that long (or until the window is
+         *  full) before anything is parsed. Zero parses every read.
+         *
+         *  @par Chunk storage
+         *  Same as StreamParser: reads land directly behind the incomplete
+         *  row in pooled memory::StreamBuffers, which go back to the pool
+         *  once the last row referencing them is destroyed.
+         *
+         *  @par Format resolution
+         *  When the delimiter or header row must be guessed, the constructor
+         *  collects a head of up to 500KB, stopping early at end of input or
+         *  once a line has arrived and the source has been quiet for
+         *  CSV_DESCRIPTOR_HEAD_IDLE. Setting both explicitly skips this.
+         *
+         *  The descriptor may be blocking or non-blocking; it is not closed.
+         */
+        class DescriptorParser : public CSVParserDriverBase {
+        public:
+            DescriptorParser(
+                int fd,
+                const CSVFormat& format,
+                const ColNamesPtr& col_names = nullptr
+            );
+
+            std::string& get_csv_head() override;
+
+            void next(size_t bytes) override;
+
+        private:
+            /** Read at least one byte into [dst, dst + capacity) unless the
+             *  source has ended, then keep reading until `delay` has passed.
+             */
+            size_t read_available(char* dst, size_t capacity, std::chrono::microseconds delay);
+
+            /** One read(); waits with poll() for at most `timeout_ms`
+             *  (negative: forever). Returns 0 on timeout or end of input.
+             */
+            size_t read_some(char* dst, size_t capacity, int timeout_ms);
+
+            void reserve_read_space(size_t bytes);
+
+            int fd_ = -1;
+            std::chrono::microseconds max_read_delay_{ 0 };
+            bool needs_head_ = false;
+            bool source_ended_ = false;
+
+            // Head bytes read for format guessing, parsed by the first next().
+            std::string head_;
+
+            std::shared_ptr<memory::StreamBufferPool> buffer_pool_ =
+                std::make_shared<memory::StreamBufferPool>();
+            std::shared_ptr<memory::StreamBuffer> buffer_;
+            size_t tail_begin_ = 0;
+            size_t buffer_end_ = 0;
+            size_t stream_pos_ = 0;
+        };
+        }
+    }
+}
+#endif
@@ -88,18 +88,23 @@ namespace csv {
             const ColNamesPtr& col_names
         ) : CSVParserCore<>(source_format, col_names) {}
 
-        CSV_INLINE void CSVParserDriverBase::resolve_format_from_head(const CSVFormat& source_format) {
-            auto head = this->get_csv_head();
+        CSV_INLINE bool CSVParserDriverBase::needs_format_guess(const CSVFormat& source_format) {
+            const bool infer_delimiter = source_format.guess_delim();
+            const bool infer_header = !source_format.header_explicitly_set_
+                && (infer_delimiter || !source_format.col_names_explicitly_set_);
+            const bool infer_n_cols = (source_format.get_header() < 0 && source_format.get_col_names().empty());
+            return infer_delimiter || infer_header || infer_n_cols;
+        }
 
+        CSV_INLINE ResolvedFormat CSVParserDriverBase::resolve_format(csv::string_view head, const CSVFormat& source_format) {
             ResolvedFormat resolved;
             resolved.format = source_format;
 
             const bool infer_delimiter = source_format.guess_delim();
             const bool infer_header = !source_format.header_explicitly_set_
                 && (infer_delimiter || !source_format.col_names_explicitly_set_);
-            const bool infer_n_cols = (source_format.get_header() < 0 && source_format.get_col_names().empty());
 
-            if (infer_delimiter || infer_header || infer_n_cols) {
+            if (needs_format_guess(source_format)) {
                 auto guess_result = guess_format(head, source_format.get_possible_delims());
                 if (infer_delimiter) {
                     resolved.format.delimiter(guess_result.delim);
@@ -113,6 +118,13 @@ namespace csv {
                 resolved.n_cols = guess_result.n_cols;
             }
 
+            return resolved;
+        }
+
+        CSV_INLINE void CSVParserDriverBase::resolve_format_from_head(const CSVFormat& source_format) {
+            auto head = this->get_csv_head();
+            ResolvedFormat resolved = resolve_format(head, source_format);
+
             if (resolved.format.no_quote) {
                 this->set_parse_flags(
                     make_parse_flags(resolved.format.get_delim()),
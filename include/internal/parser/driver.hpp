@@ -111,6 +111,11 @@ namespace csv {
 
             virtual size_t worker_count() const noexcept = 0;
             virtual SpeculativeParseDiagnostics diagnostics() const noexcept = 0;
+
+            /** Whether parse_window() may release rows of earlier windows instead
+             *  of its own, so a call that releases no rows is not an error.
+             */
+            virtual bool defers_rows() const noexcept { return false; }
             virtual size_t read_window_size(size_t chunk_size) const noexcept = 0;
             virtual bool utf8_bom() const noexcept = 0;
             virtual void reset_with_initial_state(ParserDFAState state) noexcept = 0;
@@ -157,15 +162,33 @@ namespace csv {
 
             ResolvedFormat get_resolved_format() { return this->format; }
 
+            /** Fill in the delimiter, header row and column count `source_format`
+             *  leaves to inference, using the first bytes of a source.
+             */
+            static ResolvedFormat resolve_format(csv::string_view head, const CSVFormat& source_format);
+
+            /** Whether resolve_format() needs the head of a source to complete `source_format`. */
+            static bool needs_format_guess(const CSVFormat& source_format);
+
             /** Parse the next block of data */
             virtual void next(size_t bytes) = 0;
 
+            /** Wake a next() call that is waiting for its source to grow, so it
+             *  can see RowCollection::producer_interrupted() and return.
+             */
+            virtual void interrupt_read() noexcept {}
+
             virtual SpeculativeParseDiagnostics speculative_diagnostics() const noexcept {
                 return this->parse_orchestrator_
                     ? this->parse_orchestrator_->diagnostics()
                     : SpeculativeParseDiagnostics();
             }
 
+            /** Whether next() may leave the rows of the window it read queued for a later call. */
+            bool defers_rows() const noexcept {
+                return this->parse_orchestrator_ && this->parse_orchestrator_->defers_rows();
+            }
+
             virtual size_t parse_worker_count() const noexcept {
                 return this->parse_orchestrator_
                     ? this->parse_orchestrator_->worker_count()
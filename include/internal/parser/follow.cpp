@@ -0,0 +1,415 @@
+#include "follow.hpp"
+#include "orchestrator.hpp"
+#include "row_counter.hpp"
+
+#if CSV_FOLLOW_FILES
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+namespace csv {
+    namespace internals {
+        namespace parser {
+        /** The state to start parsing in right after `consumed`, which ends a record. */
+        CSV_INLINE ParserDFAState state_after(csv::string_view consumed) noexcept {
+            return !consumed.empty() && consumed.back() == '\r'
+                ? ParserDFAState(false, false, true)
+                : ParserDFAState();
+        }
+
+        CSV_INLINE RowCountScanner make_row_count_scanner(const CSVFormat& format) {
+            return RowCountScanner(format.get_delim(), format.get_quote_char(), format.is_quoting_enabled());
+        }
+
+        CSV_INLINE void set_nonblocking(int fd) noexcept {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+
+        CSV_INLINE FollowParser::FollowParser(
+            csv::string_view filename,
+            const CSVCheckpoint& resume_from,
+            std::chrono::milliseconds poll_interval,
+            const CSVFormat& format,
+            const ColNamesPtr& col_names
+        ) : CSVParserDriverBase(format, col_names),
+            filename_(filename),
+            poll_interval_(poll_interval) {
+            if (::pipe(this->wake_fds_) != 0) {
+                throw std::system_error(errno, std::generic_category(), "Cannot create CSV follow wake-up pipe");
+            }
+            set_nonblocking(this->wake_fds_[0]);
+            set_nonblocking(this->wake_fds_[1]);
+
+            if (!this->open_file()) {
+                throw_cannot_open_file(filename);
+            }
+
+            // A file may be created empty: wait for enough of it to resolve the format.
+            const bool guess = needs_format_guess(format);
+            for (;;) {
+                this->head_.resize(500000);
+                this->head_.resize(this->read_file(&this->head_[0], this->head_.size(), 0));
+                if (this->head_.size() == 500000) {
+                    break;
+                }
+
+                const bool has_line = this->head_.find_first_of("\r\n") != std::string::npos;
+                if (!guess || has_line) {
+                    const CSVFormat resolved = resolve_format(this->head_, format).format;
+                    if (resolved.get_header() < 0
+                        || scan_header_rows(make_row_count_scanner(resolved), this->head_, resolved.get_header()).complete) {
+                        break;
+                    }
+                }
+
+                this->wait_for_change();
+            }
+
+            this->resolve_format_from_head(format);
+            this->header_rows_ = this->format.format.get_header();
+
+            size_t body_start = 0;
+            if (this->header_rows_ >= 0) {
+                body_start = scan_header_rows(
+                    make_row_count_scanner(this->format.format),
+                    this->head_,
+                    this->header_rows_
+                ).body_start;
+                this->header_ = this->head_.substr(0, body_start);
+            }
+            std::string().swap(this->head_);
+
+            // Speculative windows would hold rows back until they fill.
+            this->parse_orchestrator_ = make_csv_parse_orchestrator(
+                this->parse_flags_,
+                this->whitespace_flags(),
+                this->format.format,
+                0,
+                col_names,
+                false,
+                false
+            );
+
+            struct stat info;
+            const bool same_file = resume_from.inode != 0
+                && resume_from.device == this->device_
+                && resume_from.inode == this->inode_
+                && ::fstat(this->fd_, &info) == 0
+                && resume_from.byte_offset <= static_cast<size_t>(info.st_size);
+
+            ParserDFAState start_state = state_after(this->header_);
+            if (same_file && resume_from.byte_offset > body_start) {
+                body_start = resume_from.byte_offset;
+                start_state = resume_from.state;
+            }
+
+            this->stream_pos_ = body_start;
+            this->file_pos_ = body_start;
+            this->parse_orchestrator_->reset_with_initial_state(start_state);
+
+            FileGeneration generation;
+            generation.device = this->device_;
+            generation.inode = this->inode_;
+            this->generations_.push_back(generation);
+
+            this->committed_checkpoint_.byte_offset = body_start;
+            this->committed_checkpoint_.state = start_state;
+            this->committed_checkpoint_.device = this->device_;
+            this->committed_checkpoint_.inode = this->inode_;
+        }
+
+        CSV_INLINE FollowParser::~FollowParser() {
+            for (int fd : { this->fd_, this->watch_fd_, this->wake_fds_[0], this->wake_fds_[1] }) {
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+            }
+        }
+
+        CSV_INLINE std::string& FollowParser::get_csv_head() {
+            return this->head_;
+        }
+
+        CSV_INLINE bool FollowParser::open_file() {
+            const int fd = ::open(this->filename_.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return false;
+            }
+
+            struct stat info;
+            if (::fstat(fd, &info) != 0) {
+                ::close(fd);
+                return false;
+            }
+
+            if (this->fd_ >= 0) {
+                ::close(this->fd_);
+            }
+            this->fd_ = fd;
+            this->device_ = static_cast<unsigned long long>(info.st_dev);
+            this->inode_ = static_cast<unsigned long long>(info.st_ino);
+
+#if defined(__linux__)
+            // Without inotify, wait_for_change() falls back to polling.
+            if (this->watch_fd_ < 0) {
+                this->watch_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            }
+
+            if (this->watch_fd_ >= 0) {
+                if (this->watch_ >= 0) {
+                    ::inotify_rm_watch(this->watch_fd_, this->watch_);
+                }
+
+                this->watch_ = ::inotify_add_watch(
+                    this->watch_fd_,
+                    this->filename_.c_str(),
+                    IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF
+                );
+            }
+#endif
+            return true;
+        }
+
+        CSV_INLINE size_t FollowParser::read_file(char* dst, size_t length, size_t offset) {
+            for (;;) {
+                const ssize_t n = ::pread(this->fd_, dst, length, static_cast<off_t>(offset));
+                if (n >= 0) {
+                    return static_cast<size_t>(n);
+                }
+
+                if (errno != EINTR) {
+                    throw_file_read_failure(errno, this->filename_, offset, length);
+                }
+            }
+        }
+
+        CSV_INLINE void FollowParser::wait_for_change() {
+            pollfd requests[2];
+            nfds_t n_requests = 0;
+            for (int fd : { this->wake_fds_[0], this->watch_fd_ }) {
+                if (fd >= 0) {
+                    requests[n_requests].fd = fd;
+                    requests[n_requests].events = POLLIN;
+                    requests[n_requests].revents = 0;
+                    n_requests++;
+                }
+            }
+
+            if (::poll(requests, n_requests, static_cast<int>(this->poll_interval_.count())) > 0) {
+                // Only the wake-up matters, not what the events were.
+                char events[4096];
+                for (nfds_t i = 0; i < n_requests; ++i) {
+                    while (::read(requests[i].fd, events, sizeof(events)) > 0) {}
+                }
+            }
+        }
+
+        CSV_INLINE void FollowParser::interrupt_read() noexcept {
+            const char wake = 0;
+            (void)!::write(this->wake_fds_[1], &wake, 1);
+        }
+
+        CSV_INLINE void FollowParser::commit(ParserDFAState state) {
+            std::lock_guard<std::mutex> lock(this->commit_lock_);
+            this->committed_rows_ = this->output().pushed_count();
+            this->committed_checkpoint_.byte_offset = this->stream_pos_;
+            this->committed_checkpoint_.state = state;
+            this->committed_checkpoint_.device = this->device_;
+            this->committed_checkpoint_.inode = this->inode_;
+            this->committed_.notify_all();
+        }
+
+        CSV_INLINE CSVCheckpoint FollowParser::checkpoint(RowCollection& rows) {
+            std::unique_lock<std::mutex> lock(this->commit_lock_);
+            for (;;) {
+                const size_t popped = rows.popped_count();
+                if (const CSVRow* row = rows.peek_front()) {
+                    // Rows are numbered by push order; find the file this one came from.
+                    size_t generation = this->generations_.size() - 1;
+                    while (generation > 0 && this->generations_[generation].first_row > popped) {
+                        generation--;
+                    }
+                    this->generations_.erase(this->generations_.begin(), this->generations_.begin() + generation);
+
+                    CSVCheckpoint result;
+                    result.byte_offset = row->byte_offset();
+                    result.device = this->generations_.front().device;
+                    result.inode = this->generations_.front().inode;
+                    return result;
+                }
+
+                // Every queued row is gone: the answer is the last commit,
+                // unless rows of a window still being parsed were popped.
+                if (popped <= this->committed_rows_) {
+                    return this->committed_checkpoint_;
+                }
+                this->committed_.wait(lock);
+            }
+        }
+
+        CSV_INLINE void FollowParser::restart_file() {
+            this->tail_begin_ = this->buffer_end_;
+            this->stream_pos_ = 0;
+            this->file_pos_ = 0;
+            this->skipping_header_ = this->header_rows_ >= 0;
+            this->parse_orchestrator_->reset_with_initial_state(ParserDFAState());
+
+            {
+                std::lock_guard<std::mutex> lock(this->commit_lock_);
+                FileGeneration generation;
+                generation.first_row = this->output().pushed_count();
+                generation.device = this->device_;
+                generation.inode = this->inode_;
+                this->generations_.push_back(generation);
+            }
+            this->commit(ParserDFAState());
+        }
+
+        CSV_INLINE bool FollowParser::follow_replacement(size_t bytes) {
+            struct stat current;
+            if (::fstat(this->fd_, &current) == 0 && static_cast<size_t>(current.st_size) < this->file_pos_) {
+                // Truncated in place, as copytruncate rotation does.
+                this->restart_file();
+                return true;
+            }
+
+            struct stat named;
+            if (::stat(this->filename_.c_str(), &named) != 0
+                || (static_cast<unsigned long long>(named.st_dev) == this->device_
+                    && static_cast<unsigned long long>(named.st_ino) == this->inode_)) {
+                return false;
+            }
+
+            // The path names a new file, so nothing more will be written to
+            // this one: its last row is complete even without a line break.
+            if (this->buffer_end_ > this->tail_begin_) {
+                this->parse_pending(true, bytes);
+            }
+
+            if (!this->open_file()) {
+                return false;
+            }
+
+            this->restart_file();
+            return true;
+        }
+
+        CSV_INLINE bool FollowParser::skip_header() {
+            const csv::string_view pending(this->buffer_->data() + this->tail_begin_, this->buffer_end_ - this->tail_begin_);
+            const RowCountHeader header = scan_header_rows(
+                make_row_count_scanner(this->format.format),
+                pending,
+                this->header_rows_
+            );
+            if (!header.complete) {
+                return false;
+            }
+
+            this->tail_begin_ += header.body_start;
+            this->stream_pos_ += header.body_start;
+            this->skipping_header_ = false;
+
+            const ParserDFAState state = state_after(pending.substr(0, header.body_start));
+            this->parse_orchestrator_->reset_with_initial_state(state);
+            this->commit(state);
+            return true;
+        }
+
+        CSV_INLINE void FollowParser::parse_pending(bool source_exhausted, size_t bytes) {
+            const csv::string_view chunk(this->buffer_->data() + this->tail_begin_, this->buffer_end_ - this->tail_begin_);
+            const CSVParseWindowResult result = this->parse_orchestrator_->parse_window(
+                chunk,
+                this->buffer_,
+                this->stream_pos_,
+                bytes,
+                source_exhausted,
+                this->output()
+            );
+
+            const size_t consumed = source_exhausted ? chunk.size() : result.complete_prefix_length;
+            this->tail_begin_ += consumed;
+            this->stream_pos_ += consumed;
+
+            const ParserDFAState end_state = this->parse_orchestrator_->ending_state();
+            this->commit(end_state.pending_linefeed && this->tail_begin_ == this->buffer_end_
+                ? ParserDFAState(false, false, true)
+                : ParserDFAState());
+        }
+
+        /** Make room for `bytes` more bytes behind the pending tail, moving
+         *  the tail to a fresh pooled buffer when the current one is full.
+         */
+        CSV_INLINE void FollowParser::reserve_read_space(size_t bytes) {
+            if (this->buffer_ && this->buffer_->capacity() - this->buffer_end_ >= bytes) {
+                return;
+            }
+
+            const size_t tail_size = this->buffer_end_ - this->tail_begin_;
+            std::shared_ptr<memory::StreamBuffer> next_buffer = this->buffer_pool_->acquire(
+                tail_size + 2 * bytes
+            );
+            if (tail_size > 0) {
+                std::memcpy(next_buffer->data(), this->buffer_->data() + this->tail_begin_, tail_size);
+            }
+
+            this->buffer_ = std::move(next_buffer);
+            this->tail_begin_ = 0;
+            this->buffer_end_ = tail_size;
+        }
+
+        CSV_INLINE void FollowParser::next(size_t bytes = CSV_CHUNK_SIZE_DEFAULT) {
+            const size_t pushed_before = this->output().pushed_count();
+            const bool first_call = !this->started_;
+            this->started_ = true;
+
+            for (;;) {
+                // CSVReader interrupts a waiting read-ahead thread to stop it.
+                if (this->output().producer_interrupted()) {
+                    return;
+                }
+
+                this->reserve_read_space(bytes);
+                const size_t n = this->read_file(this->buffer_->data() + this->buffer_end_, bytes, this->file_pos_);
+                if (n > 0) {
+                    const char* fresh = this->buffer_->data() + this->buffer_end_;
+                    this->buffer_end_ += n;
+                    this->file_pos_ += n;
+
+                    // No row can end without a line break among the new bytes.
+                    if ((!this->skipping_header_ || this->skip_header())
+                        && (std::memchr(fresh, '\n', n) || std::memchr(fresh, '\r', n))) {
+                        this->parse_pending(false, bytes);
+                        if (this->output().pushed_count() > pushed_before) {
+                            return;
+                        }
+                    }
+
+                    // A whole chunk without a row: CSVReader reports the oversized row.
+                    if (this->buffer_end_ - this->tail_begin_ >= bytes) {
+                        return;
+                    }
+                    continue;
+                }
+
+                if (this->follow_replacement(bytes)) {
+                    continue;
+                }
+
+                if (first_call || this->output().pushed_count() > pushed_before) {
+                    return;
+                }
+                this->wait_for_change();
+            }
+        }
+        }
+    }
+}
+#endif
@@ -0,0 +1,181 @@
+/** @file
+ *  @brief Parser that follows a growing file, like `tail -F`
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../memory/stream_buffer_pool.hpp"
+#include "descriptor.hpp"
+#include "driver.hpp"
+
+#define CSV_FOLLOW_FILES CSV_DESCRIPTOR_SOURCES
+
+#if CSV_FOLLOW_FILES
+namespace csv {
+    /** Where a following CSVReader stopped, for a later reader to resume from.
+     *
+     *  All fields are plain values, so a checkpoint can be saved anywhere and
+     *  passed back through CSVFollowSource.
+     */
+    struct CSVCheckpoint {
+        /** Where the next unread record starts, as CSVRow::byte_offset() would report it. */
+        size_t byte_offset = 0;
+
+        /** Parser state at `byte_offset`: a record that ended in a CR
+         *  leaves `pending_linefeed` set, so a LF written after it is skipped.
+         */
+        internals::ParserDFAState state;
+
+        /** Device and inode of the file `byte_offset` belongs to, or zero if
+         *  unknown. A different file at the same path means it was rotated.
+         */
+        unsigned long long device = 0;
+        unsigned long long inode = 0;
+    };
+
+    namespace internals {
+        namespace parser {
+        /** Default wait between checks for growth and rotation when change
+         *  notifications are unavailable, and the longest a notification can be missed for.
+         */
+        constexpr std::chrono::milliseconds CSV_FOLLOW_POLL_INTERVAL{ 250 };
+
+        /** Parser that keeps reading a file as it grows, across log rotation.
+         *
+         *  @par Waiting for data
+         *  At the end of the file, next() sleeps until the file changes: on
+         *  Linux an inotify watch wakes it as soon as bytes are appended, and
+         *  elsewhere (or if inotify is unavailable) it rechecks every poll
+         *  interval. The incomplete last row stays in the buffer until the
+         *  rest of it is written. The first next() returns without waiting,
+         *  so constructing a reader never blocks on an idle file once its
+         *  header is there.
+         *
+         *  @par Rotation and truncation
+         *  When the file is caught up and the path now names a different
+         *  file (renamed away or deleted and recreated), the last row of the
+         *  old file is finished even without a line break and reading moves
+         *  to the new file. When the file is shorter than what was read, it
+         *  was truncated in place and reading restarts from its top, dropping
+         *  any incomplete row. Either way the header rows of the new contents
+         *  are skipped and byte offsets restart at zero.
+         *
+         *  @par Checkpoints
+         *  checkpoint() reports where the rows not yet popped from the
+         *  reader's queue begin. A checkpoint passed to the constructor starts
+         *  reading there directly when it names the same file and is not past
+         *  its end; otherwise the file was replaced and reading starts after
+         *  its header. The header itself is always read from the top of the
+         *  file, so column names match the original reader's.
+         */
+        class FollowParser : public CSVParserDriverBase {
+        public:
+            FollowParser(
+                csv::string_view filename,
+                const CSVCheckpoint& resume_from,
+                std::chrono::milliseconds poll_interval,
+                const CSVFormat& format,
+                const ColNamesPtr& col_names = nullptr
+            );
+
+            ~FollowParser();
+
+            std::string& get_csv_head() override;
+
+            void next(size_t bytes) override;
+
+            void interrupt_read() noexcept override;
+
+            /** The header rows at the top of the file; empty without a header row. */
+            csv::string_view header() const noexcept { return this->header_; }
+
+            /** Name the columns up front, so the reader skips no header rows itself. */
+            void use_column_names(const std::vector<std::string>& names) {
+                this->format.format.column_names(names);
+            }
+
+            /** Where the rows not yet popped from `rows` start.
+             *
+             *  Only call from the thread consuming `rows`. Briefly waits if the
+             *  parser is in the middle of a window whose rows were all popped.
+             */
+            CSVCheckpoint checkpoint(RowCollection& rows);
+
+        private:
+            struct FileGeneration {
+                size_t first_row = 0;
+                unsigned long long device = 0;
+                unsigned long long inode = 0;
+            };
+
+            /** Open the file at the path and watch it; false if there is none. */
+            bool open_file();
+
+            /** Start reading the current file from its top, behind its header rows. */
+            void restart_file();
+
+            /** Move to a replacement or truncated file once the current one is
+             *  caught up. Returns true if there is something new to read.
+             */
+            bool follow_replacement(size_t bytes);
+
+            /** Skip the header rows of restarted contents once they are complete. */
+            bool skip_header();
+
+            void parse_pending(bool source_exhausted, size_t bytes);
+
+            void commit(ParserDFAState state);
+
+            /** Sleep until the file may have changed, the poll interval passes,
+             *  or interrupt_read() is called.
+             */
+            void wait_for_change();
+
+            size_t read_file(char* dst, size_t length, size_t offset);
+
+            void reserve_read_space(size_t bytes);
+
+            std::string filename_;
+            std::chrono::milliseconds poll_interval_;
+            int fd_ = -1;
+            int watch_fd_ = -1;
+            int watch_ = -1;
+            int wake_fds_[2] = { -1, -1 };
+            unsigned long long device_ = 0;
+            unsigned long long inode_ = 0;
+            bool started_ = false;
+
+            /** Header rows to skip in restarted contents; negative for none. */
+            int header_rows_ = -1;
+            bool skipping_header_ = false;
+            std::string header_;
+            std::string head_;
+
+            std::shared_ptr<memory::StreamBufferPool> buffer_pool_ =
+                std::make_shared<memory::StreamBufferPool>();
+            std::shared_ptr<memory::StreamBuffer> buffer_;
+            size_t tail_begin_ = 0;
+            size_t buffer_end_ = 0;
+
+            /** Offset in the current file of buffer_[tail_begin_], and of the end of what was read. */
+            size_t stream_pos_ = 0;
+            size_t file_pos_ = 0;
+
+            // What checkpoint() needs, published after every parsed window.
+            std::mutex commit_lock_;
+            std::condition_variable committed_;
+            size_t committed_rows_ = 0;
+            CSVCheckpoint committed_checkpoint_;
+            std::vector<FileGeneration> generations_;
+        };
+        }
+    }
+}
+#endif
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "driver.hpp"
+#include "orchestrator.hpp"
+
+namespace csv {
+    namespace internals {
+        namespace parser {
+        /** Parser for CSV bytes that are already in memory.
+         *
+         *  @par Implementation
+         *  Each window is a view into the caller's buffer, so rows reference the
+         *  source bytes directly instead of a copy. An incomplete trailing row is
+         *  simply re-read at the start of the next window. Because the source
+         *  size is known up front, large buffers take the same speculative
+         *  parallel path as MmapParser.
+         *
+         *  @par Lifetime
+         *  `owner` is shared by every row parsed from the buffer. When it is
+         *  null, the caller must keep the bytes alive and unchanged for as long
+         *  as the reader or any of its rows exist.
+         *
+         *  @par Slices
+         *  `source_offset` is added to every row's byte offset, for buffers
+         *  that start partway into a file.
+         */
+        class MemoryParser : public CSVParserDriverBase {
+        public:
+            MemoryParser(
+                csv::string_view data,
+                std::shared_ptr<void> owner,
+                const CSVFormat& format,
+                const ColNamesPtr& col_names = nullptr,
+                size_t source_offset = 0
+            ) : CSVParserDriverBase(format, col_names),
+                data_(data),
+                owner_(std::move(owner)),
+                source_offset_(source_offset) {
+                if (!this->owner_) {
+                    // Rows only need a non-null owner; this one keeps nothing alive.
+                    this->owner_ = std::shared_ptr<void>(const_cast<char*>(data.data()), [](void*) {});
+                }
+
+                this->source_size_ = data.size();
+                this->resolve_format_from_head(format);
+                std::string().swap(this->head_);
+
+                this->parse_orchestrator_ = make_csv_parse_orchestrator(
+                    this->parse_flags_,
+                    this->whitespace_flags(),
+                    format,
+                    this->source_size_,
+                    col_names,
+                    true
+                );
+            }
+
+            std::string& get_csv_head() override {
+                // Same head size as the stream and mmap paths.
+                this->head_ = std::string(this->data_.substr(0, 500000));
+                return this->head_;
+            }
+
+            void next(size_t bytes = CSV_CHUNK_SIZE_DEFAULT) override {
+                if (this->eof()) return;
+
+                const size_t remaining = this->data_.size() - this->pos_;
+                const size_t length = (std::min)(remaining, this->parse_orchestrator_->read_window_size(bytes));
+                if (length == 0) {
+                    this->eof_ = true;
+                    this->end_feed();
+                    return;
+                }
+
+                const bool source_exhausted = length == remaining;
+                const CSVParseWindowResult result = this->parse_orchestrator_->parse_window(
+                    this->data_.substr(this->pos_, length),
+                    this->owner_,
+                    this->source_offset_ + this->pos_,
+                    bytes,
+                    source_exhausted,
+                    this->output()
+                );
+
+                if (source_exhausted) {
+                    this->eof_ = true;
+                }
+                else {
+                    this->pos_ += result.complete_prefix_length;
+                }
+            }
+
+        private:
+            csv::string_view data_;
+            std::shared_ptr<void> owner_;
+            size_t source_offset_ = 0;
+            size_t pos_ = 0;
+            std::string head_;
+        };
+        }
+    }
+}
@@ -5,6 +5,61 @@
 namespace csv {
     namespace internals {
         namespace parser {
+        /** Apply madvise() to the pages covering [begin, end) of a mapping.
+         *
+         *  @param[in] shrink  Round inward so only pages wholly inside the range
+         *                     are affected (for releasing memory); otherwise round
+         *                     outward (for prefetching).
+         */
+        CSV_INLINE void advise_mmap_range(
+            const char* base,
+            size_t map_size,
+            size_t begin,
+            size_t end,
+            int advice,
+            bool shrink
+        ) noexcept {
+#if defined(_WIN32)
+            (void)base; (void)map_size; (void)begin; (void)end; (void)advice; (void)shrink;
+#else
+            const size_t page = static_cast<size_t>(PAGE_SIZE);
+            end = (std::min)(end, map_size);
+            if (shrink) {
+                begin = (begin + page - 1) / page * page;
+                end = end / page * page;
+            }
+            else {
+                begin = begin / page * page;
+                end = (std::min)((end + page - 1) / page * page, map_size);
+            }
+
+            if (begin < end) {
+                // Advice is a hint; failure only costs performance.
+                (void)::madvise(const_cast<char*>(base) + begin, end - begin, advice);
+            }
+#endif
+        }
+
+        /** Owner of one chunk in whole-file mode.
+         *
+         *  Keeps the mapping alive while any RawCSVData from the chunk exists.
+         *  When the last one goes away, the bytes this chunk fully consumed are
+         *  not needed again, so their pages are dropped from the resident set.
+         *  The mapping is read-only and shared, so a stray later access would
+         *  simply fault the page back in from the page cache.
+         */
+        struct MmapWindowOwner {
+            std::shared_ptr<mio::basic_mmap_source<char>> map;
+            size_t release_begin = 0;
+            size_t release_end = 0;
+
+            ~MmapWindowOwner() {
+#if !defined(_WIN32)
+                advise_mmap_range(map->data(), map->size(), release_begin, release_end, MADV_DONTNEED, true);
+#endif
+            }
+        };
+
         CSV_INLINE MmapParser::MmapParser(
             csv::string_view filename,
             const CSVFormat& format,
@@ -15,6 +70,8 @@ namespace csv {
             this->head_ = std::move(head_and_size.first);
             this->source_size_ = head_and_size.second;
             this->resolve_format_from_head(format);
+            this->whole_file_ = format.is_mmap_whole_file_enabled();
+            this->huge_pages_ = format.is_mmap_huge_pages_enabled();
 
             this->parse_orchestrator_ = make_csv_parse_orchestrator(
                 this->parse_flags_,
@@ -58,6 +115,37 @@ namespace csv {
                 : chunk_size;
         }
 
+        CSV_INLINE bool MmapParser::ensure_file_map() {
+            if (this->file_map_) {
+                return true;
+            }
+
+            if (!this->whole_file_) {
+                return false;
+            }
+
+            std::error_code error;
+            auto mmap = mio::make_mmap_source(this->_filename, 0, mio::map_entire_file, error);
+            if (error || mmap.size() != this->source_size_) {
+                // Typically address-space exhaustion; windowed mapping still works.
+                this->whole_file_ = false;
+                return false;
+            }
+
+            this->file_map_ = std::make_shared<mio::basic_mmap_source<char>>(std::move(mmap));
+#if !defined(_WIN32)
+            const char* base = this->file_map_->data();
+            const size_t size = this->file_map_->size();
+            advise_mmap_range(base, size, 0, size, MADV_SEQUENTIAL, false);
+#if defined(MADV_HUGEPAGE)
+            if (this->huge_pages_) {
+                advise_mmap_range(base, size, 0, size, MADV_HUGEPAGE, false);
+            }
+#endif
+#endif
+            return true;
+        }
+
         CSV_INLINE void MmapParser::next(size_t bytes = CSV_CHUNK_SIZE_DEFAULT) {
             // CRITICAL SECTION: Chunk Transition Logic
             // This function reads 10MB chunks and must correctly handle fields that span
@@ -93,6 +181,26 @@ namespace csv {
                 return;
             }
 
+            if (this->ensure_file_map()) {
+                auto window_owner = std::make_shared<MmapWindowOwner>();
+                window_owner->map = this->file_map_;
+                window_owner->release_begin = offset;
+                this->mmap_pos += length;
+
+#if !defined(_WIN32)
+                // Start faulting in the next window while this one is parsed.
+                advise_mmap_range(
+                    this->file_map_->data(), this->file_map_->size(),
+                    this->mmap_pos, this->mmap_pos + length, MADV_WILLNEED, false
+                );
+#endif
+
+                csv::string_view chunk(this->file_map_->data() + offset, length);
+                this->finalize_loaded_chunk(chunk, window_owner, length, bytes);
+                window_owner->release_end = this->mmap_pos;
+                return;
+            }
+
             std::error_code error;
             auto mmap = mio::make_mmap_source(this->_filename, offset, length, error);
             if (error) {
@@ -14,6 +14,13 @@ namespace csv {
          *  than the user has available. It contains logic to automatically
          *  re-align each memory map to the beginning of a CSV row.
          *
+         *  @par Whole-file mode
+         *  With CSVFormat::mmap_whole_file(), the file is mapped once and each
+         *  chunk is a view into that mapping, avoiding a mmap/munmap pair per
+         *  chunk. Page advice (sequential access, prefetch of the next window,
+         *  and release of fully consumed windows) keeps the resident set close to
+         *  what windowed mapping would use.
+         *
          *  @par Head buffer
          *  CSVReader may prime a pre-read head buffer used for format guessing
          *  via prime_head_for_reuse(). When provided, the first next() call
@@ -47,9 +54,16 @@ namespace csv {
 
             size_t read_window_size(size_t chunk_size) const noexcept;
 
+            /** Map the whole file on first use; false if it must stay windowed. */
+            bool ensure_file_map();
+
             std::string _filename;
             size_t mmap_pos = 0;
             std::string head_;
+
+            bool whole_file_ = false;
+            bool huge_pages_ = false;
+            std::shared_ptr<mio::basic_mmap_source<char>> file_map_ = nullptr;
         };
         }
     }
@@ -1,12 +1,14 @@
 #pragma once
 
 #include "driver.hpp"
+#include "../parse_executor.hpp"
+#include "../speculative/chunk_sizer.hpp"
 #include "../speculative/parallel_parser.hpp"
 
 namespace csv {
     namespace internals {
         namespace parser {
-        template<bool EagerClassify = false>
+        template<bool EagerClassify = false, typename Dialect = RuntimeDialect>
         class CSVParseOrchestrator : public ICSVParseOrchestrator {
         public:
             CSVParseOrchestrator(
@@ -22,16 +24,28 @@ namespace csv {
 #if CSV_ENABLE_THREADS
                   , parse_flags_(parse_flags),
                   ws_flags_(ws_flags),
-                  scanner_(parse_flags)
+                  scanner_(parse_flags),
+                  chunk_sizer_(speculative::CSV_SPECULATIVE_PREFIX_SIZE)
 #endif
             {
+                this->serial_parser_.set_parser_engine(format.get_parser_engine());
 #if CSV_ENABLE_THREADS
+                std::shared_ptr<ParseExecutor> executor = format.get_parse_executor();
+                if (!executor) {
+                    executor = ParseExecutor::global();
+                }
+
                 size_t n_threads = 1;
                 if (format.is_threading_enabled()
                     && enable_speculative_parallel
                     && (!source_size_known || source_size >= format.get_speculative_parallel_min_bytes())) {
                     n_threads = format.get_speculative_parallel_threads();
-                    if (n_threads == 0) {
+                    if (executor) {
+                        // Chunks in flight beyond the shared worker count would only queue.
+                        const size_t shared_workers = executor->worker_count();
+                        n_threads = n_threads == 0 ? shared_workers : (std::min)(n_threads, shared_workers);
+                    }
+                    else if (n_threads == 0) {
                         const unsigned int hardware_threads = std::thread::hardware_concurrency();
                         n_threads = hardware_threads == 0 ? 2 : static_cast<size_t>(hardware_threads);
                     }
@@ -46,17 +60,26 @@ namespace csv {
                         this->worker_count_
                     ));
                 if (this->use_speculative_parallel_) {
-                    this->speculative_parser_.reset(new speculative::ParallelCSVParser<EagerClassify>(
-                        this->parse_flags_,
-                        this->ws_flags_,
-                        this->worker_count_,
-                        col_names
-                    ));
+                    using SpeculativeParser = speculative::ParallelCSVParser<EagerClassify, Dialect>;
+                    this->speculative_parser_.reset(executor
+                        ? new SpeculativeParser(this->parse_flags_, this->ws_flags_, executor->pool(), col_names)
+                        : new SpeculativeParser(
+                            this->parse_flags_,
+                            this->ws_flags_,
+                            std::make_shared<internals::parallel::WorkStealingPool>(
+                                this->worker_count_,
+                                format.get_parse_worker_cpus()
+                            ),
+                            col_names
+                        )
+                    );
+                    this->speculative_parser_->set_parser_engine(format.get_parser_engine());
+                    this->pipeline_windows_ = format.is_speculative_pipeline_enabled();
+                    this->adaptive_chunks_ = format.is_speculative_adaptive_chunks_enabled();
                 }
 #else
                 (void)parse_flags;
                 (void)ws_flags;
-                (void)format;
                 (void)source_size;
                 (void)enable_speculative_parallel;
                 (void)source_size_known;
@@ -75,6 +98,14 @@ namespace csv {
                 return this->speculative_diagnostics_;
             }
 
+            bool defers_rows() const noexcept override {
+#if CSV_ENABLE_THREADS
+                return this->pipeline_windows_;
+#else
+                return false;
+#endif
+            }
+
             size_t read_window_size(size_t chunk_size) const noexcept override {
 #if CSV_ENABLE_THREADS
                 if (!this->use_speculative_parallel_ || this->worker_count_ <= 1) {
@@ -113,10 +144,31 @@ namespace csv {
                 RowCollection& output
             ) override {
 #if CSV_ENABLE_THREADS
+                if (this->pipeline_windows_) {
+                    return this->parse_pipelined_window(
+                        chunk,
+                        std::move(owner),
+                        base_offset,
+                        serial_chunk_size,
+                        source_exhausted,
+                        output
+                    );
+                }
+
                 if (this->use_speculative_parallel_
                     && this->worker_count_ > 1
                     && serial_chunk_size > 0
                     && chunk.size() > serial_chunk_size) {
+                    if (this->adaptive_chunks_ && this->chunk_sizer_.serial()) {
+                        return this->parse_suspended_window(
+                            chunk,
+                            std::move(owner),
+                            base_offset,
+                            source_exhausted,
+                            output
+                        );
+                    }
+
                     return this->parse_speculative_window(
                         chunk,
                         std::move(owner),
@@ -171,14 +223,17 @@ namespace csv {
                 RowCollection& output
             ) {
                 CSVParseWindowResult result;
+                const size_t pushed_before = output.pushed_count();
                 auto chunks = speculative::make_speculative_parse_chunks(
                     chunk,
                     owner,
-                    serial_chunk_size,
+                    this->speculative_chunk_size(serial_chunk_size),
                     this->scanner_,
                     base_offset,
                     0,
-                    base_offset == 0
+                    base_offset == 0,
+                    true,
+                    true
                 );
 
                 const speculative::ParallelCSVParseResult parse_result = this->speculative_parser_->parse_chunks(
@@ -189,6 +244,111 @@ namespace csv {
 
                 result.complete_prefix_length = parse_result.complete_prefix_length;
                 this->speculative_diagnostics_.merge(parse_result.diagnostics);
+                if (this->adaptive_chunks_) {
+                    this->chunk_sizer_.observe_window(
+                        parse_result.diagnostics,
+                        result.complete_prefix_length,
+                        output.pushed_count() - pushed_before
+                    );
+                }
+                return result;
+            }
+
+            /** Parse a window serially while adaptive chunking has suspended speculation. */
+            CSVParseWindowResult parse_suspended_window(
+                csv::string_view chunk,
+                std::shared_ptr<void> owner,
+                size_t base_offset,
+                bool source_exhausted,
+                RowCollection& output
+            ) {
+                const size_t pushed_before = output.pushed_count();
+                const CSVParseWindowResult result = this->parse_serial_window(
+                    chunk,
+                    std::move(owner),
+                    base_offset,
+                    source_exhausted,
+                    output
+                );
+
+                this->chunk_sizer_.observe_serial_window(
+                    result.complete_prefix_length,
+                    output.pushed_count() - pushed_before
+                );
+                this->speculative_diagnostics_.serial_fallback_windows++;
+                return result;
+            }
+
+            /** Size of the chunks a speculative window of `serial_chunk_size` chunks is split into. */
+            size_t speculative_chunk_size(size_t serial_chunk_size) const noexcept {
+                return this->adaptive_chunks_
+                    ? this->chunk_sizer_.chunk_size(serial_chunk_size)
+                    : serial_chunk_size;
+            }
+
+            /** Hand the window to the speculative pipeline and release the previous one.
+             *
+             *  Every window is consumed in full; the incomplete trailing row stays
+             *  in the pipeline, so the source reads the next window contiguously.
+             *  Small windows go through the pipeline too, because the serial
+             *  parser does not know the pipeline's carried state.
+             */
+            CSVParseWindowResult parse_pipelined_window(
+                csv::string_view chunk,
+                std::shared_ptr<void> owner,
+                size_t base_offset,
+                size_t serial_chunk_size,
+                bool source_exhausted,
+                RowCollection& output
+            ) {
+                const size_t window_chunk_size = (std::max)(chunk.size(), static_cast<size_t>(1));
+
+                // The serial parser does not know the pipeline's carried state, so
+                // a suspended pipeline parses each window as a single chunk instead.
+                const bool suspended = this->adaptive_chunks_ && this->chunk_sizer_.serial();
+                const size_t speculative_chunk_size = serial_chunk_size > 0 && !suspended
+                    ? this->speculative_chunk_size(serial_chunk_size)
+                    : window_chunk_size;
+                auto chunks = speculative::make_speculative_parse_chunks(
+                    chunk,
+                    std::move(owner),
+                    speculative_chunk_size,
+                    this->scanner_,
+                    base_offset,
+                    this->next_sequence_number_,
+                    base_offset == 0,
+                    base_offset == 0,
+                    true
+                );
+                this->next_sequence_number_ += chunks.size();
+
+                const speculative::ParallelCSVParseResult parse_result =
+                    this->speculative_parser_->parse_window_pipelined(
+                        std::move(chunks),
+                        output,
+                        source_exhausted
+                    );
+                this->speculative_diagnostics_.merge(parse_result.diagnostics);
+                if (this->adaptive_chunks_) {
+                    // Rows are released one window late; over several windows the
+                    // bytes-per-row estimate still follows the source.
+                    if (suspended) {
+                        this->chunk_sizer_.observe_serial_window(chunk.size(), parse_result.rows_released);
+                        this->speculative_diagnostics_.serial_fallback_windows++;
+                    }
+                    else {
+                        this->chunk_sizer_.observe_window(parse_result.diagnostics, chunk.size(), parse_result.rows_released);
+                    }
+                }
+
+                // Same guarantee as the serial path (Issue #218): a whole window
+                // without a row boundary means a row is larger than the window.
+                if (!source_exhausted && parse_result.windows_released > 0 && parse_result.rows_released == 0) {
+                    throw_row_too_large_for_chunk(serial_chunk_size);
+                }
+
+                CSVParseWindowResult result;
+                result.complete_prefix_length = chunk.size();
                 return result;
             }
 #endif
@@ -197,18 +357,55 @@ namespace csv {
                 RowCollection,
                 PermissiveParsePolicy,
                 CSVRowFieldPolicy<EagerClassify>,
-                CSVRowRowPolicy> serial_parser_;
+                CSVRowRowPolicy,
+                Dialect> serial_parser_;
             SpeculativeParseDiagnostics speculative_diagnostics_;
 #if CSV_ENABLE_THREADS
             ParseFlagMap parse_flags_;
             WhitespaceMap ws_flags_;
             speculative::SpeculativeScanner scanner_;
             bool use_speculative_parallel_ = false;
+            bool pipeline_windows_ = false;
+            bool adaptive_chunks_ = false;
+            speculative::AdaptiveChunkSizer chunk_sizer_;
+            size_t next_sequence_number_ = 0;
             size_t worker_count_ = 1;
-            std::unique_ptr<speculative::ParallelCSVParser<EagerClassify>> speculative_parser_;
+            std::unique_ptr<speculative::ParallelCSVParser<EagerClassify, Dialect>> speculative_parser_;
 #endif
         };
 
+        template<bool EagerClassify>
+        std::unique_ptr<ICSVParseOrchestrator> make_csv_parse_orchestrator_for(
+            const ParseFlagMap& parse_flags,
+            const WhitespaceMap& ws_flags,
+            const CSVFormat& format,
+            size_t source_size,
+            const ColNamesPtr& col_names,
+            bool enable_speculative_parallel,
+            bool source_size_known
+        ) {
+            const char delim = infer_delimiter(parse_flags);
+            const bool rfc4180_quote = infer_quote_char(parse_flags, '\0') == '"';
+            if (format.is_dialect_specialization_enabled() && rfc4180_quote && delim == ',') {
+                return std::unique_ptr<ICSVParseOrchestrator>(new CSVParseOrchestrator<EagerClassify, StaticDialect<','>>(
+                    parse_flags, ws_flags, format, source_size, col_names,
+                    enable_speculative_parallel, source_size_known
+                ));
+            }
+
+            if (format.is_dialect_specialization_enabled() && rfc4180_quote && delim == '\t') {
+                return std::unique_ptr<ICSVParseOrchestrator>(new CSVParseOrchestrator<EagerClassify, StaticDialect<'\t'>>(
+                    parse_flags, ws_flags, format, source_size, col_names,
+                    enable_speculative_parallel, source_size_known
+                ));
+            }
+
+            return std::unique_ptr<ICSVParseOrchestrator>(new CSVParseOrchestrator<EagerClassify>(
+                parse_flags, ws_flags, format, source_size, col_names,
+                enable_speculative_parallel, source_size_known
+            ));
+        }
+
         inline std::unique_ptr<ICSVParseOrchestrator> make_csv_parse_orchestrator(
             const ParseFlagMap& parse_flags,
             const WhitespaceMap& ws_flags,
@@ -219,7 +416,7 @@ namespace csv {
             bool source_size_known
         ) {
             if (format.is_eager_field_classification_enabled()) {
-                return std::unique_ptr<ICSVParseOrchestrator>(new CSVParseOrchestrator<true>(
+                return make_csv_parse_orchestrator_for<true>(
                     parse_flags,
                     ws_flags,
                     format,
@@ -227,18 +424,18 @@ namespace csv {
                     col_names,
                     enable_speculative_parallel,
                     source_size_known
-                ));
+                );
             }
 
-            return std::unique_ptr<ICSVParseOrchestrator>(new CSVParseOrchestrator<false>(
-                    parse_flags,
-                    ws_flags,
-                    format,
-                    source_size,
-                    col_names,
-                    enable_speculative_parallel,
-                    source_size_known
-                ));
+            return make_csv_parse_orchestrator_for<false>(
+                parse_flags,
+                ws_flags,
+                format,
+                source_size,
+                col_names,
+                enable_speculative_parallel,
+                source_size_known
+            );
         }
         }
     }
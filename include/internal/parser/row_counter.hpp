@@ -0,0 +1,602 @@
+/** @file
+ *  @brief Counts and indexes CSV rows without building CSVRow objects
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "driver.hpp"
+#include "../parse_executor.hpp"
+#include "../speculative/scanner.hpp"
+
+namespace csv {
+    /** Returned by count_rows() */
+    struct CSVRowCount {
+        /** Rows a CSVReader with the same format would return. */
+        size_t n_rows = 0;
+
+        /** Most fields in any record, the header row included. */
+        size_t max_fields = 0;
+
+        /** Fields a row needs to be kept under VariableColumnPolicy::IGNORE_ROW or THROW. */
+        size_t n_cols = 0;
+
+        /** Byte offset where each counted row starts, when requested. */
+        std::vector<size_t> row_offsets;
+
+        /** When only some rows were sampled, the row number of each entry in row_offsets. */
+        std::vector<size_t> row_offset_rows;
+
+        /** The format after delimiter and header inference. */
+        CSVFormat format;
+
+        size_t parse_worker_count = 1;
+        internals::SpeculativeParseDiagnostics speculative_diagnostics;
+    };
+
+    namespace internals {
+        namespace parser {
+        /** DFA state of RowCountScanner between calls. */
+        struct RowCountState {
+            bool quoted = false;
+
+            /** Inside quotes, the last byte was a quote whose meaning depends on the next byte. */
+            bool after_quote = false;
+
+            /** Outside quotes, the next byte starts a field, so a quote would open one. */
+            bool field_start = true;
+
+            /** The last byte was a CR ending a row; a following LF belongs to it. */
+            bool pending_cr = false;
+
+            bool row_has_bytes = false;
+            size_t row_delimiters = 0;
+            size_t row_start = 0;
+        };
+
+        /** Finds record boundaries and field counts 64 bytes at a time.
+         *
+         *  Quote, delimiter and line-ending bitmaps come from the structural
+         *  block kernels. Only quotes and line endings are visited one by one;
+         *  delimiters outside quotes are popcounted per span. The quoting rules
+         *  are those of CSVParserCore: a quote opens a field only as its first
+         *  byte, and inside quotes a quote closes the field only when a
+         *  delimiter or line ending follows, is escaped by a second quote, and
+         *  is literal otherwise. CR, LF and CRLF each end a record.
+         */
+        class RowCountScanner {
+        public:
+            RowCountScanner(char delimiter, char quote_char, bool quoting) noexcept
+                : sentinels_(delimiter, quoting ? quote_char : delimiter),
+                  quoting_(quoting && quote_char != delimiter) {}
+
+            /** Scan `data`, which starts `base_offset` bytes into the source.
+             *
+             *  Calls `visit(row_start, row_end, fields)` for every record that
+             *  ends in `data`, with `fields` 0 for empty lines. Returns the
+             *  number of bytes consumed: all of `data`, unless `visit` returned
+             *  false, in which case scanning stops after that record.
+             */
+            template<typename Visitor>
+            size_t scan(csv::string_view data, size_t base_offset, RowCountState& state, Visitor& visit) const {
+                for (size_t block_pos = 0; block_pos < data.size(); block_pos += STRUCTURAL_BLOCK_SIZE) {
+                    const size_t block_bytes = (std::min)(STRUCTURAL_BLOCK_SIZE, data.size() - block_pos);
+                    const uint64_t valid = block_bytes == STRUCTURAL_BLOCK_SIZE
+                        ? ~uint64_t(0)
+                        : (uint64_t(1) << block_bytes) - 1;
+
+                    StructuralBlockMasks masks;
+                    if (block_bytes == STRUCTURAL_BLOCK_SIZE) {
+                        find_structural_masks(data.data() + block_pos, this->sentinels_, masks);
+                    }
+                    else {
+                        char padded[STRUCTURAL_BLOCK_SIZE] = {};
+                        std::memcpy(padded, data.data() + block_pos, block_bytes);
+                        find_structural_masks(padded, this->sentinels_, masks);
+                    }
+
+                    const uint64_t quotes = this->quoting_ ? masks.quote & valid : 0;
+                    const uint64_t delims = masks.delim & valid;
+                    const uint64_t crs = masks.cr & valid;
+                    const uint64_t lfs = masks.lf & valid;
+                    const uint64_t separators = delims | crs | lfs;
+                    const size_t block_offset = base_offset + block_pos;
+                    size_t cursor = 0;
+
+                    if (state.pending_cr) {
+                        state.pending_cr = false;
+                        if (lfs & 1) {
+                            cursor = 1;
+                            state.row_start = block_offset + 1;
+                        }
+                    }
+                    else if (state.after_quote) {
+                        state.after_quote = false;
+                        if (separators & 1) {
+                            state.quoted = false;
+                            state.field_start = false;
+                        }
+                        else if (quotes & 1) {
+                            cursor = 1;
+                        }
+                    }
+
+                    uint64_t events = (quotes | crs | lfs) & ~((uint64_t(1) << cursor) - 1);
+                    while (events != 0) {
+                        const size_t pos = trailing_zeros64(events);
+                        const uint64_t bit = uint64_t(1) << pos;
+                        events &= events - 1;
+
+                        if (state.quoted) {
+                            if ((quotes & bit) == 0) {
+                                continue;
+                            }
+
+                            if (pos + 1 == block_bytes) {
+                                state.after_quote = true;
+                            }
+                            else if (separators & (bit << 1)) {
+                                state.quoted = false;
+                                state.field_start = false;
+                            }
+                            else if (quotes & (bit << 1)) {
+                                events &= ~(bit << 1);
+                                cursor = pos + 2;
+                                continue;
+                            }
+
+                            cursor = pos + 1;
+                            continue;
+                        }
+
+                        this->consume_unquoted(state, delims, cursor, pos);
+                        if (quotes & bit) {
+                            state.quoted = state.field_start;
+                            state.field_start = false;
+                            state.row_has_bytes = true;
+                            cursor = pos + 1;
+                            continue;
+                        }
+
+                        const size_t fields = state.row_has_bytes ? state.row_delimiters + 1 : 0;
+                        const bool keep_going = visit(state.row_start, block_offset + pos, fields);
+
+                        size_t next = pos + 1;
+                        if (crs & bit) {
+                            if (pos + 1 == block_bytes) {
+                                state.pending_cr = true;
+                            }
+                            else if (lfs & (bit << 1)) {
+                                events &= ~(bit << 1);
+                                next = pos + 2;
+                            }
+                        }
+
+                        state.row_has_bytes = false;
+                        state.row_delimiters = 0;
+                        state.field_start = true;
+                        state.row_start = block_offset + next;
+                        cursor = next;
+
+                        if (!keep_going) {
+                            return (std::min)(block_pos + next, data.size());
+                        }
+                    }
+
+                    if (!state.quoted) {
+                        this->consume_unquoted(state, delims, cursor, block_bytes);
+                    }
+                }
+
+                return data.size();
+            }
+
+        private:
+            /** Account for the unquoted bytes in [begin, end) of a block, which hold no quotes or line endings. */
+            static void consume_unquoted(RowCountState& state, uint64_t delims, size_t begin, size_t end) noexcept {
+                if (begin >= end) {
+                    return;
+                }
+
+                const uint64_t below_end = end == STRUCTURAL_BLOCK_SIZE ? ~uint64_t(0) : (uint64_t(1) << end) - 1;
+                const uint64_t span = below_end & ~((uint64_t(1) << begin) - 1);
+                state.row_delimiters += popcount64(delims & span);
+                state.row_has_bytes = true;
+                state.field_start = ((delims >> (end - 1)) & 1) != 0;
+            }
+
+            SentinelVecs sentinels_;
+            bool quoting_;
+        };
+
+        /** Decides which records a CSVReader would return under a VariableColumnPolicy. */
+        struct RowCountPolicy {
+            VariableColumnPolicy policy = VariableColumnPolicy::IGNORE_ROW;
+            size_t n_cols = 0;
+
+            bool accepts(size_t fields) const noexcept {
+                switch (this->policy) {
+                case VariableColumnPolicy::KEEP:
+                    return true;
+                case VariableColumnPolicy::KEEP_NON_EMPTY:
+                    return fields > 0;
+                default:
+                    return fields == this->n_cols;
+                }
+            }
+        };
+
+        /** A record rejected under VariableColumnPolicy::THROW. */
+        struct RowCountMismatch {
+            bool found = false;
+            size_t start = 0;
+            size_t end = 0;
+            size_t fields = 0;
+        };
+
+        /** Counts of one chunk of a row count, parsed from an assumed start state. */
+        struct RowCountChunk {
+            size_t offset = 0;
+            csv::string_view bytes;
+            RowCountState start_state;
+
+            /** When the chunk starts inside a record, how that record ends in it. */
+            bool first_row_ends = false;
+            size_t first_row_delimiters = 0;
+            size_t first_row_end = 0;
+
+            size_t rows = 0;
+            size_t max_fields = 0;
+            std::vector<size_t> row_offsets;
+            std::vector<size_t> row_offset_rows;
+            RowCountMismatch mismatch;
+            RowCountState end_state;
+        };
+
+        inline void tally_row(
+            RowCountChunk& chunk,
+            const RowCountPolicy& policy,
+            size_t offset_stride,
+            size_t start,
+            size_t end,
+            size_t fields
+        ) {
+            chunk.max_fields = (std::max)(chunk.max_fields, fields);
+            if (policy.accepts(fields)) {
+                if (offset_stride > 0 && chunk.rows % offset_stride == 0) {
+                    chunk.row_offsets.push_back(start);
+                    if (offset_stride > 1) {
+                        chunk.row_offset_rows.push_back(chunk.rows);
+                    }
+                }
+                chunk.rows++;
+            }
+            else if (policy.policy == VariableColumnPolicy::THROW && !chunk.mismatch.found) {
+                chunk.mismatch.found = true;
+                chunk.mismatch.start = start;
+                chunk.mismatch.end = end;
+                chunk.mismatch.fields = fields;
+            }
+        }
+
+        /** Start state of a chunk that begins right after a line feed. */
+        inline RowCountState row_count_start_state(bool quoted, size_t offset) noexcept {
+            RowCountState state;
+            state.quoted = quoted;
+            state.field_start = !quoted;
+            state.row_has_bytes = quoted;
+            state.row_start = offset;
+            return state;
+        }
+
+        /** Count `chunk` from its start state. A record that began before the
+         *  chunk is reported through the first_row_* fields instead of counted.
+         */
+        inline void count_row_chunk(
+            const RowCountScanner& scanner,
+            RowCountChunk& chunk,
+            const RowCountPolicy& policy,
+            size_t offset_stride
+        ) {
+            const RowCountState start_state = chunk.start_state;
+            chunk.first_row_ends = false;
+            chunk.rows = 0;
+            chunk.max_fields = 0;
+            chunk.row_offsets.clear();
+            chunk.row_offset_rows.clear();
+            chunk.mismatch = RowCountMismatch();
+
+            bool continuing = start_state.row_has_bytes;
+            auto visit = [&](size_t start, size_t end, size_t fields) {
+                if (continuing) {
+                    continuing = false;
+                    chunk.first_row_ends = true;
+                    chunk.first_row_delimiters = fields - 1;
+                    chunk.first_row_end = end;
+                }
+                else {
+                    tally_row(chunk, policy, offset_stride, start, end, fields);
+                }
+                return true;
+            };
+
+            chunk.end_state = start_state;
+            scanner.scan(chunk.bytes, chunk.offset, chunk.end_state, visit);
+        }
+
+        /** Split `data` into chunks of about `chunk_size` bytes that each start right after a line feed. */
+        inline std::vector<RowCountChunk> make_row_count_chunks(
+            csv::string_view data,
+            size_t base_offset,
+            size_t chunk_size
+        ) {
+            std::vector<RowCountChunk> chunks;
+            size_t begin = 0;
+            while (begin < data.size()) {
+                size_t end = data.size();
+                if (data.size() - begin > chunk_size) {
+                    const void* lf = std::memchr(data.data() + begin + chunk_size, '\n', data.size() - begin - chunk_size);
+                    if (lf != nullptr) {
+                        end = static_cast<size_t>(static_cast<const char*>(lf) - data.data()) + 1;
+                    }
+                }
+
+                RowCountChunk chunk;
+                chunk.offset = base_offset + begin;
+                chunk.bytes = data.substr(begin, end - begin);
+                chunks.push_back(std::move(chunk));
+                begin = end;
+            }
+
+            return chunks;
+        }
+
+        /** The records a CSVReader skips as headers, found by scan_header_rows(). */
+        struct RowCountHeader {
+            /** Where the first row after the header starts. */
+            size_t body_start = 0;
+
+            /** Fields in the header row itself. */
+            size_t fields = 0;
+            size_t max_fields = 0;
+
+            /** False when the data ends before the header row does. */
+            bool complete = true;
+
+            /** Scanner state at body_start. */
+            RowCountState state;
+        };
+
+        /** Skip a UTF-8 BOM and every record up to and including row `header`, if it is not negative. */
+        inline RowCountHeader scan_header_rows(const RowCountScanner& scanner, csv::string_view data, int header) {
+            RowCountHeader result;
+
+            // A skipped BOM still belongs to the first record, as in CSVRow::byte_offset().
+            bool utf8_bom = false;
+            size_t pos = get_bom_skip_or_throw(data, utf8_bom);
+            result.state.row_start = 0;
+            if (header >= 0) {
+                const size_t header_records = static_cast<size_t>(header) + 1;
+                size_t seen = 0;
+                auto skip = [&](size_t, size_t, size_t fields) {
+                    result.max_fields = (std::max)(result.max_fields, fields);
+                    if (seen + 1 == header_records) {
+                        result.fields = fields;
+                    }
+                    return ++seen < header_records;
+                };
+
+                pos += scanner.scan(data.substr(pos), pos, result.state, skip);
+                if (seen < header_records) {
+                    // The header is the unterminated last record, or missing.
+                    if (result.state.row_has_bytes && seen + 1 == header_records) {
+                        result.fields = result.state.row_delimiters + 1;
+                        result.max_fields = (std::max)(result.max_fields, result.fields);
+                    }
+                    result.complete = false;
+                    result.body_start = data.size();
+                    return result;
+                }
+
+                // Settle a CR that ended the header at a block edge.
+                if (result.state.pending_cr) {
+                    result.state.pending_cr = false;
+                    if (pos < data.size() && data[pos] == '\n') {
+                        pos++;
+                        result.state.row_start = pos;
+                    }
+                }
+            }
+
+            result.body_start = pos;
+            return result;
+        }
+
+        /** Count the rows of `data` that a CSVReader with `source_format` would return.
+         *
+         *  Records are found by RowCountScanner. Large inputs are split into
+         *  chunks at line feeds and counted in parallel; as in speculative
+         *  parsing, each chunk after the first guesses from its prefix whether
+         *  that line feed was inside quotes. Stitching the chunks in order
+         *  checks every guess, and a chunk that guessed wrong is counted again
+         *  from its true start state.
+         *
+         *  A nonzero `offset_stride` also records row offsets: every row's when
+         *  it is 1, otherwise every `offset_stride`-th row of each chunk.
+         */
+        inline CSVRowCount count_rows_in(
+            csv::string_view data,
+            const CSVFormat& source_format,
+            size_t offset_stride
+        ) {
+            const ResolvedFormat resolved = CSVParserDriverBase::resolve_format(data.substr(0, 500000), source_format);
+            const CSVFormat& format = resolved.format;
+            const char delimiter = format.get_delim();
+            const bool quoting = format.is_quoting_enabled();
+            const RowCountScanner scanner(delimiter, format.get_quote_char(), quoting);
+
+            CSVRowCount result;
+            result.format = format;
+
+            const RowCountHeader header = scan_header_rows(scanner, data, format.get_header());
+            result.max_fields = header.max_fields;
+            if (!header.complete) {
+                return result;
+            }
+
+            const size_t pos = header.body_start;
+            const RowCountState state = header.state;
+            const size_t header_fields = header.fields;
+
+            RowCountPolicy policy;
+            policy.policy = format.get_variable_column_policy();
+            policy.n_cols = !format.get_col_names().empty()
+                ? format.get_col_names().size()
+                : format.get_header() >= 0 ? header_fields : resolved.n_cols;
+            result.n_cols = policy.n_cols;
+
+            const csv::string_view body = data.substr(pos);
+            size_t worker_count = 1;
+            size_t chunk_size = body.size();
+#if CSV_ENABLE_THREADS
+            std::shared_ptr<parallel::WorkStealingPool> pool;
+            if (format.is_threading_enabled() && body.size() >= format.get_speculative_parallel_min_bytes()) {
+                std::shared_ptr<ParseExecutor> executor = format.get_parse_executor();
+                if (!executor) {
+                    executor = ParseExecutor::global();
+                }
+
+                worker_count = format.get_speculative_parallel_threads();
+                if (executor) {
+                    const size_t shared_workers = executor->worker_count();
+                    worker_count = worker_count == 0 ? shared_workers : (std::min)(worker_count, shared_workers);
+                }
+                else if (worker_count == 0) {
+                    const unsigned int hardware_threads = std::thread::hardware_concurrency();
+                    worker_count = hardware_threads == 0 ? 2 : static_cast<size_t>(hardware_threads);
+                }
+
+                if (worker_count > 1) {
+                    pool = executor
+                        ? executor->pool()
+                        : std::make_shared<parallel::WorkStealingPool>(worker_count, format.get_parse_worker_cpus());
+
+                    // At least one chunk per worker, each long enough to speculate on.
+                    chunk_size = (std::min)(format.get_chunk_size(), body.size() / worker_count + 1);
+                    chunk_size = (std::max)(chunk_size, speculative::CSV_SPECULATIVE_PREFIX_SIZE);
+                }
+                else {
+                    worker_count = 1;
+                }
+            }
+#endif
+            result.parse_worker_count = worker_count;
+
+            std::vector<RowCountChunk> chunks = make_row_count_chunks(body, pos, (std::max)(chunk_size, size_t(1)));
+            if (!chunks.empty()) {
+                chunks.front().start_state = state;
+            }
+
+#if CSV_ENABLE_THREADS
+            std::vector<speculative::ChunkSpeculation> speculations(chunks.size());
+            if (pool && chunks.size() > 1) {
+                const speculative::SpeculativeScanner speculator(
+                    quoting ? make_parse_flags(delimiter, format.get_quote_char()) : make_parse_flags(delimiter)
+                );
+
+                pool->parallel_for(chunks.size(), [&](size_t, size_t i) {
+                    RowCountChunk& chunk = chunks[i];
+                    if (i > 0) {
+                        speculations[i] = speculator.speculate(i, chunk.offset, chunk.bytes);
+                        chunk.start_state = row_count_start_state(
+                            speculations[i].assumed_start_state.quote_escape,
+                            chunk.offset
+                        );
+                    }
+                    count_row_chunk(scanner, chunk, policy, offset_stride);
+                });
+
+                for (size_t i = 1; i < speculations.size(); ++i) {
+                    speculative::observe_speculation(result.speculative_diagnostics, speculations[i]);
+                }
+            }
+            else
+#endif
+            {
+                for (size_t i = 0; i < chunks.size(); ++i) {
+                    if (i > 0) {
+                        chunks[i].start_state = row_count_start_state(false, chunks[i].offset);
+                    }
+                    count_row_chunk(scanner, chunks[i], policy, offset_stride);
+                }
+            }
+
+            // Stitch the chunks in order, recounting any whose guess was wrong.
+            RowCountChunk total;
+            RowCountState carry = state;
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                RowCountChunk& chunk = chunks[i];
+                if (i > 0 && chunk.start_state.quoted != carry.quoted) {
+                    chunk.start_state = row_count_start_state(carry.quoted, chunk.offset);
+                    count_row_chunk(scanner, chunk, policy, offset_stride);
+                    result.speculative_diagnostics.validation_repairs++;
+                }
+
+                if (i > 0 && chunk.start_state.row_has_bytes) {
+                    if (chunk.first_row_ends) {
+                        tally_row(
+                            total, policy, offset_stride, carry.row_start, chunk.first_row_end,
+                            carry.row_delimiters + chunk.first_row_delimiters + 1
+                        );
+                    }
+                    else {
+                        // The whole chunk lies inside one record.
+                        chunk.end_state.row_start = carry.row_start;
+                        chunk.end_state.row_delimiters += carry.row_delimiters;
+                    }
+                }
+
+                if (offset_stride > 0) {
+                    total.row_offsets.insert(total.row_offsets.end(), chunk.row_offsets.begin(), chunk.row_offsets.end());
+                    for (size_t row : chunk.row_offset_rows) {
+                        total.row_offset_rows.push_back(total.rows + row);
+                    }
+                }
+                total.rows += chunk.rows;
+                total.max_fields = (std::max)(total.max_fields, chunk.max_fields);
+                if (!total.mismatch.found) {
+                    total.mismatch = chunk.mismatch;
+                }
+
+                carry = chunk.end_state;
+            }
+
+            // Like CSVParserCore::end_feed(), keep a last record without a line ending.
+            if (carry.row_has_bytes) {
+                tally_row(total, policy, offset_stride, carry.row_start, data.size(), carry.row_delimiters + 1);
+            }
+
+            if (total.mismatch.found) {
+                const csv::string_view raw_row = data.substr(total.mismatch.start, total.mismatch.end - total.mismatch.start);
+                if (total.mismatch.fields < policy.n_cols) {
+                    throw_line_too_short(raw_row);
+                }
+
+                throw_line_too_long(raw_row);
+            }
+
+            result.n_rows = total.rows;
+            result.max_fields = (std::max)(result.max_fields, total.max_fields);
+            result.row_offsets = std::move(total.row_offsets);
+            result.row_offset_rows = std::move(total.row_offset_rows);
+            return result;
+        }
+        }
+    }
+}
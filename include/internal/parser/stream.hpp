@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstring>
+
+#include "../memory/stream_buffer_pool.hpp"
 #include "driver.hpp"
 #include "orchestrator.hpp"
 
@@ -15,9 +18,16 @@ namespace csv {
          *  parse() returns the byte offset of the start of the last incomplete
          *  row in the current chunk (the "remainder"). Rather than seeking back
          *  to re-read those bytes (which requires a seekable stream), they are
-         *  saved in `leftover_` and prepended to the next chunk. This is
-         *  semantically identical to the old seek-back approach but works on
-         *  any istream and avoids the syscall overhead of seekg().
+         *  left in place and the next chunk is read directly behind them, so
+         *  the next chunk starts with the remainder without copying it. This
+         *  works on any istream and avoids the syscall overhead of seekg().
+         *
+         *  @par Chunk storage
+         *  Chunks are read straight into pooled memory::StreamBuffer storage.
+         *  Each buffer is sized for the current chunk plus one window of
+         *  headroom, so consecutive chunks share a buffer and the remainder is
+         *  only copied when a chunk has to move to a fresh buffer. Buffers go
+         *  back to the pool once the last row referencing them is destroyed.
          *
          *  @par Format resolution
          *  The constructor reads a head buffer from the stream via get_csv_head()
@@ -27,8 +37,6 @@ namespace csv {
          */
         template<typename TStream>
         class StreamParser : public CSVParserDriverBase {
-            using RowCollection = ThreadSafeDeque<CSVRow>;
-
         public:
             StreamParser(
                 TStream& source,
@@ -75,28 +83,26 @@ namespace csv {
             void next(size_t bytes = CSV_CHUNK_SIZE_DEFAULT) override {
                 if (this->eof()) return;
 
-                auto chunk_owner = std::make_shared<std::string>();
-                auto& chunk = *chunk_owner;
-
-                // Prepend leftover bytes from the previous chunk's incomplete
-                // trailing row, then read enough bytes to fill the orchestrator
-                // window. The window grows to chunk_size * worker_count only
-                // when speculative parsing is active.
-                chunk = std::move(leftover_);
+                // Read enough bytes after the pending tail to fill the
+                // orchestrator window. The window grows to
+                // chunk_size * worker_count only when speculative parsing is
+                // active.
+                const size_t tail_size = this->pending_tail_size();
                 const size_t requested_window_size = this->parse_orchestrator_->read_window_size(bytes);
                 const size_t stream_window_cap = bytes > CSV_STREAM_WINDOW_SIZE_MAX
                     ? bytes
                     : CSV_STREAM_WINDOW_SIZE_MAX;
                 const size_t window_size = std::min(requested_window_size, stream_window_cap);
-                const size_t read_size = chunk.size() < window_size
-                    ? window_size - chunk.size()
+                const size_t read_size = tail_size < window_size
+                    ? window_size - tail_size
                     : bytes;
-                std::unique_ptr<char[]> buf(new char[read_size]);
-                source_.read(buf.get(), (std::streamsize)read_size);
 
-                const size_t n = static_cast<size_t>(source_.gcount());
+                this->reserve_read_space(tail_size, read_size, window_size);
+                char* read_begin = this->buffer_->data() + this->buffer_end_;
+                source_.read(read_begin, (std::streamsize)read_size);
 
-                if (n > 0) chunk.append(buf.get(), n);
+                const size_t n = static_cast<size_t>(source_.gcount());
+                this->buffer_end_ += n;
 
                 // Check for real I/O errors only (bad bit indicates unrecoverable error).
                 // failbit alone is not fatal - it's set on EOF or when requesting bytes
@@ -105,10 +111,14 @@ namespace csv {
                     throw_stream_read_failure();
                 }
 
+                const csv::string_view chunk(
+                    this->buffer_->data() + this->tail_begin_,
+                    this->buffer_end_ - this->tail_begin_
+                );
                 const bool source_exhausted = source_.eof() || chunk.empty();
                 const CSVParseWindowResult result = this->parse_orchestrator_->parse_window(
                     chunk,
-                    chunk_owner,
+                    this->buffer_,
                     this->stream_pos_,
                     bytes,
                     source_exhausted,
@@ -117,11 +127,12 @@ namespace csv {
 
                 if (source_exhausted) {
                     this->eof_ = true;
+                    this->buffer_.reset();
                 }
                 else {
-                    // Save the tail bytes that begin an incomplete row so they
-                    // are prepended to the next chunk (see class-level comment).
-                    leftover_ = chunk.substr(result.complete_prefix_length);
+                    // The incomplete trailing row stays where it is; the next
+                    // read appends directly behind it (see class-level comment).
+                    this->tail_begin_ += result.complete_prefix_length;
                     this->stream_pos_ += result.complete_prefix_length;
                 }
             }
@@ -146,9 +157,52 @@ namespace csv {
             }
 
         private:
-            // Bytes from the previous chunk that form the start of an incomplete
-            // row, plus the initial head buffer on the first call.
+            size_t pending_tail_size() const noexcept {
+                return this->buffer_
+                    ? this->buffer_end_ - this->tail_begin_
+                    : this->leftover_.size();
+            }
+
+            /** Make room for `read_size` bytes directly behind the pending tail.
+             *
+             *  Reads go straight into the current buffer while it has headroom.
+             *  Otherwise a buffer with room for this chunk plus one more window
+             *  is taken from the pool and only the tail is copied into it.
+             */
+            void reserve_read_space(size_t tail_size, size_t read_size, size_t window_size) {
+                if (this->buffer_ && this->buffer_->capacity() - this->buffer_end_ >= read_size) {
+                    return;
+                }
+
+                std::shared_ptr<memory::StreamBuffer> next_buffer = this->buffer_pool_->acquire(
+                    tail_size + read_size + window_size
+                );
+
+                const char* tail = this->buffer_
+                    ? this->buffer_->data() + this->tail_begin_
+                    : this->leftover_.data();
+                if (tail_size > 0) {
+                    std::memcpy(next_buffer->data(), tail, tail_size);
+                }
+
+                // The head buffer is only needed until it has been copied once.
+                std::string().swap(this->leftover_);
+                this->buffer_ = std::move(next_buffer);
+                this->tail_begin_ = 0;
+                this->buffer_end_ = tail_size;
+            }
+
+            // Initial head buffer read by get_csv_head(), consumed by the first next().
             std::string leftover_;
+
+            // Chunk storage: [tail_begin_, buffer_end_) is the incomplete row
+            // carried over from the previous chunk. Earlier bytes may still be
+            // referenced by rows and are never overwritten.
+            std::shared_ptr<memory::StreamBufferPool> buffer_pool_ =
+                std::make_shared<memory::StreamBufferPool>();
+            std::shared_ptr<memory::StreamBuffer> buffer_;
+            size_t tail_begin_ = 0;
+            size_t buffer_end_ = 0;
             size_t stream_pos_ = 0;
 
             TStream& source_;
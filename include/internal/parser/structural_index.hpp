@@ -0,0 +1,122 @@
+/** @file
+ *  @brief Block classifier for the structural-index parser engine.
+ *
+ *  Turns 64-byte blocks into bitmaps of field and row terminators that lie
+ *  outside quoted regions. In-quote regions come from a prefix-XOR of the
+ *  quote bitmap, carried across blocks.
+ *
+ *  The prefix-XOR model assumes every quote toggles quoting, which matches the
+ *  DFA only for RFC 4180 placement: an opening quote directly after a field
+ *  boundary, a closing quote directly before one, and doubled quotes inside.
+ *  Blocks with any other quote placement are rejected so CSVParserCore can
+ *  hand them to the DFA, which owns the non-strict quoting semantics.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "../basic_csv_parser_simd.hpp"
+
+namespace csv {
+    namespace internals {
+        namespace parser {
+        /** Bitmaps for one classified block; bit i describes block[i]. */
+        struct StructuralBlock {
+            /** Quote bytes (always zero when quoting is disabled). */
+            uint64_t quotes = 0;
+
+            /** Delimiters outside quoted regions. */
+            uint64_t field_ends = 0;
+
+            /** CR, or LF not preceded by CR, outside quoted regions. */
+            uint64_t row_ends = 0;
+        };
+
+        /** Classifies consecutive 64-byte blocks, carrying quote state between them.
+         *
+         *  The first block must start at a field boundary outside quotes.
+         */
+        class StructuralIndexer {
+        public:
+            explicit StructuralIndexer(const SentinelVecs& sentinels) noexcept
+                : sentinels_(sentinels),
+                  quote_char_(sentinels.v_quote[0]),
+                  delimiter_(sentinels.v_delim[0]),
+                  // no_quote mode aliases the quote sentinel to the delimiter.
+                  quoting_(sentinels.v_quote[0] != sentinels.v_delim[0]) {}
+
+            /** Restart at a field boundary outside quotes. */
+            void reset() noexcept {
+                this->in_quote_ = 0;
+                this->prev_separator_ = 1;
+                this->prev_close_ = 0;
+                this->prev_cr_ = 0;
+            }
+
+            /** Classify STRUCTURAL_BLOCK_SIZE bytes at `block`; `next` is the byte after them.
+             *
+             *  Returns false, leaving the carried state untouched, when the block
+             *  contains quote placement the prefix-XOR model cannot represent.
+             */
+            bool classify(const char* block, char next, StructuralBlock& out) noexcept {
+                StructuralBlockMasks masks;
+                find_structural_masks(block, this->sentinels_, masks);
+
+                const uint64_t separators = masks.delim | masks.lf | masks.cr;
+                uint64_t quotes = 0;
+                uint64_t inside = 0;
+                uint64_t closes = 0;
+                if (this->quoting_) {
+                    quotes = masks.quote;
+                    inside = masks.quote_prefix ^ this->in_quote_;
+                    closes = quotes & ~inside;
+
+                    if (quotes != 0) {
+                        const uint64_t opens = quotes & inside;
+                        const uint64_t next_is_separator = (next == this->delimiter_ || next == '\n' || next == '\r') ? 1 : 0;
+                        const uint64_t next_is_quote = next == this->quote_char_ ? 1 : 0;
+
+                        // Opening quotes must start a field or follow a closing quote
+                        // (the second half of an escaped pair). Closing quotes must end
+                        // a field or precede another quote.
+                        const uint64_t after_boundary = (separators << 1) | this->prev_separator_;
+                        const uint64_t after_close = (closes << 1) | this->prev_close_;
+                        const uint64_t before_boundary = (separators >> 1) | (next_is_separator << 63);
+                        const uint64_t before_quote = (quotes >> 1) | (next_is_quote << 63);
+
+                        if (((opens & ~(after_boundary | after_close))
+                            | (closes & ~(before_boundary | before_quote))) != 0) {
+                            return false;
+                        }
+                    }
+                }
+
+                const uint64_t outside = ~inside;
+                const uint64_t lf_after_cr = masks.lf & ((masks.cr << 1) | this->prev_cr_);
+
+                out.quotes = quotes;
+                out.field_ends = masks.delim & outside;
+                out.row_ends = (masks.cr | (masks.lf & ~lf_after_cr)) & outside;
+
+                this->in_quote_ = (inside >> 63) != 0 ? ~uint64_t(0) : 0;
+                this->prev_separator_ = separators >> 63;
+                this->prev_close_ = closes >> 63;
+                this->prev_cr_ = masks.cr >> 63;
+                return true;
+            }
+
+        private:
+            const SentinelVecs& sentinels_;
+            char quote_char_;
+            char delimiter_;
+            bool quoting_;
+
+            uint64_t in_quote_ = 0;
+            uint64_t prev_separator_ = 1;
+            uint64_t prev_close_ = 0;
+            uint64_t prev_cr_ = 0;
+        };
+        }
+    }
+}
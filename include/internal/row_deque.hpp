@@ -9,6 +9,7 @@
 #include <vector>
 
 #if CSV_ENABLE_THREADS
+#include "spsc_row_queue.hpp"
 #include "thread_safe_deque.hpp"
 #else
 #include "single_thread_deque.hpp"
@@ -27,6 +28,9 @@ namespace csv {
 #if !CSV_ENABLE_THREADS
     template<typename T>
     using ThreadSafeDeque = SingleThreadDeque<T>;
+
+    template<typename T>
+    using SPSCRowQueue = SingleThreadDeque<T>;
 #endif
 
 #ifdef CSV_HAS_CXX20
@@ -46,11 +50,15 @@ namespace csv {
             { q.wait() } -> std::same_as<void>;
             { q.notify_all() } -> std::same_as<void>;
             { q.kill_all() } -> std::same_as<void>;
+            { q.wait_for_capacity(n) } -> std::same_as<bool>;
+            { q.interrupt_producer() } -> std::same_as<void>;
             { cq.size() } -> std::same_as<size_t>;
+            { cq.pushed_count() } -> std::same_as<size_t>;
         };
 
 #if CSV_ENABLE_THREADS
             static_assert(RowDequeLike<ThreadSafeDeque<int>, int>, "ThreadSafeDeque must satisfy RowDequeLike contract");
+            static_assert(RowDequeLike<SPSCRowQueue<int>, int>, "SPSCRowQueue must satisfy RowDequeLike contract");
 #else
             static_assert(RowDequeLike<SingleThreadDeque<int>, int>, "SingleThreadDeque must satisfy RowDequeLike contract");
             static_assert(RowDequeLike<ThreadSafeDeque<int>, int>, "Selected ThreadSafeDeque alias must satisfy RowDequeLike contract");
@@ -27,12 +27,14 @@ namespace csv {
 
             SingleThreadDeque(const SingleThreadDeque& other) {
                 this->records_ = other.records_;
+                this->pushed_ = other.pushed_;
                 this->_is_empty = other._is_empty;
                 this->_is_waitable = other._is_waitable;
             }
 
             SingleThreadDeque(const std::deque<T>& source)
                 : _is_empty(source.empty()),
+                  pushed_(source.size()),
                   records_(source) {}
 
             bool empty() const noexcept {
@@ -41,6 +43,7 @@ namespace csv {
 
             void push_back(T&& item) {
                 this->records_.push_back(std::move(item));
+                this->pushed_++;
                 this->_is_empty = false;
             }
 
@@ -49,6 +52,7 @@ namespace csv {
                     return;
                 }
 
+                this->pushed_ += rows.size();
                 this->records_.insert(
                     this->records_.end(),
                     std::make_move_iterator(rows.begin()),
@@ -68,6 +72,10 @@ namespace csv {
                 return item;
             }
 
+            const T* peek_front() noexcept {
+                return this->records_.empty() ? nullptr : &this->records_.front();
+            }
+
             /** Move up to @p max_items rows into a caller-owned batch buffer. */
             size_t drain_front(std::vector<T>& out, size_t max_items) {
                 const size_t drain_count = this->records_.size() < max_items ? this->records_.size() : max_items;
@@ -93,10 +101,32 @@ namespace csv {
                 // No-op in single-thread mode.
             }
 
+            /** There is no concurrent consumer to make room, so never block. */
+            bool wait_for_capacity(size_t max_size) {
+                (void)max_size;
+                return false;
+            }
+
+            void interrupt_producer() {
+                // No-op in single-thread mode.
+            }
+
+            bool producer_interrupted() const noexcept {
+                return false;
+            }
+
             size_t size() const noexcept {
                 return this->records_.size();
             }
 
+            size_t pushed_count() const noexcept {
+                return this->pushed_;
+            }
+
+            size_t popped_count() const noexcept {
+                return this->pushed_ - this->records_.size();
+            }
+
             void notify_all() {
                 this->_is_waitable = true;
             }
@@ -108,6 +138,7 @@ namespace csv {
         private:
             bool _is_empty = true;
             bool _is_waitable = false;
+            size_t pushed_ = 0;
             std::deque<T> records_;
         };
     }
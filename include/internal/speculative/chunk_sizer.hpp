@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "diagnostics.hpp"
+
+namespace csv {
+    namespace internals {
+        namespace speculative {
+        /** Halvings an adaptive chunk size may go below the configured one. */
+        constexpr size_t CSV_ADAPTIVE_CHUNK_MAX_SHRINK = 4;
+
+        /** Average rows an adaptive chunk must still span. */
+        constexpr size_t CSV_ADAPTIVE_CHUNK_MIN_ROWS = 8;
+
+        /** Consecutive mostly-repaired windows before speculation is suspended. */
+        constexpr size_t CSV_ADAPTIVE_FAILED_WINDOWS_MAX = 3;
+
+        /** Bounds on how many windows a suspension parses serially. */
+        constexpr size_t CSV_ADAPTIVE_SERIAL_WINDOWS_MIN = 4;
+        constexpr size_t CSV_ADAPTIVE_SERIAL_WINDOWS_MAX = 64;
+
+        /** Choose the speculative chunk size of each window from how the previous windows went.
+         *
+         *  Windows whose chunks needed repairs or had ambiguous prefixes halve the
+         *  chunk size, so a mis-speculation costs less to reparse and the work
+         *  spreads over more tasks. Clean windows double it again, up to the
+         *  configured chunk size, to cut per-chunk overhead. Chunks never drop
+         *  below `min_chunk_size`, nor below CSV_ADAPTIVE_CHUNK_MIN_ROWS rows of
+         *  average length, so each still holds record boundaries.
+         *
+         *  When most chunks need repairs for CSV_ADAPTIVE_FAILED_WINDOWS_MAX
+         *  windows in a row, speculation is suspended and the following windows
+         *  are parsed serially. Each suspension that is followed by another
+         *  failed window lasts twice as long as the one before.
+         */
+        class AdaptiveChunkSizer {
+        public:
+            explicit AdaptiveChunkSizer(size_t min_chunk_size) noexcept
+                : min_chunk_size_(min_chunk_size) {}
+
+            /** Chunk size for the next speculative window, given the configured one. */
+            size_t chunk_size(size_t max_chunk_size) const noexcept {
+                size_t floor = (std::max)(this->min_chunk_size_, CSV_ADAPTIVE_CHUNK_MIN_ROWS * this->average_row_bytes_);
+                floor = (std::min)(floor, max_chunk_size);
+                return (std::max)(max_chunk_size >> this->shrink_, floor);
+            }
+
+            /** Whether the next window should skip speculation. */
+            bool serial() const noexcept {
+                return this->serial_windows_left_ > 0;
+            }
+
+            /** Record one speculatively parsed window. */
+            void observe_window(
+                const SpeculativeParseDiagnostics& window,
+                size_t bytes,
+                size_t rows
+            ) noexcept {
+                this->observe_rows(bytes, rows);
+                if (window.chunks == 0) {
+                    return;
+                }
+
+                const bool unsettled = window.validation_repairs > 0
+                    || 4 * window.ambiguous_chunks >= window.chunks;
+                if (unsettled) {
+                    this->shrink_ = (std::min)(this->shrink_ + 1, CSV_ADAPTIVE_CHUNK_MAX_SHRINK);
+                }
+                else if (this->shrink_ > 0) {
+                    this->shrink_--;
+                }
+
+                // A window's first chunk usually starts at a known boundary.
+                const size_t speculated = window.chunks > 1 ? window.chunks - 1 : 1;
+                if (2 * window.validation_repairs < speculated) {
+                    this->failed_windows_ = 0;
+                    if (!unsettled) {
+                        this->serial_windows_ = CSV_ADAPTIVE_SERIAL_WINDOWS_MIN;
+                    }
+                    return;
+                }
+
+                if (++this->failed_windows_ >= CSV_ADAPTIVE_FAILED_WINDOWS_MAX) {
+                    this->serial_windows_left_ = this->serial_windows_;
+                    this->serial_windows_ = (std::min)(2 * this->serial_windows_, CSV_ADAPTIVE_SERIAL_WINDOWS_MAX);
+
+                    // One more failed window after the pause suspends it again.
+                    this->failed_windows_ = CSV_ADAPTIVE_FAILED_WINDOWS_MAX - 1;
+                }
+            }
+
+            /** Record one window parsed serially while speculation was suspended. */
+            void observe_serial_window(size_t bytes, size_t rows) noexcept {
+                this->observe_rows(bytes, rows);
+                if (this->serial_windows_left_ > 0) {
+                    this->serial_windows_left_--;
+                }
+            }
+
+        private:
+            void observe_rows(size_t bytes, size_t rows) noexcept {
+                if (rows == 0) {
+                    return;
+                }
+
+                // Weighted toward recent windows so the floor follows the file.
+                const size_t window_average = bytes / rows;
+                this->average_row_bytes_ = this->average_row_bytes_ == 0
+                    ? window_average
+                    : (this->average_row_bytes_ + window_average) / 2;
+            }
+
+            size_t min_chunk_size_;
+            size_t shrink_ = 0;
+            size_t average_row_bytes_ = 0;
+            size_t failed_windows_ = 0;
+            size_t serial_windows_ = CSV_ADAPTIVE_SERIAL_WINDOWS_MIN;
+            size_t serial_windows_left_ = 0;
+        };
+        }
+    }
+}
@@ -88,6 +88,9 @@ namespace csv {
             CSVRowFragment prefix_fragment;
             std::vector<CSVRow> complete_rows;
             CSVRowFragment suffix_fragment;
+
+            /** Reparsed from a start state other than the speculated one. */
+            bool repaired = false;
         };
 
         inline ParsedChunkRows split_parsed_chunk_rows(
@@ -184,7 +187,7 @@ namespace csv {
                 ParserChunkOptions(corrected_initial_state, chunk.scan_bom, chunk.offset)
             );
 
-            return split_parsed_chunk_rows(
+            ParsedChunkRows repaired = split_parsed_chunk_rows(
                 chunk.sequence_number,
                 chunk.chunk,
                 chunk.owner,
@@ -193,6 +196,8 @@ namespace csv {
                 chunk.starts_at_record_boundary,
                 chunk.offset
             );
+            repaired.repaired = true;
+            return repaired;
         }
 
         /** Minimal parser shell for caller-owned chunks.
@@ -200,17 +205,19 @@ namespace csv {
          *  The SIGMOD-style speculative path treats input sourcing as an
          *  external concern. This parser core only needs delimiter/whitespace state.
          */
-        template<bool EagerClassify = false>
+        template<bool EagerClassify = false, typename Dialect = RuntimeDialect>
         class ChunkParserCoreT : public CSVParserCore<
             std::vector<CSVRow>,
             PermissiveParsePolicy,
             CSVRowFieldPolicy<EagerClassify>,
-            CSVRowRowPolicy> {
+            CSVRowRowPolicy,
+            Dialect> {
             using Base = CSVParserCore<
                 std::vector<CSVRow>,
                 PermissiveParsePolicy,
                 CSVRowFieldPolicy<EagerClassify>,
-                CSVRowRowPolicy>;
+                CSVRowRowPolicy,
+                Dialect>;
 
         public:
             ChunkParserCoreT(
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 namespace csv {
     namespace internals {
@@ -14,6 +15,15 @@ namespace csv {
             size_t assumed_unquoted_chunks = 0;
             size_t validation_repairs = 0;
 
+            /** Repairs run on the worker pool before validation reached the chunk. */
+            size_t parallel_repairs = 0;
+
+            /** Wall time spent reparsing mis-speculated chunks. */
+            std::uint64_t repair_nanoseconds = 0;
+
+            /** Windows parsed serially while adaptive chunking suspended speculation. */
+            size_t serial_fallback_windows = 0;
+
             void merge(const SpeculativeParseDiagnostics& other) noexcept {
                 this->chunks += other.chunks;
                 this->ambiguous_chunks += other.ambiguous_chunks;
@@ -22,6 +32,9 @@ namespace csv {
                 this->assumed_quoted_chunks += other.assumed_quoted_chunks;
                 this->assumed_unquoted_chunks += other.assumed_unquoted_chunks;
                 this->validation_repairs += other.validation_repairs;
+                this->parallel_repairs += other.parallel_repairs;
+                this->repair_nanoseconds += other.repair_nanoseconds;
+                this->serial_fallback_windows += other.serial_fallback_windows;
             }
         };
         }
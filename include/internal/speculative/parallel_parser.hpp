@@ -1,6 +1,9 @@
 #pragma once
 
-#include "../parallel/indexed_task_pool.hpp"
+#include <chrono>
+#include <cstdint>
+
+#include "../parallel/work_stealing_pool.hpp"
 #include "scanner.hpp"
 #include "validator.hpp"
 
@@ -15,10 +18,28 @@ namespace csv {
             csv::string_view bytes;
             std::shared_ptr<void> owner;
             ChunkSpeculation speculation;
+
+            /** When set, the worker parsing this chunk speculates its start state
+             *  with this scanner and `speculation` is ignored.
+             */
+            const SpeculativeScanner* scanner = nullptr;
             bool starts_at_record_boundary = false;
             bool scan_bom = false;
         };
 
+        /** Return the speculation a chunk is parsed with, running the scanner if deferred. */
+        inline ChunkSpeculation resolve_speculation(const SpeculativeParseChunk& chunk) {
+            if (chunk.scanner == nullptr) {
+                return chunk.speculation;
+            }
+
+            ChunkSpeculation speculation = chunk.scanner->speculate(chunk.sequence_number, chunk.offset, chunk.bytes);
+            if (chunk.starts_at_record_boundary) {
+                speculation.assumed_start_state = ParserDFAState();
+            }
+            return speculation;
+        }
+
         struct ParallelCSVParseResult {
             size_t chunks_processed = 0;
             size_t repair_count = 0;
@@ -26,6 +47,10 @@ namespace csv {
             bool has_pending_suffix = false;
             ParserDFAState ending_state;
             SpeculativeParseDiagnostics diagnostics;
+
+            /** Pipelined mode: windows validated during this call and the rows they released. */
+            size_t windows_released = 0;
+            size_t rows_released = 0;
         };
 
         inline std::vector<SpeculativeParseChunk> make_speculative_parse_chunks(
@@ -35,7 +60,9 @@ namespace csv {
             const SpeculativeScanner& scanner,
             size_t base_offset = 0,
             size_t first_sequence_number = 0,
-            bool scan_bom_for_first_chunk = true
+            bool scan_bom_for_first_chunk = true,
+            bool first_chunk_at_record_boundary = true,
+            bool speculate_on_workers = false
         ) {
             std::vector<SpeculativeParseChunk> chunks;
             if (chunk_size == 0) {
@@ -46,20 +73,29 @@ namespace csv {
             for (size_t offset = 0; offset < data.size(); offset += chunk_size) {
                 const size_t length = std::min(chunk_size, data.size() - offset);
                 const csv::string_view bytes(data.data() + offset, length);
-                const bool first_chunk = offset == 0;
+                const bool first_chunk = offset == 0 && first_chunk_at_record_boundary;
 
                 SpeculativeParseChunk chunk;
                 chunk.sequence_number = sequence_number;
                 chunk.offset = base_offset + offset;
                 chunk.bytes = bytes;
                 chunk.owner = owner;
-                chunk.speculation = scanner.speculate(sequence_number, chunk.offset, bytes);
                 chunk.starts_at_record_boundary = first_chunk;
                 chunk.scan_bom = first_chunk && scan_bom_for_first_chunk;
 
+                // The prefix scan reads up to 64 KiB per chunk; deferring it lets
+                // the workers run it in parallel instead of the caller up front.
+                if (speculate_on_workers) {
+                    chunk.scanner = &scanner;
+                }
+                else {
+                    chunk.speculation = scanner.speculate(sequence_number, chunk.offset, bytes);
+                }
+
                 // The first chunk in a speculative window starts at a known row
                 // boundary because source windows must be aligned to incomplete-row
-                // starts before the next read.
+                // starts before the next read. Pipelined windows are contiguous
+                // instead, so their first chunk is speculated like any other.
                 if (first_chunk) {
                     chunk.speculation.assumed_start_state = ParserDFAState();
                 }
@@ -71,7 +107,7 @@ namespace csv {
             return chunks;
         }
 
-        template<bool EagerClassify = false>
+        template<bool EagerClassify = false, typename Dialect = RuntimeDialect>
         class ParallelCSVParser {
         public:
             ParallelCSVParser(
@@ -82,18 +118,49 @@ namespace csv {
             ) : parse_flags_(parse_flags),
                 ws_flags_(ws_flags),
                 col_names_(col_names),
-                task_pool_(worker_count == 0 ? 1 : worker_count) {
+                task_pool_(std::make_shared<internals::parallel::WorkStealingPool>(worker_count == 0 ? 1 : worker_count)) {
                 this->init_worker_parsers();
             }
 
-            ~ParallelCSVParser() {}
+            /** Parse on a pool shared with other parsers, e.g. a ParseExecutor's. */
+            ParallelCSVParser(
+                const ParseFlagMap& parse_flags,
+                const WhitespaceMap& ws_flags,
+                std::shared_ptr<internals::parallel::WorkStealingPool> task_pool,
+                const ColNamesPtr& col_names = nullptr
+            ) : parse_flags_(parse_flags),
+                ws_flags_(ws_flags),
+                col_names_(col_names),
+                task_pool_(std::move(task_pool)) {
+                CSV_DEBUG_ASSERT(this->task_pool_ != nullptr);
+                this->init_worker_parsers();
+            }
+
+            ~ParallelCSVParser() {
+                // Workers may still be parsing a pipelined window that references
+                // in_flight_; its result, including any exception, is discarded.
+                if (this->in_flight_) {
+                    try {
+                        this->task_pool_->wait(this->in_flight_->tasks);
+                    }
+                    catch (...) {}
+                }
+            }
 
             ParallelCSVParser(const ParallelCSVParser&) = delete;
             ParallelCSVParser& operator=(const ParallelCSVParser&) = delete;
 
+            void set_parser_engine(ParserEngine engine) {
+                this->parser_engine_ = engine;
+                for (auto& parser : this->worker_parsers_) {
+                    parser.set_parser_engine(engine);
+                }
+            }
+
             ParsedChunkRows parse_chunk(const SpeculativeParseChunk& chunk) const {
-                ChunkParserCoreT<EagerClassify> parser(this->parse_flags_, this->ws_flags_, this->col_names_);
-                return this->parse_chunk_with(parser, chunk);
+                ChunkParserCoreT<EagerClassify, Dialect> parser = this->make_chunk_parser();
+                ChunkSpeculation speculation;
+                return this->parse_chunk_with(parser, chunk, speculation);
             }
 
             template<typename RowSink>
@@ -104,22 +171,24 @@ namespace csv {
             ) {
                 ParallelCSVParseResult result;
                 result.chunks_processed = chunks.size();
-                for (size_t i = 0; i < chunks.size(); ++i) {
-                    observe_speculation(result.diagnostics, chunks[i].speculation);
-                }
 
                 std::vector<ParsedChunkRows> parsed(chunks.size());
-                this->parse_chunks_into(chunks, parsed);
+                std::vector<ChunkSpeculation> speculations(chunks.size());
+                this->parse_chunks_into(chunks, parsed, speculations);
+                for (size_t i = 0; i < speculations.size(); ++i) {
+                    observe_speculation(result.diagnostics, speculations[i]);
+                }
+                this->repair_ahead(parsed, ParserDFAState(), result.diagnostics);
 
-                ChunkParserCoreT<EagerClassify> repair_parser(this->parse_flags_, this->ws_flags_, this->col_names_);
-                SpeculativeParseValidator<RowSink, ChunkParserCoreT<EagerClassify>> validator(repair_parser, output);
+                ChunkParserCoreT<EagerClassify, Dialect> repair_parser = this->make_chunk_parser();
+                SpeculativeParseValidator<RowSink, ChunkParserCoreT<EagerClassify, Dialect>> validator(repair_parser, output);
                 for (size_t i = 0; i < parsed.size(); ++i) {
                     validator.validate_and_release(std::move(parsed[i]));
                 }
                 validator.finish(finish);
 
                 result.repair_count = validator.repair_count();
-                result.diagnostics.validation_repairs += result.repair_count;
+                this->record_repairs(validator, result.diagnostics);
                 result.has_pending_suffix = validator.has_pending_suffix();
                 result.ending_state = validator.expected_start_state();
                 if (!chunks.empty()) {
@@ -134,17 +203,235 @@ namespace csv {
                 return result;
             }
 
+            /** Parse `chunks` as the next window of a pipelined source.
+             *
+             *  Pipelined windows are contiguous: each starts where the previous one
+             *  ended, and an incomplete trailing row is carried into the next window
+             *  instead of being handed back through complete_prefix_length. Workers
+             *  keep parsing this window after the call returns while the caller
+             *  fetches the next one; the previous window is validated and released
+             *  here in the meantime. Rows therefore lag one window behind until
+             *  `finish` drains the pipeline. Ordering follows sequence_number, which
+             *  callers must keep increasing across windows.
+             */
+            template<typename RowSink>
+            ParallelCSVParseResult parse_window_pipelined(
+                std::vector<SpeculativeParseChunk> chunks,
+                RowSink& output,
+                bool finish
+            ) {
+                ParallelCSVParseResult result;
+                result.chunks_processed = chunks.size();
+
+                // Start this window before collecting the previous one, so
+                // workers that finished their part of it move straight on.
+                std::unique_ptr<PipelinedWindow> previous = std::move(this->in_flight_);
+                if (!chunks.empty()) {
+                    this->in_flight_ = this->start_window(std::move(chunks));
+                }
+
+                if (previous) {
+                    this->task_pool_->wait(previous->tasks);
+                    this->release_window(*previous, output, result, false);
+                }
+
+                if (finish) {
+                    std::unique_ptr<PipelinedWindow> current = std::move(this->in_flight_);
+                    if (current) {
+                        this->task_pool_->wait(current->tasks);
+                    }
+
+                    if (current) {
+                        this->release_window(*current, output, result, true);
+                    }
+                    else {
+                        PipelinedWindow empty;
+                        this->release_window(empty, output, result, true);
+                    }
+                }
+
+                result.has_pending_suffix = !this->pipeline_suffix_.empty();
+                result.ending_state = this->pipeline_state_;
+                return result;
+            }
+
         private:
+            struct PipelinedWindow {
+                std::vector<SpeculativeParseChunk> chunks;
+                std::vector<ParsedChunkRows> parsed;
+                std::vector<ChunkSpeculation> speculations;
+                internals::parallel::TaskGroup tasks;
+            };
+
+            std::unique_ptr<PipelinedWindow> start_window(std::vector<SpeculativeParseChunk> chunks) {
+                std::unique_ptr<PipelinedWindow> window(new PipelinedWindow());
+                window->chunks = std::move(chunks);
+                window->parsed.resize(window->chunks.size());
+                window->speculations.resize(window->chunks.size());
+
+                if (this->task_pool_->worker_count() > 1) {
+                    PipelinedWindow* target = window.get();
+                    this->spawn_chunks(target->tasks, target->chunks, [this, target](
+                        size_t worker_index,
+                        size_t task_index
+                    ) {
+                        CSV_DEBUG_ASSERT(worker_index < this->worker_parsers_.size());
+                        target->parsed[task_index] = this->parse_chunk_with(
+                            this->worker_parsers_[worker_index],
+                            target->chunks[task_index],
+                            target->speculations[task_index]
+                        );
+                    });
+                }
+                else {
+                    this->parse_chunks_into(window->chunks, window->parsed, window->speculations);
+                }
+
+                return window;
+            }
+
+            template<typename RowSink>
+            void release_window(
+                PipelinedWindow& window,
+                RowSink& output,
+                ParallelCSVParseResult& result,
+                bool final_window
+            ) {
+                for (size_t i = 0; i < window.speculations.size(); ++i) {
+                    observe_speculation(result.diagnostics, window.speculations[i]);
+                }
+                this->repair_ahead(window.parsed, this->pipeline_state_, result.diagnostics);
+
+                ChunkParserCoreT<EagerClassify, Dialect> repair_parser = this->make_chunk_parser();
+                SpeculativeParseValidator<RowSink, ChunkParserCoreT<EagerClassify, Dialect>> validator(
+                    repair_parser,
+                    output,
+                    this->pipeline_state_,
+                    std::move(this->pipeline_suffix_)
+                );
+
+                for (size_t i = 0; i < window.parsed.size(); ++i) {
+                    CSV_DEBUG_ASSERT(window.parsed[i].sequence_number >= this->next_release_sequence_);
+                    this->next_release_sequence_ = window.parsed[i].sequence_number + 1;
+                    validator.validate_and_release(std::move(window.parsed[i]));
+                }
+                validator.finish(final_window);
+
+                result.windows_released++;
+                result.rows_released += validator.released_row_count();
+                result.repair_count += validator.repair_count();
+                this->record_repairs(validator, result.diagnostics);
+
+                if (final_window) {
+                    this->pipeline_state_ = ParserDFAState();
+                    this->pipeline_suffix_ = CSVRowFragment();
+                    this->next_release_sequence_ = 0;
+                }
+                else {
+                    this->pipeline_state_ = validator.expected_start_state();
+                    this->pipeline_suffix_ = validator.pending_suffix();
+                }
+            }
+
+            /** Repair mis-speculated chunks of a window on the worker pool.
+             *
+             *  The true start state of a chunk is only known once every chunk
+             *  before it is correct, so repairs form a chain. Each round reparses
+             *  the first wrong chunk from its now-known start and, alongside it,
+             *  the next chunks from the opposite quote state in case the error
+             *  cascades. Alternatives are kept where they start from the state
+             *  the chain arrives at and are otherwise discarded, so a cascade of
+             *  up to worker_count() chunks costs one round instead of a serial
+             *  repair each. The validator still checks every chunk.
+             */
+            void repair_ahead(
+                std::vector<ParsedChunkRows>& parsed,
+                ParserDFAState initial_state,
+                SpeculativeParseDiagnostics& diagnostics
+            ) {
+                const size_t worker_count = this->task_pool_->worker_count();
+                if (worker_count <= 1) {
+                    return;
+                }
+
+                const auto repair_start = std::chrono::steady_clock::now();
+                bool repaired_any = false;
+                ParserDFAState expected = initial_state;
+                size_t i = 0;
+                while (i < parsed.size()) {
+                    if (parser_dfa_state_equal(parsed[i].parse_result.initial_state, expected)) {
+                        expected = parsed[i].parse_result.ending_state;
+                        ++i;
+                        continue;
+                    }
+
+                    const size_t round_end = (std::min)(parsed.size(), i + worker_count);
+                    std::vector<ParsedChunkRows> round(round_end - i);
+                    this->task_pool_->parallel_for(round.size(), [this, &parsed, &round, i, expected](
+                        size_t worker_index,
+                        size_t task_index
+                    ) {
+                        CSV_DEBUG_ASSERT(worker_index < this->worker_parsers_.size());
+                        const ParsedChunkRows& chunk = parsed[i + task_index];
+                        const ParserDFAState start_state = task_index == 0
+                            ? expected
+                            : ParserDFAState(!chunk.parse_result.initial_state.quote_escape);
+                        round[task_index] = repair_parsed_chunk_rows(
+                            this->worker_parsers_[worker_index],
+                            chunk,
+                            start_state
+                        );
+                        round[task_index].scan_bom = chunk.scan_bom;
+                    });
+                    repaired_any = true;
+
+                    size_t next = i;
+                    for (; next < round_end; ++next) {
+                        ParsedChunkRows& candidate = round[next - i];
+                        if (next > i && parser_dfa_state_equal(parsed[next].parse_result.initial_state, expected)) {
+                            break;
+                        }
+
+                        if (!parser_dfa_state_equal(candidate.parse_result.initial_state, expected)) {
+                            break;
+                        }
+
+                        parsed[next] = std::move(candidate);
+                        expected = parsed[next].parse_result.ending_state;
+                    }
+
+                    i = next;
+                }
+
+                if (repaired_any) {
+                    diagnostics.repair_nanoseconds += static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - repair_start
+                        ).count()
+                    );
+                }
+            }
+
+            template<typename Validator>
+            static void record_repairs(const Validator& validator, SpeculativeParseDiagnostics& diagnostics) {
+                diagnostics.validation_repairs += validator.repair_count();
+                diagnostics.parallel_repairs += validator.prepared_repair_count();
+                diagnostics.repair_nanoseconds += validator.repair_nanoseconds();
+            }
+
             ParsedChunkRows parse_chunk_with(
-                ChunkParserCoreT<EagerClassify>& parser,
-                const SpeculativeParseChunk& chunk
+                ChunkParserCoreT<EagerClassify, Dialect>& parser,
+                const SpeculativeParseChunk& chunk,
+                ChunkSpeculation& speculation
             ) const {
+                speculation = resolve_speculation(chunk);
+
                 std::vector<CSVRow> rows;
                 const ParserChunkResult parse_result = parser.parse_chunk(
                     chunk.bytes,
                     chunk.owner,
                     rows,
-                    ParserChunkOptions(chunk.speculation.assumed_start_state, chunk.scan_bom, chunk.offset)
+                    ParserChunkOptions(speculation.assumed_start_state, chunk.scan_bom, chunk.offset)
                 );
 
                 ParsedChunkRows result = split_parsed_chunk_rows(
@@ -162,54 +449,101 @@ namespace csv {
 
             void parse_chunks_into(
                 const std::vector<SpeculativeParseChunk>& chunks,
-                std::vector<ParsedChunkRows>& parsed
+                std::vector<ParsedChunkRows>& parsed,
+                std::vector<ChunkSpeculation>& speculations
             ) {
-                if (this->task_pool_.worker_count() > 1 && chunks.size() > 1) {
-                    this->parse_chunks_parallel(chunks, parsed);
+                if (this->task_pool_->worker_count() > 1 && chunks.size() > 1) {
+                    this->parse_chunks_parallel(chunks, parsed, speculations);
                     return;
                 }
 
-                ChunkParserCoreT<EagerClassify> parser(this->parse_flags_, this->ws_flags_, this->col_names_);
+                ChunkParserCoreT<EagerClassify, Dialect> parser = this->make_chunk_parser();
                 for (size_t i = 0; i < chunks.size(); ++i) {
-                    parsed[i] = this->parse_chunk_with(parser, chunks[i]);
+                    parsed[i] = this->parse_chunk_with(parser, chunks[i], speculations[i]);
                 }
             }
 
             void parse_chunks_parallel(
                 const std::vector<SpeculativeParseChunk>& chunks,
-                std::vector<ParsedChunkRows>& parsed
+                std::vector<ParsedChunkRows>& parsed,
+                std::vector<ChunkSpeculation>& speculations
             ) {
-                this->task_pool_.parallel_for(chunks.size(), [this, &chunks, &parsed](
+                internals::parallel::TaskGroup tasks;
+                this->spawn_chunks(tasks, chunks, [this, &chunks, &parsed, &speculations](
                     size_t worker_index,
                     size_t task_index
                 ) {
                     CSV_DEBUG_ASSERT(worker_index < this->worker_parsers_.size());
                     parsed[task_index] = this->parse_chunk_with(
                         this->worker_parsers_[worker_index],
-                        chunks[task_index]
+                        chunks[task_index],
+                        speculations[task_index]
                     );
                 });
+                this->task_pool_->wait(tasks);
+            }
+
+            /** Spawn `fn(worker_index, chunk_index)` for every chunk.
+             *
+             *  When the pool's workers are pinned across NUMA nodes, each chunk
+             *  is queued with a worker on the node holding its first page, so
+             *  it is parsed, and its rows allocated, next to its bytes.
+             */
+            template<typename Fn>
+            void spawn_chunks(
+                internals::parallel::TaskGroup& tasks,
+                const std::vector<SpeculativeParseChunk>& chunks,
+                Fn fn
+            ) {
+                internals::parallel::WorkStealingPool& pool = *this->task_pool_;
+                if (!pool.spans_numa_nodes()) {
+                    pool.spawn_for(tasks, chunks.size(), std::move(fn));
+                    return;
+                }
+
+                std::shared_ptr<Fn> shared_fn = std::make_shared<Fn>(std::move(fn));
+                for (size_t i = 0; i < chunks.size(); ++i) {
+                    const int node = internals::parallel::page_numa_node(chunks[i].bytes.data());
+                    pool.spawn_on(tasks, pool.next_worker_on_node(node), [shared_fn, i](size_t worker_index) {
+                        (*shared_fn)(worker_index, i);
+                    });
+                }
+            }
+
+            ChunkParserCoreT<EagerClassify, Dialect> make_chunk_parser() const {
+                ChunkParserCoreT<EagerClassify, Dialect> parser(this->parse_flags_, this->ws_flags_, this->col_names_);
+                parser.set_parser_engine(this->parser_engine_);
+                return parser;
             }
 
             void init_worker_parsers() {
-                const size_t worker_count = this->task_pool_.worker_count();
+                const size_t worker_count = this->task_pool_->worker_count();
                 if (worker_count <= 1) {
                     return;
                 }
 
                 this->worker_parsers_.reserve(worker_count);
                 for (size_t i = 0; i < worker_count; ++i) {
-                    this->worker_parsers_.push_back(
-                        ChunkParserCoreT<EagerClassify>(this->parse_flags_, this->ws_flags_, this->col_names_)
-                    );
+                    this->worker_parsers_.push_back(this->make_chunk_parser());
                 }
             }
 
             ParseFlagMap parse_flags_;
             WhitespaceMap ws_flags_;
             ColNamesPtr col_names_;
-            internals::parallel::IndexedTaskPool task_pool_;
-            std::vector<ChunkParserCoreT<EagerClassify>> worker_parsers_;
+            std::shared_ptr<internals::parallel::WorkStealingPool> task_pool_;
+
+            // One parser per pool worker index. A shared pool runs at most one
+            // task per index at a time, so each parser is only used by one task.
+            std::vector<ChunkParserCoreT<EagerClassify, Dialect>> worker_parsers_;
+            ParserEngine parser_engine_ = ParserEngine::STATE_MACHINE;
+
+            // Pipelined mode: the window workers are parsing, and the validator
+            // state carried from the last released window into the next one.
+            std::unique_ptr<PipelinedWindow> in_flight_;
+            ParserDFAState pipeline_state_;
+            CSVRowFragment pipeline_suffix_;
+            size_t next_release_sequence_ = 0;
         };
         }
     }
@@ -4,6 +4,8 @@
 #include "diagnostics.hpp"
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 
 #if CSV_ENABLE_THREADS
@@ -67,7 +69,11 @@ namespace csv {
             explicit SpeculativeScanner(
                 const ParseFlagMap& parse_flags,
                 size_t prefix_bytes = CSV_SPECULATIVE_PREFIX_SIZE
-            ) : parse_flags_(parse_flags), prefix_bytes_(prefix_bytes) {}
+            ) : parse_flags_(parse_flags),
+                prefix_bytes_(prefix_bytes),
+                sentinels_(infer_delimiter(parse_flags), infer_quote_char(parse_flags, infer_delimiter(parse_flags))),
+                // no_quote mode has no QUOTE flag; the quote sentinel then aliases the delimiter.
+                quoting_(infer_quote_char(parse_flags, infer_delimiter(parse_flags)) != infer_delimiter(parse_flags)) {}
 
             ChunkSpeculation speculate(
                 size_t sequence_number,
@@ -82,12 +88,229 @@ namespace csv {
                 result.offset = offset;
                 result.length = chunk.size();
                 result.prefix_length = prefix_length;
+#if defined(CSV_NO_SIMD)
+                this->scan_prefix_reference(prefix, result.outside_scan, result.inside_scan);
+#else
                 this->scan_prefix(prefix, result.outside_scan, result.inside_scan);
+#endif
                 result.ambiguous = this->is_ambiguous(result.outside_scan, result.inside_scan);
                 result.assumed_start_state = this->choose_start_state(result);
                 return result;
             }
 
+            /** Block-at-a-time prefix scan producing the same results as scan_prefix_reference().
+             *
+             *  Each 64-byte block is classified into quote, delimiter and line
+             *  ending bitmaps with the structural-index kernels. Byte counts come
+             *  from popcounts over the quote-parity mask, so only quotes and row
+             *  ends are visited one by one, for the span and record statistics.
+             */
+            void scan_prefix(
+                csv::string_view prefix,
+                PrefixScanResult& outside_scan,
+                PrefixScanResult& inside_scan
+            ) const {
+                using internals::ParseFlags;
+
+                PrefixCounterState outside;
+                PrefixCounterState inside;
+                this->start_quoted_span(inside, 0, true);
+
+                bool odd_quotes = false;
+                size_t separators = 0;
+                size_t outside_unquoted = 0;
+                uint64_t prev_separator = 1;
+                uint64_t prev_cr = 0;
+
+                for (size_t block_pos = 0; block_pos < prefix.size(); block_pos += STRUCTURAL_BLOCK_SIZE) {
+                    const size_t block_bytes = (std::min)(STRUCTURAL_BLOCK_SIZE, prefix.size() - block_pos);
+                    const uint64_t valid = block_bytes == STRUCTURAL_BLOCK_SIZE
+                        ? ~uint64_t(0)
+                        : (uint64_t(1) << block_bytes) - 1;
+
+                    StructuralBlockMasks masks;
+                    if (block_bytes == STRUCTURAL_BLOCK_SIZE) {
+                        find_structural_masks(prefix.data() + block_pos, this->sentinels_, masks);
+                    }
+                    else {
+                        char padded[STRUCTURAL_BLOCK_SIZE] = {};
+                        std::memcpy(padded, prefix.data() + block_pos, block_bytes);
+                        find_structural_masks(padded, this->sentinels_, masks);
+                    }
+
+                    const uint64_t quotes = this->quoting_ ? masks.quote & valid : 0;
+                    const uint64_t delims = masks.delim & valid;
+                    const uint64_t crs = masks.cr & valid;
+                    const uint64_t lfs = masks.lf & valid;
+                    const uint64_t separator_bytes = delims | crs | lfs;
+
+                    // A CRLF pair is one unit: its LF is neither a separator nor a row end.
+                    const uint64_t lf_after_cr = lfs & ((crs << 1) | prev_cr);
+                    const uint64_t row_ends = crs | (lfs & ~lf_after_cr);
+                    separators += popcount64(delims | row_ends);
+
+                    // Bit i: an odd number of quotes precede byte i in the prefix.
+                    const uint64_t carry = odd_quotes ? ~uint64_t(0) : 0;
+                    const uint64_t quote_prefix = this->quoting_ ? masks.quote_prefix : 0;
+                    const uint64_t odd_before = quote_prefix ^ quotes ^ carry;
+                    outside_unquoted += popcount64(~odd_before & valid);
+
+                    if (quotes != 0) {
+                        uint64_t next_is_boundary = 0;
+                        if (block_bytes < STRUCTURAL_BLOCK_SIZE) {
+                            next_is_boundary = uint64_t(1) << (block_bytes - 1);
+                        }
+                        else if (block_pos + STRUCTURAL_BLOCK_SIZE >= prefix.size()
+                            || this->is_separator_or_record_end(this->parse_flag(prefix[block_pos + STRUCTURAL_BLOCK_SIZE]))) {
+                            next_is_boundary = uint64_t(1) << 63;
+                        }
+
+                        const uint64_t can_open = quotes & ((separator_bytes << 1) | prev_separator);
+                        const uint64_t can_close = quotes & ((separator_bytes >> 1) | next_is_boundary);
+                        if (can_open != 0 && outside.result.first_quote_open == this->missing_index()) {
+                            outside.result.first_quote_open = block_pos + trailing_zeros64(can_open);
+                        }
+                        if (can_close != 0 && inside.result.first_quote_close == this->missing_index()) {
+                            inside.result.first_quote_close = block_pos + trailing_zeros64(can_close);
+                        }
+                    }
+
+                    uint64_t events = quotes | row_ends;
+                    while (events != 0) {
+                        const unsigned bit = trailing_zeros64(events);
+                        events &= events - 1;
+                        const size_t pos = block_pos + bit;
+
+                        if ((quotes >> bit) & 1) {
+                            if (odd_quotes) {
+                                this->finish_quoted_span(outside, pos);
+                                this->start_quoted_span(inside, pos + 1, false);
+                            }
+                            else {
+                                this->start_quoted_span(outside, pos + 1, false);
+                                this->finish_quoted_span(inside, pos);
+                            }
+
+                            odd_quotes = !odd_quotes;
+                            continue;
+                        }
+
+                        size_t record_end = pos + 1;
+                        if (((crs >> bit) & 1)
+                            && record_end < prefix.size()
+                            && this->parse_flag(prefix[record_end]) == ParseFlags::NEWLINE) {
+                            record_end++;
+                        }
+
+                        PrefixCounterState& state = odd_quotes ? inside : outside;
+                        this->finish_record(state, record_end);
+                        if (state.result.first_record_end == this->missing_index()) {
+                            state.result.first_record_end = record_end;
+                        }
+                    }
+
+                    prev_separator = separator_bytes >> 63;
+                    prev_cr = crs >> 63;
+                }
+
+                outside.result.total_states = prefix.size();
+                inside.result.total_states = prefix.size();
+                outside.result.unquoted_states = outside_unquoted;
+                inside.result.unquoted_states = prefix.size() - outside_unquoted;
+
+                this->finish_prefix_scan(prefix, separators, odd_quotes, outside, inside, outside_scan, inside_scan);
+            }
+
+            /** Byte-at-a-time prefix scan.
+             *
+             *  The speculative pass should be much cheaper than parsing. This
+             *  is a quote-parity scan: q-o / o-q pattern evidence usually
+             *  decides the starting state, and the probability model is left
+             *  for the rare ambiguous prefix. Used when SIMD is compiled out,
+             *  and as the reference scan_prefix() must match exactly.
+             */
+            void scan_prefix_reference(
+                csv::string_view prefix,
+                PrefixScanResult& outside_scan,
+                PrefixScanResult& inside_scan
+            ) const {
+                using internals::ParseFlags;
+
+                PrefixCounterState outside;
+                PrefixCounterState inside;
+                this->start_quoted_span(inside, 0, true);
+
+                bool odd_quotes = false;
+                size_t separators = 0;
+
+                for (size_t pos = 0; pos < prefix.size();) {
+                    const ParseFlags flag = this->parse_flag(prefix[pos]);
+                    size_t width = 1;
+                    if (flag == ParseFlags::CARRIAGE_RETURN
+                        && pos + 1 < prefix.size()
+                        && this->parse_flag(prefix[pos + 1]) == ParseFlags::NEWLINE) {
+                        width = 2;
+                    }
+
+                    outside.result.total_states += width;
+                    inside.result.total_states += width;
+                    if (!odd_quotes) {
+                        outside.result.unquoted_states += width;
+                    }
+                    else {
+                        inside.result.unquoted_states += width;
+                    }
+
+                    if (flag == ParseFlags::DELIMITER || flag == ParseFlags::CARRIAGE_RETURN || flag == ParseFlags::NEWLINE) {
+                        separators++;
+                    }
+
+                    if (flag == ParseFlags::QUOTE) {
+                        if (outside.result.first_quote_open == this->missing_index()
+                            && this->quote_can_open(prefix, pos)) {
+                            outside.result.first_quote_open = pos;
+                        }
+                        if (inside.result.first_quote_close == this->missing_index()
+                            && this->quote_can_close(prefix, pos)) {
+                            inside.result.first_quote_close = pos;
+                        }
+
+                        if (odd_quotes) {
+                            this->finish_quoted_span(outside, pos);
+                            this->start_quoted_span(inside, pos + 1, false);
+                        }
+                        else {
+                            this->start_quoted_span(outside, pos + 1, false);
+                            this->finish_quoted_span(inside, pos);
+                        }
+
+                        odd_quotes = !odd_quotes;
+                        pos++;
+                        continue;
+                    }
+
+                    if (flag == ParseFlags::CARRIAGE_RETURN || flag == ParseFlags::NEWLINE) {
+                        const size_t record_end = pos + width;
+                        if (!odd_quotes) {
+                            this->finish_record(outside, record_end);
+                            if (outside.result.first_record_end == this->missing_index()) {
+                                outside.result.first_record_end = record_end;
+                            }
+                        }
+                        else {
+                            this->finish_record(inside, record_end);
+                            if (inside.result.first_record_end == this->missing_index()) {
+                                inside.result.first_record_end = record_end;
+                            }
+                        }
+                    }
+
+                    pos += width;
+                }
+
+                this->finish_prefix_scan(prefix, separators, odd_quotes, outside, inside, outside_scan, inside_scan);
+            }
+
         private:
             CONSTEXPR_17 ParseFlags parse_flag(const char ch) const noexcept {
                 return parse_flags_.data()[ch + CHAR_OFFSET];
@@ -195,89 +418,15 @@ namespace csv {
                     : state.separator_weight * log_separator_probability;
             }
 
-            // The speculative pass should be much cheaper than parsing. This
-            // is a quote-parity scan: q-o / o-q pattern evidence usually
-            // decides the starting state, and the probability model is left
-            // for the rare ambiguous prefix.
-            void scan_prefix(
+            void finish_prefix_scan(
                 csv::string_view prefix,
+                size_t separators,
+                bool odd_quotes,
+                PrefixCounterState& outside,
+                PrefixCounterState& inside,
                 PrefixScanResult& outside_scan,
                 PrefixScanResult& inside_scan
             ) const {
-                using internals::ParseFlags;
-
-                PrefixCounterState outside;
-                PrefixCounterState inside;
-                this->start_quoted_span(inside, 0, true);
-
-                bool odd_quotes = false;
-                size_t separators = 0;
-
-                for (size_t pos = 0; pos < prefix.size();) {
-                    const ParseFlags flag = this->parse_flag(prefix[pos]);
-                    size_t width = 1;
-                    if (flag == ParseFlags::CARRIAGE_RETURN
-                        && pos + 1 < prefix.size()
-                        && this->parse_flag(prefix[pos + 1]) == ParseFlags::NEWLINE) {
-                        width = 2;
-                    }
-
-                    outside.result.total_states += width;
-                    inside.result.total_states += width;
-                    if (!odd_quotes) {
-                        outside.result.unquoted_states += width;
-                    }
-                    else {
-                        inside.result.unquoted_states += width;
-                    }
-
-                    if (flag == ParseFlags::DELIMITER || flag == ParseFlags::CARRIAGE_RETURN || flag == ParseFlags::NEWLINE) {
-                        separators++;
-                    }
-
-                    if (flag == ParseFlags::QUOTE) {
-                        if (outside.result.first_quote_open == this->missing_index()
-                            && this->quote_can_open(prefix, pos)) {
-                            outside.result.first_quote_open = pos;
-                        }
-                        if (inside.result.first_quote_close == this->missing_index()
-                            && this->quote_can_close(prefix, pos)) {
-                            inside.result.first_quote_close = pos;
-                        }
-
-                        if (odd_quotes) {
-                            this->finish_quoted_span(outside, pos);
-                            this->start_quoted_span(inside, pos + 1, false);
-                        }
-                        else {
-                            this->start_quoted_span(outside, pos + 1, false);
-                            this->finish_quoted_span(inside, pos);
-                        }
-
-                        odd_quotes = !odd_quotes;
-                        pos++;
-                        continue;
-                    }
-
-                    if (flag == ParseFlags::CARRIAGE_RETURN || flag == ParseFlags::NEWLINE) {
-                        const size_t record_end = pos + width;
-                        if (!odd_quotes) {
-                            this->finish_record(outside, record_end);
-                            if (outside.result.first_record_end == this->missing_index()) {
-                                outside.result.first_record_end = record_end;
-                            }
-                        }
-                        else {
-                            this->finish_record(inside, record_end);
-                            if (inside.result.first_record_end == this->missing_index()) {
-                                inside.result.first_record_end = record_end;
-                            }
-                        }
-                    }
-
-                    pos += width;
-                }
-
                 const long double separator_probability = prefix.empty()
                     ? 0
                     : static_cast<long double>(separators) / static_cast<long double>(prefix.size());
@@ -430,6 +579,8 @@ namespace csv {
 
             ParseFlagMap parse_flags_;
             size_t prefix_bytes_;
+            SentinelVecs sentinels_;
+            bool quoting_;
         };
         }
     }
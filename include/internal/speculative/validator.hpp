@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+
 #include "chunks.hpp"
 
 #if CSV_ENABLE_THREADS
@@ -13,20 +16,33 @@ namespace csv {
             SpeculativeParseValidator(
                 Parser& repair_parser,
                 RowSink& output,
-                ParserDFAState initial_state = ParserDFAState()
+                ParserDFAState initial_state = ParserDFAState(),
+                CSVRowFragment pending_suffix = CSVRowFragment()
             ) : repair_parser_(repair_parser),
                 output_(output),
-                expected_start_state_(initial_state) {}
+                expected_start_state_(initial_state),
+                pending_suffix_(std::move(pending_suffix)) {}
 
             ParserChunkResult validate_and_release(ParsedChunkRows&& chunk) {
                 if (!parser_dfa_state_equal(chunk.parse_result.initial_state, this->expected_start_state_)) {
+                    const auto repair_start = std::chrono::steady_clock::now();
                     chunk = repair_parsed_chunk_rows(
                         this->repair_parser_,
                         chunk,
                         this->expected_start_state_
                     );
+                    this->repair_nanoseconds_ += static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - repair_start
+                        ).count()
+                    );
                     this->repair_count_++;
                 }
+                else if (chunk.repaired) {
+                    // Repaired ahead of validation from the right start state.
+                    this->repair_count_++;
+                    this->prepared_repair_count_++;
+                }
 
                 const ParserChunkResult parse_result = chunk.parse_result;
                 this->release(std::move(chunk));
@@ -39,10 +55,25 @@ namespace csv {
                 }
             }
 
+            /** Chunks released from a corrected start state, including prepared repairs. */
             size_t repair_count() const noexcept {
                 return this->repair_count_;
             }
 
+            /** Repairs that arrived already done and matched the expected start state. */
+            size_t prepared_repair_count() const noexcept {
+                return this->prepared_repair_count_;
+            }
+
+            /** Time spent repairing on this validator's thread. */
+            std::uint64_t repair_nanoseconds() const noexcept {
+                return this->repair_nanoseconds_;
+            }
+
+            size_t released_row_count() const noexcept {
+                return this->released_row_count_;
+            }
+
             ParserDFAState expected_start_state() const noexcept {
                 return this->expected_start_state_;
             }
@@ -76,6 +107,7 @@ namespace csv {
                     this->release_pending_suffix();
                 }
 
+                this->released_row_count_ += chunk.complete_rows.size();
                 csv_append_rows(this->output_, std::move(chunk.complete_rows));
 
                 this->pending_suffix_ = chunk.suffix_fragment;
@@ -88,6 +120,7 @@ namespace csv {
                 }
 
                 auto rows = materialize_row_fragment(this->repair_parser_, this->pending_suffix_);
+                this->released_row_count_ += rows.size();
                 csv_append_rows(this->output_, std::move(rows));
 
                 this->pending_suffix_ = CSVRowFragment();
@@ -98,6 +131,9 @@ namespace csv {
             ParserDFAState expected_start_state_;
             CSVRowFragment pending_suffix_;
             size_t repair_count_ = 0;
+            size_t prepared_repair_count_ = 0;
+            std::uint64_t repair_nanoseconds_ = 0;
+            size_t released_row_count_ = 0;
         };
         }
     }
@@ -0,0 +1,424 @@
+/** @file
+ *  @brief Lock-free single-producer/single-consumer row queue
+ *
+ *  The CSVReader pipeline has exactly one parser thread pushing rows and one
+ *  consumer thread popping them. This queue exploits that to keep the hot
+ *  push/pop paths free of mutexes; a mutex and condition variables are only
+ *  touched when one side actually has to sleep.
+ *
+ *  Design notes: see THREADSAFE_DEQUE_DESIGN.md for the sleep/wake protocol.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+
+namespace csv {
+    namespace internals {
+        /** Bounded ring blocks chained into an unbounded SPSC queue.
+         *
+         *  Rows live in fixed-capacity ring blocks. The producer writes into the
+         *  tail block and publishes a whole append_rows() batch with one release
+         *  store; when the ring is full it links a fresh block instead of
+         *  waiting, so single-threaded users (and tests) may push any number of
+         *  rows before popping. The consumer frees a block once it has drained
+         *  it and seen its successor. Memory is bounded by the reader's
+         *  read-ahead back-pressure (wait_for_capacity()), not by the ring.
+         *
+         *  Producer-owned and consumer-owned indices sit on separate cache lines.
+         *
+         *  Threading contract: push_back/append_rows/wait_for_capacity are
+         *  producer-only; pop_front/peek_front/drain_front/wait/inspect are consumer-only.
+         *  empty(), size() and the signalling methods may be called from either.
+         */
+        template<typename T>
+        class SPSCRowQueue {
+        public:
+            SPSCRowQueue(size_t notify_size = 100, size_t block_capacity = 1024)
+                : notify_size_(notify_size),
+                  block_mask_(round_up_pow2(block_capacity) - 1) {
+                this->front_block_ = new Block(this->block_mask_ + 1);
+                this->tail_block_ = this->front_block_;
+            }
+
+            SPSCRowQueue(const SPSCRowQueue&) = delete;
+            SPSCRowQueue& operator=(const SPSCRowQueue&) = delete;
+
+            ~SPSCRowQueue() {
+                Block* block = this->front_block_;
+                while (block) {
+                    Block* next = block->next.load(std::memory_order_relaxed);
+                    delete block;
+                    block = next;
+                }
+            }
+
+            bool empty() const noexcept {
+                return this->size() == 0;
+            }
+
+            size_t size() const noexcept {
+                // Rows become poppable at the block's tail store, slightly before
+                // publish() counts them, so popped_ may briefly run ahead.
+                const size_t popped = this->popped_.load(std::memory_order_seq_cst);
+                const size_t pushed = this->pushed_.load(std::memory_order_seq_cst);
+                return pushed > popped ? pushed - popped : 0;
+            }
+
+            /** Total number of rows ever pushed. */
+            size_t pushed_count() const noexcept {
+                return this->pushed_.load(std::memory_order_acquire);
+            }
+
+            /** Total number of rows ever popped; exact on the consumer thread. */
+            size_t popped_count() const noexcept {
+                return this->popped_.load(std::memory_order_acquire);
+            }
+
+            void push_back(T&& item) {
+                Block* block = this->writable_block();
+                const size_t tail = block->tail.load(std::memory_order_relaxed);
+                block->slots[tail & this->block_mask_] = std::move(item);
+                block->tail.store(tail + 1, std::memory_order_release);
+                this->publish(1);
+            }
+
+            void append_rows(std::vector<T>&& rows) {
+                size_t i = 0;
+                while (i < rows.size()) {
+                    Block* block = this->writable_block();
+                    size_t tail = block->tail.load(std::memory_order_relaxed);
+                    const size_t room = this->block_mask_ + 1 - (tail - block->head_cache);
+
+                    for (size_t n = 0; n < room && i < rows.size(); ++n, ++i, ++tail) {
+                        block->slots[tail & this->block_mask_] = std::move(rows[i]);
+                    }
+
+                    block->tail.store(tail, std::memory_order_release);
+                }
+
+                if (!rows.empty()) {
+                    this->publish(rows.size());
+                }
+            }
+
+            /** Precondition: !empty(). */
+            T pop_front() noexcept {
+                Block* block = this->readable_block();
+                if (!block) {
+                    // Unreachable when the precondition holds; avoids a null dereference.
+                    block = this->front_block_;
+                }
+
+                const size_t head = block->head.load(std::memory_order_relaxed);
+                T item = std::move(block->slots[head & this->block_mask_]);
+                block->head.store(head + 1, std::memory_order_release);
+                this->consume(1);
+                return item;
+            }
+
+            /** The row pop_front() would return next, or nullptr if none is queued. */
+            const T* peek_front() noexcept {
+                Block* block = this->readable_block();
+                if (!block) {
+                    return nullptr;
+                }
+
+                return &block->slots[block->head.load(std::memory_order_relaxed) & this->block_mask_];
+            }
+
+            /** Move up to @p max_items rows into a caller-owned batch buffer.
+             *
+             *  Each ring block is released back to the producer with a single
+             *  store, and the consumed count is published once for the whole call.
+             */
+            size_t drain_front(std::vector<T>& out, size_t max_items) {
+                size_t drained = 0;
+                while (drained < max_items) {
+                    Block* block = this->readable_block();
+                    if (!block) {
+                        break;
+                    }
+
+                    size_t head = block->head.load(std::memory_order_relaxed);
+                    const size_t available = block->tail_cache - head;
+                    size_t take = max_items - drained;
+                    if (take > available) {
+                        take = available;
+                    }
+
+                    out.reserve(out.size() + take);
+                    for (size_t n = 0; n < take; ++n, ++head) {
+                        out.push_back(std::move(block->slots[head & this->block_mask_]));
+                    }
+
+                    block->head.store(head, std::memory_order_release);
+                    drained += take;
+                }
+
+                if (drained > 0) {
+                    this->consume(drained);
+                }
+
+                return drained;
+            }
+
+            /** Invoke @p callback with a copy of queued rows.
+             *
+             *  Consumer-side diagnostic, mirroring ThreadSafeDeque::inspect().
+             *  Published slots are never rewritten by the producer until the
+             *  consumer releases them, so this is safe against a live producer.
+             */
+            template<typename Callback>
+            void inspect(Callback&& callback) const {
+                std::vector<T> snapshot;
+                const Block* block = this->front_block_;
+                while (block) {
+                    const Block* next = block->next.load(std::memory_order_acquire);
+                    const size_t tail = block->tail.load(std::memory_order_acquire);
+                    for (size_t i = block->head.load(std::memory_order_relaxed); i < tail; ++i) {
+                        snapshot.push_back(block->slots[i & this->block_mask_]);
+                    }
+                    block = next;
+                }
+
+                std::forward<Callback>(callback)(snapshot);
+            }
+
+            /** Returns true if a thread is actively pushing items to this queue */
+            bool is_waitable() const noexcept {
+                return this->is_waitable_.load(std::memory_order_acquire);
+            }
+
+            /** Consumer: sleep until notify_size rows are queued, a chunk is
+             *  published, the producer pauses, or the producer finishes.
+             */
+            void wait() {
+                if (!is_waitable()) {
+                    return;
+                }
+
+                std::unique_lock<std::mutex> lock{ this->lock_ };
+                const size_t published = this->chunks_published_;
+                auto ready = [this, published] {
+                    return this->size() >= this->notify_size_
+                        || !this->is_waitable()
+                        || this->chunks_published_ != published
+                        || this->producer_paused_;
+                };
+
+                // Announce the sleep before re-checking, so either the producer
+                // sees the flag or this check sees the producer's rows.
+                while (true) {
+                    this->consumer_sleeping_.store(true, std::memory_order_seq_cst);
+                    if (ready()) {
+                        break;
+                    }
+                    this->consumer_cond_.wait(lock);
+                }
+                this->consumer_sleeping_.store(false, std::memory_order_relaxed);
+            }
+
+            /** Producer: publish a finished chunk, then sleep until at most
+             *  @p max_size rows are queued.
+             *
+             *  Returns false if interrupt_producer() was called, in which case the
+             *  producer should stop after the chunk it just finished.
+             */
+            bool wait_for_capacity(size_t max_size) {
+                std::unique_lock<std::mutex> lock{ this->lock_ };
+                this->chunks_published_++;
+                this->capacity_limit_.store(max_size, std::memory_order_relaxed);
+
+                if (this->size() > max_size && !this->producer_interrupted_) {
+                    this->producer_paused_ = true;
+                    this->consumer_cond_.notify_all();
+
+                    while (true) {
+                        this->producer_sleeping_.store(true, std::memory_order_seq_cst);
+                        if (this->size() <= max_size || this->producer_interrupted_) {
+                            break;
+                        }
+                        this->producer_cond_.wait(lock);
+                    }
+
+                    this->producer_sleeping_.store(false, std::memory_order_relaxed);
+                    this->producer_paused_ = false;
+                }
+                else {
+                    this->consumer_cond_.notify_all();
+                }
+
+                return !this->producer_interrupted_;
+            }
+
+            /** Ask a producer paused in (or about to enter) wait_for_capacity() to stop.
+             *
+             *  Cleared by the next notify_all(), i.e. when a new producer cycle starts.
+             */
+            void interrupt_producer() {
+                std::lock_guard<std::mutex> lock{ this->lock_ };
+                this->producer_interrupted_ = true;
+                this->producer_cond_.notify_all();
+            }
+
+            /** Whether interrupt_producer() was called in the current producer cycle.
+             *
+             *  For producers that wait on their source rather than on this
+             *  queue, and so must notice an interrupt themselves.
+             */
+            bool producer_interrupted() {
+                std::lock_guard<std::mutex> lock{ this->lock_ };
+                return this->producer_interrupted_;
+            }
+
+            /** Tell listeners that this queue is actively being pushed to */
+            void notify_all() {
+                std::lock_guard<std::mutex> lock{ this->lock_ };
+                this->is_waitable_.store(true, std::memory_order_release);
+                this->producer_interrupted_ = false;
+                this->consumer_cond_.notify_all();
+            }
+
+            void kill_all() {
+                std::lock_guard<std::mutex> lock{ this->lock_ };
+                this->is_waitable_.store(false, std::memory_order_release);
+                this->consumer_cond_.notify_all();
+            }
+
+        private:
+            struct Block {
+                explicit Block(size_t capacity) : slots(new T[capacity]) {}
+
+                std::unique_ptr<T[]> slots;
+                std::atomic<Block*> next{ nullptr };
+
+                char pad_producer_[CSV_CACHE_LINE_SIZE];
+                std::atomic<size_t> tail{ 0 };  // Written by producer
+                size_t head_cache = 0;          // Producer's last view of head
+
+                char pad_consumer_[CSV_CACHE_LINE_SIZE];
+                std::atomic<size_t> head{ 0 };  // Written by consumer
+                size_t tail_cache = 0;          // Consumer's last view of tail
+            };
+
+            static size_t round_up_pow2(size_t n) noexcept {
+                size_t capacity = 2;
+                while (capacity < n) {
+                    capacity <<= 1;
+                }
+                return capacity;
+            }
+
+            /** Producer: return a block with at least one free slot. */
+            Block* writable_block() {
+                Block* block = this->tail_block_;
+                const size_t tail = block->tail.load(std::memory_order_relaxed);
+                if (tail - block->head_cache <= this->block_mask_) {
+                    return block;
+                }
+
+                block->head_cache = block->head.load(std::memory_order_acquire);
+                if (tail - block->head_cache <= this->block_mask_) {
+                    return block;
+                }
+
+                // Ring is full: chain a new block rather than wait on the consumer.
+                Block* next = new Block(this->block_mask_ + 1);
+                block->next.store(next, std::memory_order_release);
+                this->tail_block_ = next;
+                return next;
+            }
+
+            /** Consumer: return the block holding the next row, or nullptr if empty.
+             *
+             *  Leaves the block's tail_cache current. Drained blocks whose
+             *  successor is visible are freed: the producer links a successor only
+             *  after its last write to the old block.
+             */
+            Block* readable_block() noexcept {
+                while (true) {
+                    Block* block = this->front_block_;
+                    const size_t head = block->head.load(std::memory_order_relaxed);
+                    if (head != block->tail_cache) {
+                        return block;
+                    }
+
+                    block->tail_cache = block->tail.load(std::memory_order_acquire);
+                    if (head != block->tail_cache) {
+                        return block;
+                    }
+
+                    Block* next = block->next.load(std::memory_order_acquire);
+                    if (!next) {
+                        return nullptr;
+                    }
+
+                    block->tail_cache = block->tail.load(std::memory_order_acquire);
+                    if (head != block->tail_cache) {
+                        return block;
+                    }
+
+                    this->front_block_ = next;
+                    delete block;
+                }
+            }
+
+            void publish(size_t n) {
+                this->pushed_.store(this->pushed_.load(std::memory_order_relaxed) + n, std::memory_order_seq_cst);
+
+                if (this->consumer_sleeping_.load(std::memory_order_seq_cst)
+                    && this->size() >= this->notify_size_
+                    && this->consumer_sleeping_.exchange(false)) {
+                    std::lock_guard<std::mutex> lock{ this->lock_ };
+                    this->consumer_cond_.notify_all();
+                }
+            }
+
+            void consume(size_t n) noexcept {
+                this->popped_.store(this->popped_.load(std::memory_order_relaxed) + n, std::memory_order_seq_cst);
+
+                if (this->producer_sleeping_.load(std::memory_order_seq_cst)
+                    && this->size() <= this->capacity_limit_.load(std::memory_order_relaxed)
+                    && this->producer_sleeping_.exchange(false)) {
+                    std::lock_guard<std::mutex> lock{ this->lock_ };
+                    this->producer_cond_.notify_one();
+                }
+            }
+
+            // Producer side
+            Block* tail_block_ = nullptr;
+            std::atomic<size_t> pushed_{ 0 };
+            std::atomic<bool> producer_sleeping_{ false };
+            char pad_producer_[CSV_CACHE_LINE_SIZE];
+
+            // Consumer side
+            Block* front_block_ = nullptr;
+            std::atomic<size_t> popped_{ 0 };
+            std::atomic<bool> consumer_sleeping_{ false };
+            char pad_consumer_[CSV_CACHE_LINE_SIZE];
+
+            // Shared, read-mostly
+            const size_t notify_size_;
+            const size_t block_mask_;
+            std::atomic<size_t> capacity_limit_{ 0 };
+            std::atomic<bool> is_waitable_{ false };
+
+            // Sleep/wake state, guarded by lock_
+            std::mutex lock_;
+            std::condition_variable consumer_cond_;
+            std::condition_variable producer_cond_;
+            size_t chunks_published_ = 0;
+            bool producer_paused_ = false;
+            bool producer_interrupted_ = false;
+        };
+    }
+}
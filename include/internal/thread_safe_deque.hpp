@@ -41,6 +41,7 @@ namespace csv {
                 this->batches_ = other.batches_;
                 this->front_index_ = other.front_index_;
                 this->size_ = other.size_;
+                this->pushed_ = other.pushed_;
                 this->_notify_size = other._notify_size;
                 this->_is_empty.store(other._is_empty.load(std::memory_order_acquire), std::memory_order_release);
                 this->_is_waitable.store(other._is_waitable.load(std::memory_order_acquire), std::memory_order_release);
@@ -55,6 +56,7 @@ namespace csv {
                 if (!rows.empty()) {
                     this->batches_.push_back(std::move(rows));
                     this->size_ = source.size();
+                    this->pushed_ = source.size();
                 }
                 this->_is_empty.store(source.empty(), std::memory_order_release);
             }
@@ -69,6 +71,7 @@ namespace csv {
                 batch.push_back(std::move(item));
                 this->batches_.push_back(std::move(batch));
                 this->size_++;
+                this->pushed_++;
                 this->_is_empty.store(false, std::memory_order_release);
 
                 if (this->size_ >= _notify_size) {
@@ -83,6 +86,7 @@ namespace csv {
 
                 std::lock_guard<std::mutex> lock{ this->_lock };
                 this->size_ += rows.size();
+                this->pushed_ += rows.size();
                 this->batches_.push_back(std::move(rows));
                 this->_is_empty.store(false, std::memory_order_release);
 
@@ -102,6 +106,7 @@ namespace csv {
                     this->_is_empty.store(true, std::memory_order_release);
                 }
 
+                this->notify_capacity();
                 return item;
             }
 
@@ -126,6 +131,7 @@ namespace csv {
                     this->_is_empty.store(true, std::memory_order_release);
                 }
 
+                this->notify_capacity();
                 return drain_count;
             }
 
@@ -169,19 +175,70 @@ namespace csv {
                 }
 
                 std::unique_lock<std::mutex> lock{ this->_lock };
-                this->_cond.wait(lock, [this] { return this->size_ >= _notify_size || !this->is_waitable(); });
+                const size_t published = this->chunks_published_;
+                this->_cond.wait(lock, [this, published] {
+                    return this->size_ >= _notify_size
+                        || !this->is_waitable()
+                        || this->chunks_published_ != published
+                        || this->capacity_waiting_;
+                });
                 lock.unlock();
             }
 
+            /** Publish a finished chunk, then block the producer until at most
+             *  @p max_size rows are queued.
+             *
+             *  Publishing wakes waiting consumers the same way kill_all() does at
+             *  the end of a worker cycle, so a chunk with fewer than notify_size
+             *  rows is never stranded behind a paused or still-running producer.
+             *  Returns false if interrupt_producer() was called, in which case the
+             *  producer should stop after the chunk it just finished.
+             */
+            bool wait_for_capacity(size_t max_size) {
+                std::unique_lock<std::mutex> lock{ this->_lock };
+                this->chunks_published_++;
+                this->_cond.notify_all();
+
+                if (this->size_ > max_size && !this->producer_interrupted_) {
+                    this->capacity_limit_ = max_size;
+                    this->capacity_waiting_ = true;
+                    this->_capacity_cond.wait(lock, [this] {
+                        return this->size_ <= this->capacity_limit_ || this->producer_interrupted_;
+                    });
+                    this->capacity_waiting_ = false;
+                }
+
+                return !this->producer_interrupted_;
+            }
+
+            /** Ask a producer paused in (or about to enter) wait_for_capacity() to stop.
+             *
+             *  Cleared by the next notify_all(), i.e. when a new producer cycle starts.
+             */
+            void interrupt_producer() {
+                std::lock_guard<std::mutex> lock{ this->_lock };
+                this->producer_interrupted_ = true;
+                this->_capacity_cond.notify_all();
+            }
+
             size_t size() const noexcept {
                 std::lock_guard<std::mutex> lock{ this->_lock };
                 return this->size_;
             }
 
+            /** Total number of rows ever pushed, used to measure rows per chunk
+             *  while a consumer drains concurrently.
+             */
+            size_t pushed_count() const noexcept {
+                std::lock_guard<std::mutex> lock{ this->_lock };
+                return this->pushed_;
+            }
+
             /** Tell listeners that this deque is actively being pushed to */
             void notify_all() {
                 std::lock_guard<std::mutex> lock{ this->_lock };
                 this->_is_waitable.store(true, std::memory_order_release);
+                this->producer_interrupted_ = false;
                 this->_cond.notify_all();
             }
 
@@ -197,9 +254,22 @@ namespace csv {
             size_t _notify_size;
             mutable std::mutex _lock;
             std::condition_variable _cond;
+            std::condition_variable _capacity_cond;   // Producer back-pressure
             std::deque<std::vector<T>> batches_;
             size_t front_index_ = 0;
             size_t size_ = 0;
+            size_t pushed_ = 0;
+            size_t chunks_published_ = 0;
+            size_t capacity_limit_ = 0;
+            bool capacity_waiting_ = false;
+            bool producer_interrupted_ = false;
+
+            /** Called with _lock held after a consumer removes rows. */
+            void notify_capacity() noexcept {
+                if (this->capacity_waiting_ && this->size_ <= this->capacity_limit_) {
+                    this->_capacity_cond.notify_one();
+                }
+            }
 
             void discard_exhausted_front_batch() noexcept {
                 while (!this->batches_.empty() && this->front_index_ >= this->batches_.front().size()) {
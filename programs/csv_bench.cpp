@@ -29,6 +29,9 @@ int main(int argc, char** argv) {
             << " probability_model=" << info.speculative_diagnostics.probability_model_chunks
             << " size_heuristic=" << info.speculative_diagnostics.record_size_heuristic_chunks
             << " repairs=" << info.speculative_diagnostics.validation_repairs
+            << " parallel_repairs=" << info.speculative_diagnostics.parallel_repairs
+            << " repair_ms=" << info.speculative_diagnostics.repair_nanoseconds / 1e6
+            << " serial_fallback_windows=" << info.speculative_diagnostics.serial_fallback_windows
             << " assumed_quoted=" << info.speculative_diagnostics.assumed_quoted_chunks
             << " assumed_unquoted=" << info.speculative_diagnostics.assumed_unquoted_chunks
             << std::endl;
@@ -0,0 +1,118 @@
+// Measure row-delivery latency for a live feed written to a pipe
+
+#include "csv.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if CSV_DESCRIPTOR_SOURCES && CSV_ENABLE_THREADS
+#include <unistd.h>
+
+using namespace csv;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    long long now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    /** Write one row per write() call, each stamped with its send time. */
+    void write_feed(int fd, size_t n_rows, std::chrono::microseconds interval) {
+        const std::string header = "seq,sent_ns,payload\n";
+        (void)::write(fd, header.data(), header.size());
+
+        auto next_send = Clock::now();
+        for (size_t i = 0; i < n_rows; ++i) {
+            std::this_thread::sleep_until(next_send);
+            next_send += interval;
+
+            const std::string row = std::to_string(i) + "," + std::to_string(now_ns()) + ",\"some, quoted payload\"\n";
+            if (::write(fd, row.data(), row.size()) < 0) {
+                break;
+            }
+        }
+        ::close(fd);
+    }
+
+    void report(const std::string& label, std::vector<double>& latencies_us, double seconds) {
+        if (latencies_us.empty()) {
+            std::cout << label << ": no rows" << std::endl;
+            return;
+        }
+
+        std::sort(latencies_us.begin(), latencies_us.end());
+        auto percentile = [&latencies_us](double p) {
+            return latencies_us[static_cast<size_t>(p * static_cast<double>(latencies_us.size() - 1))];
+        };
+
+        std::cout << label << ": " << latencies_us.size() << " rows in " << seconds << " s"
+            << ", p50 " << percentile(0.50) << " us"
+            << ", p99 " << percentile(0.99) << " us"
+            << ", max " << latencies_us.back() << " us" << std::endl;
+    }
+
+    template<typename TMakeReader>
+    void measure(const std::string& label, size_t n_rows, std::chrono::microseconds interval, TMakeReader make_reader) {
+        int fds[2];
+        if (::pipe(fds) != 0) {
+            std::cerr << "pipe() failed" << std::endl;
+            exit(1);
+        }
+
+        std::thread writer(write_feed, fds[1], n_rows, interval);
+        const auto start = Clock::now();
+        std::vector<double> latencies_us;
+        latencies_us.reserve(n_rows);
+        {
+            auto reader = make_reader(fds[0]);
+            for (auto& row : *reader) {
+                const long long sent = row["sent_ns"].template get<long long>();
+                latencies_us.push_back(static_cast<double>(now_ns() - sent) / 1000.0);
+            }
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        writer.join();
+        ::close(fds[0]);
+        report(label, latencies_us, seconds);
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t n_rows = argc > 1 ? std::stoul(argv[1]) : 20000;
+    const std::chrono::microseconds interval(argc > 2 ? std::stol(argv[2]) : 50);
+    std::cout << n_rows << " rows, one every " << interval.count() << " us" << std::endl;
+
+    CSVFormat format;
+    format.delimiter(',').header_row(0);
+
+    for (long delay_us : { 0L, 1000L, 10000L }) {
+        CSVFormat fd_format = format;
+        fd_format.max_read_delay(std::chrono::microseconds(delay_us));
+        measure("CSVDescriptorSource, max_read_delay " + std::to_string(delay_us) + " us", n_rows, interval,
+            [&fd_format](int fd) {
+                return std::unique_ptr<CSVReader>(new CSVReader(CSVDescriptorSource(fd), fd_format));
+            });
+    }
+
+    // The same pipe through std::istream and StreamParser, for comparison.
+    std::unique_ptr<std::ifstream> stream;
+    measure("std::ifstream on /dev/fd", n_rows, interval,
+        [&format, &stream](int fd) {
+            stream.reset(new std::ifstream("/dev/fd/" + std::to_string(fd), std::ios::binary));
+            return std::unique_ptr<CSVReader>(new CSVReader(*stream, format));
+        });
+
+    return 0;
+}
+#else
+int main() {
+    std::cout << "Descriptor sources need a POSIX build with threads." << std::endl;
+    return 0;
+}
+#endif
@@ -40,6 +40,7 @@ namespace {
             << "  --passes <n>         Repeated runs for each configuration (default: 1)\n"
             << "  --batch-rows <n>     Rows drained per read_chunk() call (default: 50000)\n"
             << "  --no-speculative     Disable parser threading/speculative parsing\n"
+            << "  --cpus <list>        Pin parse workers to these CPUs, e.g. 0,2,4,6 (Linux)\n"
             << "\n"
             << "Size suffixes use binary units: K=1024, M=1024^2, G=1024^3.\n";
     }
@@ -91,6 +92,16 @@ namespace {
         return values;
     }
 
+    std::vector<int> parse_cpu_list(const std::string& text) {
+        std::vector<int> values;
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            values.push_back(static_cast<int>(parse_size(item)));
+        }
+        return values;
+    }
+
     std::vector<size_t> parse_count_list(const std::string& text) {
         std::vector<size_t> values;
         std::stringstream stream(text);
@@ -120,14 +131,16 @@ namespace {
         size_t file_size,
         const RunConfig& config,
         bool speculative,
-        size_t batch_rows
+        size_t batch_rows,
+        const std::vector<int>& cpus
     ) {
         csv::CSVFormat format = csv::CSVFormat::guess_csv();
         format.chunk_size(config.chunk_size);
 
         if (speculative) {
             format.speculative_parallel_min_bytes(1)
-                .speculative_parallel_threads(config.threads);
+                .speculative_parallel_threads(config.threads)
+                .parse_worker_cpus(cpus);
         }
         else {
             format.threading(false);
@@ -193,6 +206,7 @@ int main(int argc, char** argv) {
     size_t passes = 1;
     size_t batch_rows = 50000;
     bool speculative = true;
+    std::vector<int> cpus;
 
     chunk_sizes.push_back(2 * 1024 * 1024);
     chunk_sizes.push_back(4 * 1024 * 1024);
@@ -224,6 +238,9 @@ int main(int argc, char** argv) {
             else if (arg == "--batch-rows" && i + 1 < argc) {
                 batch_rows = parse_size(argv[++i]);
             }
+            else if (arg == "--cpus" && i + 1 < argc) {
+                cpus = parse_cpu_list(argv[++i]);
+            }
             else if (arg == "--no-speculative") {
                 speculative = false;
             }
@@ -262,6 +279,7 @@ int main(int argc, char** argv) {
             << " bytes=" << file_size
             << " speculative=" << (speculative ? "on" : "off")
             << " passes=" << passes
+            << " pinned_cpus=" << cpus.size()
             << '\n';
 
         print_result_header();
@@ -271,7 +289,7 @@ int main(int argc, char** argv) {
                     RunConfig config;
                     config.chunk_size = chunk_sizes[chunk_i];
                     config.threads = thread_counts[thread_i];
-                    print_result(run_once(filename, file_size, config, speculative, batch_rows));
+                    print_result(run_once(filename, file_size, config, speculative, batch_rows, cpus));
                 }
             }
         }
@@ -0,0 +1,142 @@
+#include <catch2/catch_all.hpp>
+#include "csv.hpp"
+#include "shared/file_guard.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#if CSV_ASYNC_FILE_READS
+#include <fstream>
+
+using namespace csv;
+
+namespace {
+    /** About 1.5MB of rows, some with quoted fields far longer than the
+     *  read headroom, so windows and the carried-over rows vary in size.
+     */
+    std::string write_async_csv(const std::string& filename) {
+        std::string content = "id,text,note\n";
+        for (size_t i = 0; content.size() < 1500000; ++i) {
+            content += std::to_string(i) + ",";
+            if (i % 500 == 0) {
+                content += "\"" + std::string(100000, 'x') + "\nmore\"";
+            }
+            else {
+                content += "\"row " + std::to_string(i) + ", \"\"quoted\"\"\"";
+            }
+            content += i % 3 == 0 ? ",y\r\n" : ",y\n";
+        }
+
+        std::ofstream out(filename, std::ios::binary);
+        out << content;
+        return content;
+    }
+
+    std::vector<std::vector<std::string>> read_rows(const std::string& filename, const CSVFormat& format) {
+        std::vector<std::vector<std::string>> rows;
+        CSVReader reader(filename, format);
+        for (auto& row : reader) {
+            std::vector<std::string> fields(row);
+            fields.push_back(std::to_string(row.byte_offset()));
+            rows.push_back(std::move(fields));
+        }
+        return rows;
+    }
+}
+
+TEST_CASE("Async file reads match memory-mapped reads", "[async_file]") {
+    FileGuard cleanup("./tests/data/tmp_async_file.csv");
+    write_async_csv(cleanup.filename);
+
+    CSVFormat mapped;
+    mapped.chunk_size(internals::CSV_CHUNK_SIZE_FLOOR).threading(false);
+    const auto expected = read_rows(cleanup.filename, mapped);
+    REQUIRE(expected.size() > 5000);
+
+    CSVFormat async = mapped;
+    async.file_read_mode(FileReadMode::ASYNC_READ);
+    REQUIRE(async.get_file_read_mode() == FileReadMode::ASYNC_READ);
+
+    SECTION("Double buffered") {
+        REQUIRE(read_rows(cleanup.filename, async) == expected);
+    }
+
+    SECTION("One read in flight") {
+        async.async_read_depth(1);
+        REQUIRE(read_rows(cleanup.filename, async) == expected);
+    }
+
+    SECTION("Direct I/O") {
+        async.direct_io().async_read_depth(4);
+        REQUIRE(async.is_direct_io_enabled());
+        REQUIRE(read_rows(cleanup.filename, async) == expected);
+    }
+
+#if CSV_ENABLE_THREADS
+    SECTION("Speculative parallel") {
+        async.threading(true)
+            .speculative_parallel_min_bytes(1)
+            .speculative_parallel_threads(2);
+        REQUIRE(read_rows(cleanup.filename, async) == expected);
+    }
+#endif
+
+    SECTION("Empty file") {
+        FileGuard empty("./tests/data/tmp_async_file_empty.csv");
+        std::ofstream(empty.filename, std::ios::binary).close();
+        REQUIRE(read_rows(empty.filename, async).empty());
+    }
+
+    SECTION("Missing file") {
+        REQUIRE_THROWS_AS(CSVReader("./tests/data/tmp_async_file_missing.csv", async), std::runtime_error);
+    }
+}
+
+TEST_CASE("AsyncFileReader backends return the file in order", "[async_file]") {
+    using internals::parser::AsyncFileReader;
+    using internals::parser::CSV_ASYNC_READ_ALIGNMENT;
+
+    FileGuard cleanup("./tests/data/tmp_async_file_reader.csv");
+    const std::string content = write_async_csv(cleanup.filename);
+
+    const size_t read_size = 16 * CSV_ASYNC_READ_ALIGNMENT;
+    for (bool io_uring : { true, false }) {
+        for (bool direct_io : { false, true }) {
+            INFO("io_uring allowed: " << io_uring << ", direct I/O: " << direct_io);
+            AsyncFileReader reader(cleanup.filename, 3, direct_io, io_uring);
+            REQUIRE(reader.size() == content.size());
+            if (!io_uring) {
+                REQUIRE_FALSE(reader.uses_io_uring());
+            }
+
+            std::vector<std::unique_ptr<internals::memory::StreamBuffer>> buffers;
+            for (size_t i = 0; i < 3; ++i) {
+                buffers.emplace_back(new internals::memory::StreamBuffer(read_size, CSV_ASYNC_READ_ALIGNMENT));
+            }
+
+            std::string result;
+            size_t submitted = 0;
+            size_t completed = 0;
+            for (; submitted < 3; ++submitted) {
+                reader.submit(buffers[submitted % 3]->data(), submitted * read_size, read_size);
+            }
+
+            while (result.size() < content.size()) {
+                const size_t n = reader.wait();
+                result.append(buffers[completed % 3]->data(), n);
+                completed++;
+                reader.submit(buffers[submitted % 3]->data(), submitted * read_size, read_size);
+                submitted++;
+            }
+
+            while (completed < submitted) {
+                REQUIRE(reader.wait() == 0);
+                completed++;
+            }
+
+            REQUIRE(result == content);
+        }
+    }
+}
+#endif
@@ -6,6 +6,52 @@
 using namespace csv;
 using namespace csv::internals;
 
+namespace {
+    std::string compact_with(QuoteCompactFn kernel, const std::string& field) {
+        std::string out(field.size(), '\0');
+        out.resize(kernel(field, '"', &out[0]));
+        return out;
+    }
+
+    std::string random_quoted_payload(uint32_t& seed, size_t length) {
+        const char alphabet[] = { '"', '"', '"', 'a', ',', '{' };
+        std::string field(length, 'a');
+        for (auto& ch : field) {
+            seed = seed * 1664525u + 1013904223u;
+            ch = alphabet[(seed >> 8) % sizeof(alphabet)];
+        }
+        return field;
+    }
+}
+
+TEST_CASE("Doubled-quote drop mask pairs quotes left to right across blocks", "[simd][parser]") {
+    uint64_t carry = 0;
+
+    // Runs of 1, 2, 3 and 4 quotes starting at bits 0, 4, 10 and 20.
+    const uint64_t quotes = 0x1ull | (0x3ull << 4) | (0x7ull << 10) | (0xFull << 20);
+    const uint64_t expected = (0x1ull << 5) | (0x1ull << 11) | (0x5ull << 21);
+    REQUIRE(doubled_quote_drop_mask(quotes, carry) == expected);
+    REQUIRE(carry == 0);
+
+    // A lone quote at bit 63 pairs with bit 0 of the next block.
+    REQUIRE(doubled_quote_drop_mask(uint64_t(1) << 63, carry) == 0);
+    REQUIRE(carry == 1);
+    REQUIRE(doubled_quote_drop_mask(0x3ull, carry) == 0x1ull);
+    REQUIRE(carry == 0);
+}
+
+TEST_CASE("Doubled-quote compaction matches the reference loop", "[simd][parser]") {
+    uint32_t seed = 777;
+    for (size_t length = 0; length < 400; length += 3) {
+        const std::string field = random_quoted_payload(seed, length);
+        REQUIRE(compact_with(&compact_doubled_quotes, field)
+            == compact_with(&compact_doubled_quotes_scalar, field));
+    }
+
+    const std::string json = "{\"\"id\"\": 1, \"\"tags\"\": [\"\"a\"\", \"\"b\"\"]}";
+    REQUIRE(compact_with(&compact_doubled_quotes, json) == "{\"id\": 1, \"tags\": [\"a\", \"b\"]}");
+}
+
 #if defined(CSV_SIMD_AVX2) || defined(CSV_SIMD_SSE2) || defined(CSV_SIMD_NEON)
 
 // find_next_non_special is SIMD-only: it fast-forwards through complete lanes
@@ -106,4 +152,134 @@ TEST_CASE("SIMD skip treats UTF-8 bytes as non-special content", "[simd][parser]
     REQUIRE(pos == data.size());
 }
 
+TEST_CASE("SIMD quote skip only stops at the quote character", "[simd][parser]") {
+    const SentinelVecs sentinels(',', '"');
+
+    std::string data(192, 'a');
+    for (size_t i = 0; i < 90; i += 7) {
+        data[i] = ',';
+        data[i + 1] = '\n';
+        data[i + 2] = '\r';
+    }
+    data[101] = '"';
+
+    REQUIRE(find_next_quote(data, 0, sentinels) == 101);
+    REQUIRE(find_next_non_special(data, 0, sentinels) == 0);
+}
+
+TEST_CASE("SIMD quote skip returns end for a quote-free run", "[simd][parser]") {
+    const SentinelVecs sentinels(';', '\'');
+
+    std::string data(512, ';');
+    REQUIRE(find_next_quote(data, 0, sentinels) == data.size());
+}
+
+#endif
+
+#if defined(CSV_SIMD_DISPATCH)
+
+// Runtime dispatch compiles every x86 kernel into the same binary. Exercise
+// each tier the host can execute so AVX-512 regressions do not hide behind
+// whichever kernel the dispatcher happens to pick.
+TEST_CASE("SIMD dispatch selects a kernel the host supports", "[simd][parser]") {
+    const SIMDLevel level = active_simd_level();
+
+    REQUIRE(level == detect_simd_level());
+    REQUIRE(level != SIMDLevel::SCALAR);
+    REQUIRE(sentinel_scan_kernel(level) != nullptr);
+}
+
+TEST_CASE("SIMD kernels agree at every supported tier", "[simd][parser]") {
+    const SIMDLevel level = GENERATE(SIMDLevel::SSE2, SIMDLevel::AVX2, SIMDLevel::AVX512);
+    const SentinelScanFn kernel = sentinel_scan_kernel(level);
+    const SentinelScanFn quote_kernel = quote_scan_kernel(level);
+    if (kernel == nullptr || static_cast<int>(level) > static_cast<int>(detect_simd_level())) {
+        return;
+    }
+    REQUIRE(quote_kernel != nullptr);
+
+    const SentinelVecs sentinels(';', '\'');
+    const char specials[] = { ';', '\'', '\n', '\r' };
+
+    uint32_t seed = 12345;
+    auto next_random = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+
+    for (size_t trial = 0; trial < 200; ++trial) {
+        std::string data(300, 'q');
+        const size_t target = next_random() % data.size();
+        data[target] = specials[next_random() % 4];
+
+        const size_t start = next_random() % (target + 1);
+        const size_t pos = kernel(data, start, sentinels);
+
+        // Kernels may stop short of the target only when a full lane no longer fits.
+        if (pos != target) {
+            REQUIRE(pos < target);
+            REQUIRE(data.size() - pos < 64);
+        }
+
+        const size_t quote_pos = quote_kernel(data, start, sentinels);
+        if (data[target] == '\'') {
+            if (quote_pos != target) {
+                REQUIRE(quote_pos < target);
+                REQUIRE(data.size() - quote_pos < 64);
+            }
+        }
+        else {
+            REQUIRE(data.size() - quote_pos < 64);
+        }
+    }
+
+    std::string clean(256, 'q');
+    REQUIRE(kernel(clean, 0, sentinels) == clean.size());
+    REQUIRE(quote_kernel(clean, 0, sentinels) == clean.size());
+}
+
+TEST_CASE("Unquoted structural masks agree at every supported tier", "[simd][parser]") {
+    const SIMDLevel level = GENERATE(SIMDLevel::SSE2, SIMDLevel::AVX2, SIMDLevel::AVX512);
+    const StructuralMaskFn kernel = structural_mask_kernel<false>(level);
+    if (kernel == nullptr || static_cast<int>(level) > static_cast<int>(detect_simd_level())) {
+        return;
+    }
+
+    const SentinelVecs sentinels('\t', '\t');
+    uint32_t seed = 99;
+    for (size_t trial = 0; trial < 200; ++trial) {
+        std::string block(STRUCTURAL_BLOCK_SIZE, 'x');
+        for (auto& ch : block) {
+            seed = seed * 1664525u + 1013904223u;
+            const char alphabet[] = { 'x', '\t', '\n', '\r', '"' };
+            ch = alphabet[(seed >> 8) % sizeof(alphabet)];
+        }
+
+        StructuralBlockMasks expected;
+        StructuralBlockMasks actual;
+        structural_block_masks_scalar<false>(block.data(), sentinels, expected);
+        kernel(block.data(), sentinels, actual);
+
+        REQUIRE(actual.delim == expected.delim);
+        REQUIRE(actual.lf == expected.lf);
+        REQUIRE(actual.cr == expected.cr);
+        REQUIRE(actual.quote == 0);
+        REQUIRE(actual.quote_prefix == 0);
+    }
+}
+
+TEST_CASE("Doubled-quote compaction agrees at every supported tier", "[simd][parser]") {
+    const SIMDLevel level = GENERATE(SIMDLevel::SSE2, SIMDLevel::AVX2, SIMDLevel::AVX512);
+    const QuoteCompactFn kernel = quote_compact_kernel(level);
+    if (kernel == nullptr || static_cast<int>(level) > static_cast<int>(detect_simd_level())) {
+        return;
+    }
+
+    uint32_t seed = 4242;
+    for (size_t length = 0; length < 600; length += 7) {
+        const std::string field = random_quoted_payload(seed, length);
+        REQUIRE(compact_with(kernel, field) == compact_with(&compact_doubled_quotes_scalar, field));
+    }
+}
+
 #endif
@@ -0,0 +1,86 @@
+#include <catch2/catch_all.hpp>
+#include "csv.hpp"
+#include "shared/file_guard.hpp"
+
+#include <string>
+#include <vector>
+
+#if !defined(__EMSCRIPTEN__)
+#include <fstream>
+
+using namespace csv;
+
+namespace {
+    /** Quoted fields hold delimiters, escaped quotes and whole fake records. */
+    std::string write_split_csv(const std::string& filename, size_t n_rows) {
+        std::string content = "id,text,note\r\n";
+        for (size_t i = 0; i < n_rows; ++i) {
+            content += std::to_string(i) + ",";
+            switch (i % 4) {
+            case 0: content += "\"fake,row\n1,2,3\n\""; break;
+            case 1: content += "\"say \"\"hi\"\"\""; break;
+            case 2: content += "\"\""; break;
+            default: content += "plain"; break;
+            }
+            content += i % 3 == 0 ? ",x\r\n" : ",x\n";
+        }
+
+        std::ofstream out(filename, std::ios::binary);
+        out << content;
+        return content;
+    }
+
+    std::vector<size_t> split_offsets(const std::string& filename, size_t file_size, size_t length, const CSVFormat& format) {
+        std::vector<size_t> offsets;
+        for (size_t offset = 0; offset < file_size; offset += length) {
+            CSVReader reader(filename, offset, length, format);
+            REQUIRE(reader.get_col_names() == std::vector<std::string>({ "id", "text", "note" }));
+            for (auto& row : reader) {
+                REQUIRE(row["note"] == "x");
+                offsets.push_back(row.byte_offset());
+            }
+        }
+        return offsets;
+    }
+}
+
+TEST_CASE("Byte range readers tile a file", "[byte_range]") {
+    FileGuard cleanup("./tests/data/tmp_byte_range.csv");
+    const std::string content = write_split_csv(cleanup.filename, 2000);
+
+    CSVFormat format;
+    format.delimiter(',').header_row(0);
+
+    std::vector<size_t> expected;
+    CSVReader whole(cleanup.filename, format);
+    for (auto& row : whole) {
+        expected.push_back(row.byte_offset());
+    }
+    REQUIRE(expected.size() == 2000);
+
+    for (size_t length : { size_t(1000), content.size() / 3 + 1, content.size() }) {
+        INFO("Split length " << length);
+        REQUIRE(split_offsets(cleanup.filename, content.size(), length, format) == expected);
+        REQUIRE(split_offsets(cleanup.filename, content.size(), length, CSVFormat::guess_csv()) == expected);
+    }
+}
+
+TEST_CASE("Byte range readers resync inside quoted fields", "[byte_range]") {
+    FileGuard cleanup("./tests/data/tmp_byte_range_quoted.csv");
+    const std::string content = write_split_csv(cleanup.filename, 100);
+
+    // Start inside the quoted "1,2,3" record of row 8.
+    const size_t fake_record = content.find("1,2,3", content.find("\n8,"));
+    CSVReader reader(cleanup.filename, fake_record, content.size());
+
+    auto it = reader.begin();
+    REQUIRE(it != reader.end());
+    REQUIRE((*it)["id"].get<int>() == 9);
+    REQUIRE((*it).byte_offset() == content.find("\n9,") + 1);
+
+    SECTION("Ranges past the end are empty") {
+        CSVReader past(cleanup.filename, content.size() + 10, 100);
+        REQUIRE(past.begin() == past.end());
+    }
+}
+#endif
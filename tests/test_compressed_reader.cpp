@@ -0,0 +1,211 @@
+#include <catch2/catch_all.hpp>
+#include "csv.hpp"
+#include "shared/file_guard.hpp"
+
+#include <string>
+#include <vector>
+
+#if CSV_COMPRESSED_SOURCES && CSV_HAS_ZLIB
+#include <fstream>
+#include <sstream>
+#include <zlib.h>
+#if CSV_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace csv;
+
+namespace {
+    void put16(std::string& out, unsigned long value) {
+        out += static_cast<char>(value & 0xff);
+        out += static_cast<char>((value >> 8) & 0xff);
+    }
+
+    void put32(std::string& out, unsigned long value) {
+        put16(out, value & 0xffff);
+        put16(out, (value >> 16) & 0xffff);
+    }
+
+    std::string deflate_bytes(const std::string& in, int window_bits) {
+        z_stream z = {};
+        deflateInit2(&z, 6, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY);
+        std::string out(deflateBound(&z, static_cast<uLong>(in.size())) + 64, '\0');
+        z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+        z.avail_in = static_cast<uInt>(in.size());
+        z.next_out = reinterpret_cast<Bytef*>(&out[0]);
+        z.avail_out = static_cast<uInt>(out.size());
+        deflate(&z, Z_FINISH);
+        out.resize(z.total_out);
+        deflateEnd(&z);
+        return out;
+    }
+
+    std::string gzip_member(const std::string& in) {
+        return deflate_bytes(in, 15 + 16);
+    }
+
+    /** A gzip member with the BC extra field bgzip writes. */
+    std::string bgzf_block(const std::string& in) {
+        const std::string body = deflate_bytes(in, -15);
+        std::string block("\x1f\x8b\x08\x04", 4);
+        put32(block, 0);
+        block += '\0';
+        block += '\xff';
+        put16(block, 6);
+        block += "BC";
+        put16(block, 2);
+        put16(block, 18 + body.size() + 8 - 1);
+        block += body;
+        put32(block, crc32(0, reinterpret_cast<const Bytef*>(in.data()), static_cast<uInt>(in.size())));
+        put32(block, in.size());
+        return block;
+    }
+
+    template<typename Encode>
+    std::string encode_pieces(const std::string& csv, size_t piece_size, Encode encode) {
+        std::string out;
+        for (size_t i = 0; i < csv.size(); i += piece_size) {
+            out += encode(csv.substr(i, piece_size));
+        }
+        return out;
+    }
+
+    std::string make_csv(size_t rows) {
+        std::ostringstream out;
+        out << "id,name,note\r\n";
+        for (size_t i = 0; i < rows; ++i) {
+            out << i << ",name" << i << ",";
+            if (i % 7 == 0) {
+                out << "\"multi\nline " << i << "\"";
+            }
+            else {
+                out << "plain note " << i * 31;
+            }
+            out << "\r\n";
+        }
+        return out.str();
+    }
+
+    void write_file(const std::string& filename, const std::string& contents) {
+        std::ofstream out(filename, std::ios::binary);
+        out << contents;
+    }
+
+    struct ReadRow {
+        std::vector<std::string> fields;
+        size_t byte_offset;
+
+        bool operator==(const ReadRow& other) const {
+            return fields == other.fields && byte_offset == other.byte_offset;
+        }
+    };
+
+    std::vector<ReadRow> read_all(CSVReader& reader) {
+        std::vector<ReadRow> rows;
+        for (auto& row : reader) {
+            ReadRow read = { {}, row.byte_offset() };
+            for (auto& field : row) {
+                read.fields.push_back(field.get<std::string>());
+            }
+            rows.push_back(read);
+        }
+        return rows;
+    }
+
+    std::vector<ReadRow> read_compressed(const std::string& filename, bool threading, bool guess) {
+        CSVFormat format;
+        if (!guess) {
+            format.delimiter(',').header_row(0);
+        }
+        format.threading(threading).chunk_size(512000);
+
+        CSVReader reader(CSVCompressedSource{ filename }, format);
+        auto rows = read_all(reader);
+        REQUIRE(reader.get_col_names() == std::vector<std::string>({ "id", "name", "note" }));
+        return rows;
+    }
+}
+
+TEST_CASE("Compressed source matches the uncompressed file", "[compressed_source]") {
+    const bool threading = GENERATE(false, true);
+    const bool guess = GENERATE(false, true);
+    INFO("threading: " << threading << ", guess format: " << guess);
+
+    // Several windows' worth, so decoding overlaps parsing
+    const std::string csv = make_csv(100000);
+    FileGuard plain("./tests/data/tmp_compressed_source.csv");
+    write_file(plain.filename, csv);
+
+    std::vector<ReadRow> expected;
+    {
+        CSVReader reader(plain.filename);
+        expected = read_all(reader);
+    }
+    REQUIRE(expected.size() == 100000);
+
+    FileGuard compressed("./tests/data/tmp_compressed_source.gz");
+
+    SECTION("BGZF blocks") {
+        write_file(compressed.filename, encode_pieces(csv, 65280, bgzf_block) + bgzf_block(""));
+        REQUIRE(read_compressed(compressed.filename, threading, guess) == expected);
+    }
+
+    SECTION("Concatenated gzip members") {
+        write_file(compressed.filename, encode_pieces(csv, csv.size() / 3 + 1, gzip_member));
+        REQUIRE(read_compressed(compressed.filename, threading, guess) == expected);
+    }
+
+    SECTION("BGZF blocks followed by a plain gzip member") {
+        const size_t half = csv.size() / 2;
+        write_file(compressed.filename,
+            encode_pieces(csv.substr(0, half), 65280, bgzf_block) + gzip_member(csv.substr(half)));
+        REQUIRE(read_compressed(compressed.filename, threading, guess) == expected);
+    }
+
+#if CSV_HAS_ZSTD
+    SECTION("zstd frames with and without a content size") {
+        size_t frame = 0;
+        write_file(compressed.filename, encode_pieces(csv, 700000, [&frame](const std::string& piece) {
+            std::string out(ZSTD_compressBound(piece.size()), '\0');
+            ZSTD_CCtx* context = ZSTD_createCCtx();
+            ZSTD_CCtx_setParameter(context, ZSTD_c_contentSizeFlag, (frame++ % 2) == 0);
+            out.resize(ZSTD_compress2(context, &out[0], out.size(), piece.data(), piece.size()));
+            ZSTD_freeCCtx(context);
+            return out;
+        }));
+        REQUIRE(read_compressed(compressed.filename, threading, guess) == expected);
+    }
+#endif
+}
+
+TEST_CASE("Compressed source rejects damaged input", "[compressed_source]") {
+    const std::string csv = make_csv(20000);
+    FileGuard cleanup("./tests/data/tmp_compressed_source_bad.gz");
+
+    CSVFormat format;
+    format.delimiter(',').header_row(0);
+
+    SECTION("Not compressed") {
+        write_file(cleanup.filename, csv);
+        REQUIRE_THROWS_WITH(
+            [&]() {
+                CSVReader reader(CSVCompressedSource{ cleanup.filename }, format);
+                read_all(reader);
+            }(),
+            Catch::Matchers::ContainsSubstring("not a gzip member or zstd frame")
+        );
+    }
+
+    SECTION("Truncated member") {
+        const std::string member = gzip_member(csv);
+        write_file(cleanup.filename, member.substr(0, member.size() - 100));
+        REQUIRE_THROWS_WITH(
+            [&]() {
+                CSVReader reader(CSVCompressedSource{ cleanup.filename }, format);
+                read_all(reader);
+            }(),
+            Catch::Matchers::ContainsSubstring("Decompression failed")
+        );
+    }
+}
+#endif
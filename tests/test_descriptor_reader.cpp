@@ -0,0 +1,112 @@
+#include <catch2/catch_all.hpp>
+#include "csv.hpp"
+#include "shared/file_guard.hpp"
+
+#include <string>
+#include <vector>
+
+#if CSV_DESCRIPTOR_SOURCES && CSV_ENABLE_THREADS
+#include <chrono>
+#include <fcntl.h>
+#include <fstream>
+#include <future>
+#include <thread>
+#include <unistd.h>
+
+using namespace csv;
+
+TEST_CASE("Descriptor source delivers rows before more input arrives", "[descriptor_source]") {
+    const bool threading = GENERATE(false, true);
+    const bool guess = GENERATE(false, true);
+    INFO("threading: " << threading << ", guess format: " << guess);
+
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+
+    // The writer holds back the rest of the feed until the reader has seen
+    // the first row, so a reader waiting for a full window would time out.
+    std::promise<void> first_row;
+    std::future<void> first_row_seen = first_row.get_future();
+    bool delivered_early = false;
+    std::thread writer([&]() {
+        const std::string head = "a,b\n1,2\n";
+        (void)::write(fds[1], head.data(), head.size());
+        delivered_early = first_row_seen.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+
+        const std::string rest = "3,\"x\ny\"\r\n5,6";
+        (void)::write(fds[1], rest.data(), rest.size());
+        ::close(fds[1]);
+    });
+
+    CSVFormat format;
+    if (!guess) {
+        format.delimiter(',').header_row(0);
+    }
+    format.threading(threading);
+
+    std::vector<std::string> values;
+    std::vector<size_t> offsets;
+    std::vector<std::string> col_names;
+    {
+        CSVReader reader(CSVDescriptorSource{ fds[0] }, format);
+        for (auto& row : reader) {
+            values.push_back(row["b"].get<std::string>());
+            offsets.push_back(row.byte_offset());
+            if (values.size() == 1) {
+                first_row.set_value();
+            }
+        }
+        col_names = reader.get_col_names();
+    }
+
+    writer.join();
+    ::close(fds[0]);
+
+    REQUIRE(delivered_early);
+    REQUIRE(col_names == std::vector<std::string>({ "a", "b" }));
+    REQUIRE(values == std::vector<std::string>({ "2", "x\ny", "6" }));
+    REQUIRE(offsets == std::vector<size_t>({ 4, 8, 17 }));
+}
+
+TEST_CASE("Descriptor source over a regular file matches the file reader", "[descriptor_source]") {
+    FileGuard cleanup("./tests/data/tmp_descriptor_source.csv");
+    {
+        std::ofstream out(cleanup.filename, std::ios::binary);
+        out << "id,text\n";
+        for (size_t i = 0; i < 20000; ++i) {
+            out << i << ",\"row " << i << ", \"\"quoted\"\"\"" << (i % 3 == 0 ? "\r\n" : "\n");
+        }
+    }
+
+    auto read_rows = [](CSVReader& reader) {
+        std::vector<std::vector<std::string>> rows;
+        for (auto& row : reader) {
+            std::vector<std::string> fields(row);
+            fields.push_back(std::to_string(row.byte_offset()));
+            rows.push_back(std::move(fields));
+        }
+        return rows;
+    };
+
+    CSVReader file_reader(cleanup.filename);
+    const auto expected = read_rows(file_reader);
+    REQUIRE(expected.size() == 20000);
+
+    const long delay_us = GENERATE(0L, 2000L);
+    CSVFormat format;
+    format.max_read_delay(std::chrono::microseconds(delay_us));
+    REQUIRE(format.get_max_read_delay() == std::chrono::microseconds(delay_us));
+
+    const int fd = ::open(cleanup.filename.c_str(), O_RDONLY);
+    REQUIRE(fd >= 0);
+    {
+        CSVReader reader(CSVDescriptorSource{ fd }, format);
+        REQUIRE(read_rows(reader) == expected);
+    }
+    ::close(fd);
+}
+
+TEST_CASE("Descriptor source reports read failures", "[descriptor_source]") {
+    REQUIRE_THROWS_AS(CSVReader(CSVDescriptorSource(-1)), std::runtime_error);
+}
+#endif
@@ -262,7 +262,7 @@ TEST_CASE("Issue #218 - Infinite read loop detection", "[issue_218]") {
     }
 }
 
-// Verify parse_unsafe() (non-owning StringViewStream path) delivers correct values
+// Verify parse_unsafe() (non-owning MemoryParser path) delivers correct values
 // across the 10MB chunk boundary. Distinct per-column values (i*5+col) ensure that
 // field corruption or mis-alignment at a chunk transition would be detected.
 TEST_CASE("parse_unsafe() chunk boundary integrity", "[parse_unsafe_chunk_boundary]") {
@@ -0,0 +1,149 @@
+#include <catch2/catch_all.hpp>
+#include "csv.hpp"
+#include "shared/file_guard.hpp"
+
+#include <string>
+#include <vector>
+
+#if CSV_FOLLOW_FILES
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+using namespace csv;
+
+namespace {
+    void write_file(const std::string& filename, const std::string& contents, bool append) {
+        std::ofstream out(filename, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+        out << contents;
+    }
+
+    /** Append `contents` once the reader has had time to start waiting for it. */
+    std::thread append_later(const std::string& filename, const std::string& contents) {
+        return std::thread([filename, contents]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            write_file(filename, contents, true);
+        });
+    }
+
+    CSVFollowSource follow(const std::string& filename, const CSVCheckpoint& resume_from = CSVCheckpoint()) {
+        return CSVFollowSource(filename, resume_from, std::chrono::milliseconds(50));
+    }
+}
+
+TEST_CASE("Following a file reads rows as they are appended", "[follow_source]") {
+    const bool threading = GENERATE(false, true);
+    const bool guess = GENERATE(false, true);
+    INFO("threading: " << threading << ", guess format: " << guess);
+
+    FileGuard cleanup("./tests/data/tmp_follow_source.csv");
+    write_file(cleanup.filename, "a,b\r\n1,2\r\n", false);
+
+    CSVFormat format;
+    if (!guess) {
+        format.delimiter(',').header_row(0);
+    }
+    format.threading(threading);
+
+    CSVCheckpoint saved;
+    {
+        CSVReader reader(follow(cleanup.filename), format);
+        REQUIRE(reader.get_col_names() == std::vector<std::string>({ "a", "b" }));
+
+        CSVRow row;
+        REQUIRE(reader.read_row(row));
+        REQUIRE(row["b"] == "2");
+        REQUIRE(row.byte_offset() == 5);
+
+        // The incomplete row is held back until the rest of it is written.
+        write_file(cleanup.filename, "3,\"x", true);
+        std::thread writer = append_later(cleanup.filename, "\ny\"\r");
+        REQUIRE(reader.read_row(row));
+        writer.join();
+        REQUIRE(row["b"] == "x\ny");
+        REQUIRE(row.byte_offset() == 10);
+
+        // The row ended at a CR whose LF has not been written yet.
+        saved = reader.checkpoint();
+        REQUIRE(saved.byte_offset == 18);
+        REQUIRE(saved.state.pending_linefeed);
+
+        write_file(cleanup.filename, "\n5,6\n7,8\n", true);
+        REQUIRE(reader.read_row(row));
+        REQUIRE(row["a"] == "5");
+        REQUIRE(row.byte_offset() == 19);
+        REQUIRE(reader.checkpoint().byte_offset == 23);
+    }
+
+    SECTION("Resume from a checkpoint") {
+        CSVReader reader(follow(cleanup.filename, saved), format);
+        REQUIRE(reader.get_col_names() == std::vector<std::string>({ "a", "b" }));
+
+        CSVRow row;
+        REQUIRE(reader.read_row(row));
+        REQUIRE(row["a"] == "5");
+        REQUIRE(row.byte_offset() == 19);
+        REQUIRE(reader.read_row(row));
+        REQUIRE(row["a"] == "7");
+        REQUIRE(reader.checkpoint().byte_offset == 27);
+    }
+}
+
+TEST_CASE("Following a file survives rotation and truncation", "[follow_source]") {
+    const bool threading = GENERATE(false, true);
+    INFO("threading: " << threading);
+
+    FileGuard cleanup("./tests/data/tmp_follow_rotation.csv");
+    FileGuard rotated(cleanup.filename + ".1");
+    write_file(cleanup.filename, "a,b\n1,2\n", false);
+
+    CSVFormat format;
+    format.delimiter(',').header_row(0).threading(threading);
+
+    CSVReader reader(follow(cleanup.filename), format);
+    CSVRow row;
+    REQUIRE(reader.read_row(row));
+    const CSVCheckpoint before_rotation = reader.checkpoint();
+
+    // The old file's last row needs no line break once a new file replaces it.
+    write_file(cleanup.filename, "3,4", true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(std::rename(cleanup.filename.c_str(), rotated.filename.c_str()) == 0);
+    write_file(cleanup.filename, "a,b\n5,6\n", false);
+
+    REQUIRE(reader.read_row(row));
+    REQUIRE(row["a"] == "3");
+    REQUIRE(row["b"] == "4");
+    REQUIRE(reader.read_row(row));
+    REQUIRE(row["a"] == "5");
+    REQUIRE(row.byte_offset() == 4);
+
+    const CSVCheckpoint after_rotation = reader.checkpoint();
+    REQUIRE(after_rotation.byte_offset == 8);
+    REQUIRE(after_rotation.inode != before_rotation.inode);
+
+    // Truncated in place: reading restarts after the new header.
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    write_file(cleanup.filename, "a,b\n", false);
+    std::thread writer = append_later(cleanup.filename, "7,8\n");
+    REQUIRE(reader.read_row(row));
+    writer.join();
+    REQUIRE(row["a"] == "7");
+    REQUIRE(row.byte_offset() == 4);
+
+    SECTION("A checkpoint of a rotated file starts after the new header") {
+        CSVReader resumed(follow(cleanup.filename, before_rotation), format);
+        REQUIRE(resumed.read_row(row));
+        REQUIRE(row["a"] == "7");
+    }
+}
+
+TEST_CASE("Only following readers have checkpoints", "[follow_source]") {
+    FileGuard cleanup("./tests/data/tmp_follow_checkpoint.csv");
+    write_file(cleanup.filename, "a,b\n1,2\n", false);
+
+    CSVReader reader(cleanup.filename);
+    REQUIRE_THROWS_AS(reader.checkpoint(), std::logic_error);
+}
+#endif
@@ -828,4 +828,53 @@ TEST_CASE("No-header n_cols inference with explicit delimiter", "[no_header_ncol
         validate_reader(reader);
     }
 }
+
+TEST_CASE("Whole-file mmap yields the same rows as windowed mmap", "[csv_format][mmap_whole_file]") {
+    FileGuard cleanup("./tests/data/tmp_mmap_whole_file.csv");
+    {
+        std::ofstream out(cleanup.filename, std::ios::binary);
+        out << "id,text,tail\r\n";
+        for (size_t i = 0; out.tellp() < static_cast<std::streamoff>(3 * internals::CSV_CHUNK_SIZE_FLOOR + 1234); ++i) {
+            out << i << ",\"line one\nline \"\"two\"\"\"," << std::string(i % 97, 'x') << "\r\n";
+        }
+    }
+
+    auto read_all = [&](const CSVFormat& format) {
+        CSVReader reader(cleanup.filename, format);
+        std::vector<std::vector<std::string>> rows;
+        for (auto& row : reader) {
+            rows.push_back(std::vector<std::string>(row));
+        }
+        return rows;
+    };
+
+    CSVFormat windowed;
+    windowed.chunk_size(internals::CSV_CHUNK_SIZE_FLOOR).threading(false);
+    REQUIRE_FALSE(windowed.is_mmap_whole_file_enabled());
+    const auto expected = read_all(windowed);
+    REQUIRE(expected.size() > 1000);
+
+    CSVFormat whole_file = windowed;
+    whole_file.mmap_whole_file();
+    REQUIRE(whole_file.is_mmap_whole_file_enabled());
+
+    SECTION("Serial") {
+        REQUIRE(read_all(whole_file) == expected);
+    }
+
+    SECTION("Huge pages requested") {
+        whole_file.mmap_huge_pages();
+        REQUIRE(whole_file.is_mmap_huge_pages_enabled());
+        REQUIRE(read_all(whole_file) == expected);
+    }
+
+#if CSV_ENABLE_THREADS
+    SECTION("Speculative parallel") {
+        whole_file.threading(true)
+            .speculative_parallel_min_bytes(1)
+            .speculative_parallel_threads(2);
+        REQUIRE(read_all(whole_file) == expected);
+    }
+#endif
+}
 #endif
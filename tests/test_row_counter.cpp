@@ -0,0 +1,183 @@
+#include <catch2/catch_all.hpp>
+#include "csv.hpp"
+#include "shared/file_guard.hpp"
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if !defined(__EMSCRIPTEN__)
+#include <fstream>
+#endif
+
+using namespace csv;
+
+namespace {
+    std::vector<size_t> reader_offsets(const std::string& content, const CSVFormat& format) {
+        std::vector<size_t> offsets;
+        CSVReader reader(CSVMemorySource(content), format);
+        for (auto& row : reader) {
+            offsets.push_back(row.byte_offset());
+        }
+        return offsets;
+    }
+
+    /** Rows of one to four fields with quoted commas, newlines and escaped quotes, plus stray bytes. */
+    std::string random_csv(std::mt19937& rng, size_t length) {
+        const char noise[] = "ab,\"\n\r x";
+        std::string content;
+        while (content.size() < length) {
+            if (rng() % 8 == 0) {
+                content += noise[rng() % (sizeof(noise) - 1)];
+                continue;
+            }
+
+            const size_t fields = 1 + rng() % 4;
+            for (size_t i = 0; i < fields; ++i) {
+                if (i > 0) content += ',';
+                if (rng() % 3 == 0) {
+                    content += rng() % 2 ? "\"x,\ny\"\"z\"" : "\"x,\r\ny\"";
+                }
+                else {
+                    content += "value";
+                }
+            }
+            content += rng() % 5 == 0 ? "\r\n" : "\n";
+        }
+        return content;
+    }
+}
+
+TEST_CASE("count_rows matches CSVReader on edge cases", "[row_counter]") {
+    auto check = [](const std::string& content, CSVFormat format) {
+        format.delimiter(',');
+        const std::vector<size_t> expected = reader_offsets(content, format);
+        CSVRowCount count = count_rows(CSVMemorySource(content), format, true);
+        INFO(content);
+        REQUIRE(count.n_rows == expected.size());
+        REQUIRE(count.row_offsets == expected);
+    };
+
+    CSVFormat header;
+    header.header_row(0);
+    CSVFormat keep;
+    keep.no_header().variable_columns(VariableColumnPolicy::KEEP);
+    CSVFormat keep_non_empty;
+    keep_non_empty.header_row(1).variable_columns(VariableColumnPolicy::KEEP_NON_EMPTY);
+
+    const std::vector<std::string> inputs = {
+        "",
+        "a,b",
+        "a,b\n1,2",
+        "a,b\r\n1,2\r\n3,4\r\n",
+        "a,b\r1,2\r3,4\r",
+        "a,b\n\n1,2\n\r\n3,4\n",
+        "\xEF\xBB\xBF" "a,b\n1,2\n",
+        "a,b\n\"x\ny\",2\n\"\"\"\",\"q\"\"\n\"\n",
+        "a,b\nx\"y,\"z\n1,2\n",
+        "a,b\n\"x\"y\n,\"\n1,2\n",
+        "a,b\n1,2,3\n4\n5,6\n",
+        "a,b\n1,\n,\n\"\",\"\"",
+    };
+
+    for (const auto& content : inputs) {
+        check(content, header);
+        check(content, keep);
+        check(content, keep_non_empty);
+    }
+}
+
+TEST_CASE("count_rows reports the widest record", "[row_counter]") {
+    CSVFormat format;
+    format.delimiter(',').header_row(0).variable_columns(VariableColumnPolicy::KEEP);
+
+    CSVRowCount count = count_rows(CSVMemorySource("a,b\n1,2,3,4\n\"x,y,z\",5\n"), format);
+    REQUIRE(count.n_rows == 2);
+    REQUIRE(count.max_fields == 4);
+    REQUIRE(count.row_offsets.empty());
+    REQUIRE(count.format.get_delim() == ',');
+}
+
+TEST_CASE("count_rows throws like CSVReader under VariableColumnPolicy::THROW", "[row_counter]") {
+    CSVFormat format;
+    format.delimiter(',').header_row(0).variable_columns(VariableColumnPolicy::THROW);
+
+    REQUIRE(count_rows(CSVMemorySource("a,b\n1,2\n3,4\n"), format).n_rows == 2);
+    REQUIRE_THROWS_AS(count_rows(CSVMemorySource("a,b\n1,2\n3\n"), format), std::runtime_error);
+    REQUIRE_THROWS_AS(count_rows(CSVMemorySource("a,b\n1,2,3\n"), format), std::runtime_error);
+}
+
+TEST_CASE("count_rows guesses the format like CSVReader", "[row_counter]") {
+    const std::string content = "x|y|z\n1|2|3\n4|5|6\n7|8|9\n";
+    CSVRowCount count = count_rows(CSVMemorySource(content));
+
+    CSVReader reader{ CSVMemorySource(content) };
+    for (auto& row : reader) { (void)row; }
+
+    REQUIRE(count.format.get_delim() == '|');
+    REQUIRE(count.n_rows == reader.n_rows());
+    REQUIRE(count.max_fields == 3);
+}
+
+TEST_CASE("count_rows parallel chunks match CSVReader", "[row_counter][speculative]") {
+    std::mt19937 rng(20261017);
+
+    for (size_t iteration = 0; iteration < 8; ++iteration) {
+        const std::string content = random_csv(rng, 300000 + rng() % 200000);
+
+        CSVFormat format;
+        format.delimiter(',')
+            .no_header()
+            .variable_columns(VariableColumnPolicy::KEEP_NON_EMPTY)
+            .chunk_size(internals::CSV_CHUNK_SIZE_FLOOR)
+            .speculative_parallel_min_bytes(1)
+            .speculative_parallel_threads(4);
+
+        const std::vector<size_t> expected = reader_offsets(content, format);
+        CSVRowCount count = count_rows(CSVMemorySource(content), format, true);
+        REQUIRE(count.n_rows == expected.size());
+        REQUIRE(count.row_offsets == expected);
+
+#if CSV_ENABLE_THREADS
+        REQUIRE(count.parse_worker_count == 4);
+        REQUIRE(count.speculative_diagnostics.chunks > 1);
+#endif
+    }
+}
+
+#if !defined(__EMSCRIPTEN__)
+TEST_CASE("count_rows and get_file_info read files", "[row_counter][test_file_info]") {
+    FileGuard cleanup("./tests/data/tmp_row_counter.csv");
+    {
+        std::ofstream out(cleanup.filename, std::ios::binary);
+        out << "id,name\n";
+        for (size_t i = 0; i < 1000; ++i) {
+            out << i << ",\"name " << i << ",\nsecond line\"\n";
+        }
+    }
+
+    CSVRowCount count = count_rows(cleanup.filename);
+    REQUIRE(count.n_rows == 1000);
+    REQUIRE(count.max_fields == 2);
+
+    CSVFileInfo info = get_file_info(cleanup.filename);
+    REQUIRE(info.n_rows == 1000);
+    REQUIRE(info.n_cols == 2);
+    REQUIRE(info.delim == ',');
+    REQUIRE(info.col_names == std::vector<std::string>({ "id", "name" }));
+
+    SECTION("empty file") {
+        FileGuard empty("./tests/data/tmp_row_counter_empty.csv");
+        { std::ofstream out(empty.filename, std::ios::binary); }
+
+        CSVFormat format;
+        format.delimiter(',').header_row(0);
+        REQUIRE(count_rows(empty.filename, format).n_rows == 0);
+    }
+
+    SECTION("missing file") {
+        REQUIRE_THROWS(count_rows("./tests/data/no_such_row_counter_file.csv"));
+    }
+}
+#endif
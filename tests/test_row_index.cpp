@@ -0,0 +1,144 @@
+#include <catch2/catch_all.hpp>
+#include "csv.hpp"
+#include "shared/file_guard.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if !defined(__EMSCRIPTEN__)
+#include <fstream>
+
+using namespace csv;
+
+namespace {
+    /** Rows with quoted newlines, CRLF endings and short rows that IGNORE_ROW drops. */
+    void write_indexed_csv(const std::string& filename, size_t n_rows) {
+        std::ofstream out(filename, std::ios::binary);
+        out << "id,name,note\n";
+        for (size_t i = 0; i < n_rows; ++i) {
+            out << i << ",\"name " << i << ",\nline two\"," << (i % 3 == 0 ? "\"q\"\"\"" : "x");
+            out << (i % 4 == 0 ? "\r\n" : "\n");
+            if (i % 7 == 0) {
+                out << "short\n";
+            }
+        }
+    }
+
+    std::vector<size_t> reader_offsets(const std::string& filename, const CSVFormat& format) {
+        std::vector<size_t> offsets;
+        CSVReader reader(filename, format);
+        for (auto& row : reader) {
+            offsets.push_back(row.byte_offset());
+        }
+        return offsets;
+    }
+}
+
+TEST_CASE("CSVRowIndex reads row ranges like CSVReader", "[row_index]") {
+    FileGuard cleanup("./tests/data/tmp_row_index.csv");
+    write_indexed_csv(cleanup.filename, 2000);
+
+    CSVFormat format;
+    format.delimiter(',').header_row(0);
+    const std::vector<size_t> expected = reader_offsets(cleanup.filename, format);
+
+    CSVRowIndex index = CSVRowIndex::build(cleanup.filename, format, 64);
+    REQUIRE(index.n_rows() == expected.size());
+    REQUIRE(index.get_col_names() == std::vector<std::string>({ "id", "name", "note" }));
+
+    const std::vector<std::pair<size_t, size_t>> ranges = {
+        { 0, 10 }, { 63, 65 }, { 64, 64 }, { 500, 1000 }, { 1999, 2000 }, { 2000, 2000 }, { 0, 2000 }
+    };
+
+    for (const auto& range : ranges) {
+        INFO("rows " << range.first << " to " << range.second);
+        size_t row_number = range.first;
+        for (auto& row : index.read_rows(range.first, range.second)) {
+            REQUIRE(row.byte_offset() == expected[row_number]);
+            REQUIRE(row["id"].get<size_t>() == row_number);
+            row_number++;
+        }
+        REQUIRE(row_number == range.second);
+    }
+
+    size_t row_number = 1500;
+    for (auto& row : index.seek_row(1500)) {
+        REQUIRE(row["id"].get<size_t>() == row_number++);
+    }
+    REQUIRE(row_number == 2000);
+
+    REQUIRE_THROWS_AS(index.read_rows(10, 5), std::out_of_range);
+    REQUIRE_THROWS_AS(index.read_rows(0, 2001), std::out_of_range);
+}
+
+TEST_CASE("CSVRowIndex partitions rows into byte ranges", "[row_index]") {
+    FileGuard cleanup("./tests/data/tmp_row_index_partition.csv");
+    write_indexed_csv(cleanup.filename, 3000);
+
+    CSVRowIndex index = CSVRowIndex::build(cleanup.filename, CSVFormat::guess_csv(), 100);
+    const std::vector<CSVRowIndex::Range> ranges = index.partition(4);
+    REQUIRE(ranges.size() == 4);
+    REQUIRE(ranges.front().first_row == 0);
+    REQUIRE(ranges.back().last_row == index.n_rows());
+    REQUIRE(ranges.back().end == index.file_size());
+
+    size_t row_number = 0;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (i > 0) {
+            REQUIRE(ranges[i].first_row == ranges[i - 1].last_row);
+            REQUIRE(ranges[i].begin == ranges[i - 1].end);
+        }
+
+        for (auto& row : index.read_rows(ranges[i].first_row, ranges[i].last_row)) {
+            REQUIRE(row["id"].get<size_t>() == row_number++);
+        }
+    }
+    REQUIRE(row_number == 3000);
+}
+
+TEST_CASE("CSVRowIndex sidecar files are reused until the CSV changes", "[row_index]") {
+    FileGuard cleanup("./tests/data/tmp_row_index_sidecar.csv");
+    FileGuard sidecar(CSVRowIndex::sidecar_path(cleanup.filename));
+    write_indexed_csv(cleanup.filename, 500);
+
+    CSVRowIndex built = CSVRowIndex::open(cleanup.filename);
+    REQUIRE(built.n_rows() == 500);
+
+    CSVRowIndex loaded = CSVRowIndex::load(cleanup.filename, sidecar.filename);
+    REQUIRE(loaded.n_rows() == 500);
+    REQUIRE(loaded.stride() == CSV_ROW_INDEX_STRIDE_DEFAULT);
+    REQUIRE(loaded.get_col_names() == built.get_col_names());
+    REQUIRE(loaded.checkpoints().size() == built.checkpoints().size());
+    for (auto& row : loaded.read_rows(250, 260)) {
+        REQUIRE(row["id"].get<size_t>() >= 250);
+    }
+
+    SECTION("Appending rows invalidates the index") {
+        {
+            std::ofstream out(cleanup.filename, std::ios::binary | std::ios::app);
+            out << "500,\"name 500\",x\n";
+        }
+
+        REQUIRE_FALSE(loaded.is_current());
+        REQUIRE_THROWS_AS(loaded.read_rows(0, 10), std::runtime_error);
+        REQUIRE_THROWS_AS(CSVRowIndex::load(cleanup.filename, sidecar.filename), std::runtime_error);
+        REQUIRE(CSVRowIndex::open(cleanup.filename).n_rows() == 501);
+    }
+
+    SECTION("A different stride rebuilds the index") {
+        REQUIRE(CSVRowIndex::open(cleanup.filename, CSVFormat::guess_csv(), 10).stride() == 10);
+        REQUIRE(CSVRowIndex::load(cleanup.filename, sidecar.filename).stride() == 10);
+    }
+
+    SECTION("Corrupt index files are rejected") {
+        {
+            std::ofstream out(sidecar.filename, std::ios::binary | std::ios::trunc);
+            out << "not an index";
+        }
+
+        REQUIRE_THROWS_AS(CSVRowIndex::load(cleanup.filename, sidecar.filename), std::runtime_error);
+        REQUIRE(CSVRowIndex::open(cleanup.filename).n_rows() == 500);
+    }
+}
+#endif
@@ -1,5 +1,7 @@
 #include <catch2/catch_all.hpp>
 #include "internal/csv_row.hpp"
+#include "internal/csv_reader.hpp"
+#include "internal/csv_utility.hpp"
 #include "internal/parser/mmap.hpp"
 #include "internal/parser/stream.hpp"
 #include "internal/speculative/scanner.hpp"
@@ -8,6 +10,7 @@
 
 #include <fstream>
 #include <sstream>
+#include <thread>
 
 using namespace csv;
 using namespace csv::internals;
@@ -134,6 +137,50 @@ TEST_CASE("Speculative scanner preserves escaped quote pairs in quoted interpret
     REQUIRE(speculation.inside_scan.records_seen == 1);
     REQUIRE_FALSE(speculation.inside_scan.ending_state.quote_escape);
 }
+
+static void require_same_prefix_scan(const PrefixScanResult& actual, const PrefixScanResult& expected) {
+    REQUIRE(actual.ending_state.quote_escape == expected.ending_state.quote_escape);
+    REQUIRE(actual.ending_state.pending_quote == expected.ending_state.pending_quote);
+    REQUIRE(actual.ending_state.pending_linefeed == expected.ending_state.pending_linefeed);
+    REQUIRE(actual.records_seen == expected.records_seen);
+    REQUIRE(actual.first_record_end == expected.first_record_end);
+    REQUIRE(actual.total_states == expected.total_states);
+    REQUIRE(actual.unquoted_states == expected.unquoted_states);
+    REQUIRE(actual.max_record_length == expected.max_record_length);
+    REQUIRE(actual.quoted_fields == expected.quoted_fields);
+    REQUIRE(actual.first_quote_open == expected.first_quote_open);
+    REQUIRE(actual.first_quote_close == expected.first_quote_close);
+    REQUIRE(actual.log_other_start_valid_probability == expected.log_other_start_valid_probability);
+}
+
+TEST_CASE("Speculative scanner block scan matches the bytewise reference", "[raw_csv_parse][speculative]") {
+    const bool quoting = GENERATE(true, false);
+    SpeculativeScanner scanner(quoting
+        ? internals::make_parse_flags(',', '"')
+        : internals::make_parse_flags(','));
+
+    // Lengths straddle the 64-byte block size so CRLF pairs, quotes and
+    // separators land on block boundaries and in the padded tail.
+    const char alphabet[] = { 'a', 'b', ',', '"', '\r', '\n' };
+    uint32_t seed = 12345;
+    for (size_t length = 0; length <= 200; ++length) {
+        for (size_t trial = 0; trial < 4; ++trial) {
+            std::string prefix(length, 'a');
+            for (size_t i = 0; i < length; ++i) {
+                seed = seed * 1103515245u + 12345u;
+                prefix[i] = alphabet[(seed >> 16) % sizeof(alphabet)];
+            }
+
+            PrefixScanResult outside, inside, expected_outside, expected_inside;
+            scanner.scan_prefix(prefix, outside, inside);
+            scanner.scan_prefix_reference(prefix, expected_outside, expected_inside);
+
+            INFO("prefix: " << prefix);
+            require_same_prefix_scan(outside, expected_outside);
+            require_same_prefix_scan(inside, expected_inside);
+        }
+    }
+}
 #endif
 
 TEST_CASE("Parsed chunk rows split edge fragments from complete rows", "[raw_csv_parse][fragments]") {
@@ -511,6 +558,38 @@ TEST_CASE("ParallelCSVParser preserves column names for emitted rows", "[raw_csv
     REQUIRE(output[1]["status"].get<std::string>() == "done");
 }
 
+TEST_CASE("ParallelCSVParser speculates deferred chunks on its workers", "[raw_csv_parse][speculative][parallel]") {
+    const auto parse_flags = internals::make_parse_flags(',', '"');
+    const auto ws_flags = internals::WhitespaceMap();
+    const size_t workers = GENERATE(1, 3);
+
+    SpeculativeScanner scanner(parse_flags, 16);
+    auto input = std::make_shared<std::string>();
+    for (int i = 0; i < 40; ++i) {
+        *input += std::to_string(i) + ",\"multi\nline, " + std::to_string(i) + "\",plain\n";
+    }
+
+    auto eager = make_speculative_parse_chunks(*input, input, 23, scanner);
+    auto deferred = make_speculative_parse_chunks(*input, input, 23, scanner, 0, 0, true, true, true);
+    REQUIRE(deferred.size() == eager.size());
+    REQUIRE(deferred[1].scanner == &scanner);
+
+    std::vector<CSVRow> expected_rows, actual_rows;
+    ParallelCSVParser<> reference(parse_flags, ws_flags, 1);
+    const auto expected = reference.parse_chunks(eager, expected_rows);
+    ParallelCSVParser<> parser(parse_flags, ws_flags, workers);
+    const auto actual = parser.parse_chunks(deferred, actual_rows);
+
+    REQUIRE(actual_rows.size() == 40);
+    REQUIRE(actual_rows.size() == expected_rows.size());
+    for (size_t i = 0; i < actual_rows.size(); ++i) {
+        REQUIRE(actual_rows[i].raw_str() == expected_rows[i].raw_str());
+    }
+    REQUIRE(actual.diagnostics.chunks == expected.diagnostics.chunks);
+    REQUIRE(actual.diagnostics.assumed_quoted_chunks == expected.diagnostics.assumed_quoted_chunks);
+    REQUIRE(actual.diagnostics.ambiguous_chunks == expected.diagnostics.ambiguous_chunks);
+}
+
 TEST_CASE("ParallelCSVParser can leave the final split row pending", "[raw_csv_parse][speculative][parallel]") {
     const auto parse_flags = internals::make_parse_flags(',', '"');
     const auto ws_flags = internals::WhitespaceMap();
@@ -576,6 +655,71 @@ TEST_CASE("ParallelCSVParser repairs chunks split between CR and LF", "[raw_csv_
     REQUIRE(output[1][1] == "D");
 }
 
+TEST_CASE("ParallelCSVParser repairs a cascade of mis-speculated chunks on the pool", "[raw_csv_parse][speculative][parallel][repair]") {
+    const auto parse_flags = internals::make_parse_flags(',', '"');
+    const auto ws_flags = internals::WhitespaceMap();
+    SpeculativeScanner scanner(parse_flags, 8);
+
+    std::string text = "id,text,status\n";
+    for (size_t i = 0; i < 30; ++i) {
+        text += std::to_string(i) + ",\"multi\nline, \"\"quoted\"\" text\",ok\n";
+    }
+    auto whole = std::make_shared<std::string>(text);
+    auto chunks = make_speculative_parse_chunks(*whole, whole, 24, scanner);
+    REQUIRE(chunks.size() > 8);
+
+    // Seed every chunk after the first with the opposite of its true start
+    // state, so each repair depends on the one before it.
+    ChunkParserCore chain_parser(parse_flags, ws_flags);
+    ParserDFAState true_state;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (i > 0) {
+            chunks[i].speculation.assumed_start_state = ParserDFAState(!true_state.quote_escape);
+        }
+
+        std::vector<CSVRow> ignored;
+        true_state = chain_parser.parse_chunk(
+            chunks[i].bytes,
+            chunks[i].owner,
+            ignored,
+            ParserChunkOptions(true_state, chunks[i].scan_bom, chunks[i].offset)
+        ).ending_state;
+    }
+
+    CSVFormat serial_format;
+    serial_format.delimiter(',').header_row(-1).threading(false);
+    std::stringstream expected_input(text);
+    CSVReader expected_reader(expected_input, serial_format);
+    std::vector<std::vector<std::string>> expected;
+    for (auto& row : expected_reader) {
+        expected.push_back(std::vector<std::string>(row));
+    }
+
+    const size_t worker_count = GENERATE(1, 3);
+    INFO("workers=" << worker_count);
+
+    std::vector<CSVRow> output;
+    ParallelCSVParser<> parser(parse_flags, ws_flags, worker_count);
+    const auto result = parser.parse_chunks(chunks, output);
+
+    std::vector<std::vector<std::string>> actual;
+    for (auto& row : output) {
+        actual.push_back(std::vector<std::string>(row));
+    }
+    REQUIRE(actual == expected);
+
+    REQUIRE(result.repair_count == chunks.size() - 1);
+    REQUIRE(result.diagnostics.validation_repairs == result.repair_count);
+    REQUIRE(result.diagnostics.repair_nanoseconds > 0);
+    if (worker_count == 1) {
+        REQUIRE(result.diagnostics.parallel_repairs == 0);
+    }
+    else {
+        // The whole cascade is resolved on the pool before validation.
+        REQUIRE(result.diagnostics.parallel_repairs == result.repair_count);
+    }
+}
+
 #if !defined(__EMSCRIPTEN__)
 TEST_CASE("MmapParser speculative path preserves row order and split quoted rows", "[raw_csv_parse][speculative][mmap]") {
     FileGuard cleanup("./tests/data/tmp_speculative_mmap.csv");
@@ -733,6 +877,409 @@ TEST_CASE("StreamParser speculative path flushes pending suffix once at EOF", "[
     REQUIRE(rows[1][1].get<std::string>() == std::string((internals::CSV_CHUNK_SIZE_FLOOR * 2) + 128, 'z'));
     REQUIRE(rows[1][2] == "done");
 }
+
+TEST_CASE("ParallelCSVParser pipelined windows match a single-window parse", "[raw_csv_parse][speculative][parallel][pipeline]") {
+    const auto parse_flags = internals::make_parse_flags(',', '"');
+    const auto ws_flags = internals::WhitespaceMap();
+    SpeculativeScanner scanner(parse_flags, 8);
+
+    std::string text = "id,text,status\r\n";
+    for (size_t i = 0; i < 40; ++i) {
+        text += std::to_string(i) + ",\"multi\nline, \"\"quoted\"\"\",ok\r\n";
+        text += std::to_string(i) + ",plain,ok\n";
+    }
+    text += "last,\"unterminated";
+
+    auto whole = std::make_shared<std::string>(text);
+    std::vector<CSVRow> expected_rows;
+    ParallelCSVParser<> reference(parse_flags, ws_flags, 2);
+    reference.parse_chunks(make_speculative_parse_chunks(*whole, whole, 16, scanner), expected_rows);
+
+    std::vector<std::vector<std::string>> expected;
+    for (auto& row : expected_rows) {
+        expected.push_back(std::vector<std::string>(row));
+    }
+
+    const size_t worker_count = GENERATE(1, 3);
+    const size_t window_size = GENERATE(37, 64, 101);
+    INFO("workers=" << worker_count << " window=" << window_size);
+
+    std::vector<CSVRow> output;
+    ParallelCSVParser<> parser(parse_flags, ws_flags, worker_count);
+    size_t sequence_number = 0;
+    for (size_t offset = 0; offset < text.size(); offset += window_size) {
+        const size_t length = std::min(window_size, text.size() - offset);
+        auto window = std::make_shared<std::string>(text.substr(offset, length));
+        auto chunks = make_speculative_parse_chunks(
+            *window, window, 16, scanner, offset, sequence_number, offset == 0, offset == 0
+        );
+        sequence_number += chunks.size();
+
+        const bool finish = offset + length == text.size();
+        const auto result = parser.parse_window_pipelined(std::move(chunks), output, finish);
+        REQUIRE(result.windows_released == size_t(offset == 0 ? 0 : 1) + size_t(finish ? 1 : 0));
+    }
+
+    std::vector<std::vector<std::string>> actual;
+    for (auto& row : output) {
+        actual.push_back(std::vector<std::string>(row));
+    }
+    REQUIRE(actual == expected);
+}
+
+TEST_CASE("CSVReader pipelined speculative parsing matches serial parsing", "[raw_csv_parse][speculative][pipeline]") {
+    std::string content = "id,notes,value\n";
+    size_t generated_rows = 0;
+    while (content.size() < 3 * internals::CSV_CHUNK_SIZE_FLOOR) {
+        const std::string id = std::to_string(generated_rows++);
+        content += id + ",\"note " + id + "\nwith \"\"quotes\"\", and commas\"," + id + "\n";
+    }
+
+    CSVFormat format;
+    format.delimiter(',')
+        .header_row(0)
+        .chunk_size(internals::CSV_CHUNK_SIZE_FLOOR)
+        .speculative_parallel_min_bytes(1)
+        .speculative_parallel_threads(2)
+        .speculative_pipeline();
+    REQUIRE(format.is_speculative_pipeline_enabled());
+
+    auto read_all = [](CSVReader& reader) {
+        std::vector<std::vector<std::string>> rows;
+        for (auto& row : reader) {
+            rows.push_back(std::vector<std::string>(row));
+        }
+        return rows;
+    };
+
+    std::stringstream expected_input(content);
+    CSVFormat serial_format;
+    serial_format.delimiter(',').header_row(0).threading(false);
+    CSVReader expected_reader(expected_input, serial_format);
+    const auto expected = read_all(expected_reader);
+    REQUIRE(expected.size() == generated_rows);
+
+    SECTION("Stream source") {
+        std::stringstream input(content);
+        CSVReader reader(input, format);
+        REQUIRE(read_all(reader) == expected);
+        REQUIRE(reader.speculative_diagnostics().chunks > 0);
+    }
+
+#if !defined(__EMSCRIPTEN__)
+    SECTION("Memory-mapped source") {
+        FileGuard cleanup("./tests/data/tmp_speculative_pipeline.csv");
+        {
+            std::ofstream out(cleanup.filename, std::ios::binary);
+            out << content;
+        }
+
+        CSVReader reader(cleanup.filename, format);
+        REQUIRE(read_all(reader) == expected);
+        REQUIRE(reader.speculative_diagnostics().chunks > 0);
+    }
+#endif
+
+    SECTION("Rows larger than a window are still rejected") {
+        std::string oversized = "a,b\n1,\"";
+        oversized.append(8 * internals::CSV_CHUNK_SIZE_FLOOR, 'x');
+        oversized += "\"\n2,3\n";
+
+        std::stringstream input(oversized);
+        CSVReader reader(input, format);
+        REQUIRE_THROWS_WITH(read_all(reader), Catch::Matchers::ContainsSubstring("End of file not reached"));
+    }
+}
+
+TEST_CASE("AdaptiveChunkSizer follows repair and ambiguity feedback", "[raw_csv_parse][speculative][adaptive]") {
+    const size_t max_chunk = 1024 * 1024;
+    AdaptiveChunkSizer sizer(64 * 1024);
+    REQUIRE(sizer.chunk_size(max_chunk) == max_chunk);
+    REQUIRE_FALSE(sizer.serial());
+
+    SpeculativeParseDiagnostics clean;
+    clean.chunks = 8;
+
+    SpeculativeParseDiagnostics ambiguous = clean;
+    ambiguous.ambiguous_chunks = 2;
+
+    SpeculativeParseDiagnostics failing = clean;
+    failing.validation_repairs = 6;
+
+    SECTION("Unsettled windows shrink chunks and clean windows grow them back") {
+        sizer.observe_window(ambiguous, max_chunk, 10000);
+        REQUIRE(sizer.chunk_size(max_chunk) == max_chunk / 2);
+
+        for (int i = 0; i < 8; ++i) {
+            sizer.observe_window(ambiguous, max_chunk, 10000);
+        }
+        REQUIRE(sizer.chunk_size(max_chunk) == max_chunk / 16);
+
+        sizer.observe_window(clean, max_chunk, 10000);
+        REQUIRE(sizer.chunk_size(max_chunk) == max_chunk / 8);
+        REQUIRE_FALSE(sizer.serial());
+    }
+
+    SECTION("Chunks keep several rows of the current average length") {
+        for (int i = 0; i < 4; ++i) {
+            sizer.observe_window(ambiguous, max_chunk, 32);
+        }
+        REQUIRE(sizer.chunk_size(max_chunk) == CSV_ADAPTIVE_CHUNK_MIN_ROWS * (max_chunk / 32));
+
+        // Never above the configured size, even for huge rows.
+        sizer.observe_window(ambiguous, max_chunk, 1);
+        REQUIRE(sizer.chunk_size(max_chunk) == max_chunk);
+    }
+
+    SECTION("Repeated failures suspend speculation with growing pauses") {
+        for (size_t i = 0; i + 1 < CSV_ADAPTIVE_FAILED_WINDOWS_MAX; ++i) {
+            sizer.observe_window(failing, max_chunk, 10000);
+            REQUIRE_FALSE(sizer.serial());
+        }
+        sizer.observe_window(failing, max_chunk, 10000);
+
+        for (size_t i = 0; i < CSV_ADAPTIVE_SERIAL_WINDOWS_MIN; ++i) {
+            REQUIRE(sizer.serial());
+            sizer.observe_serial_window(max_chunk, 10000);
+        }
+        REQUIRE_FALSE(sizer.serial());
+
+        // The first failure after a pause suspends again, for twice as long.
+        sizer.observe_window(failing, max_chunk, 10000);
+        for (size_t i = 0; i < 2 * CSV_ADAPTIVE_SERIAL_WINDOWS_MIN; ++i) {
+            REQUIRE(sizer.serial());
+            sizer.observe_serial_window(max_chunk, 10000);
+        }
+        REQUIRE_FALSE(sizer.serial());
+
+        // A successful probe ends the streak.
+        sizer.observe_window(clean, max_chunk, 10000);
+        sizer.observe_window(failing, max_chunk, 10000);
+        REQUIRE_FALSE(sizer.serial());
+    }
+}
+
+TEST_CASE("CSVReader adaptive speculative chunks match serial parsing", "[raw_csv_parse][speculative][adaptive]") {
+    // Plain rows followed by quote-dense multiline rows, like a file whose
+    // character changes partway through.
+    std::string content = "id,notes,value\n";
+    size_t generated_rows = 0;
+    while (content.size() < 2 * internals::CSV_CHUNK_SIZE_FLOOR) {
+        const std::string id = std::to_string(generated_rows++);
+        content += id + ",plain note," + id + "\n";
+    }
+    while (content.size() < 5 * internals::CSV_CHUNK_SIZE_FLOOR) {
+        const std::string id = std::to_string(generated_rows++);
+        content += id + ",\"{\"\"k\"\": \"\"" + id + ",\n\"\"}\"," + id + "\n";
+    }
+
+    const bool pipeline = GENERATE(false, true);
+    CSVFormat format;
+    format.delimiter(',')
+        .header_row(0)
+        .chunk_size(internals::CSV_CHUNK_SIZE_FLOOR)
+        .speculative_parallel_min_bytes(1)
+        .speculative_parallel_threads(2)
+        .speculative_pipeline(pipeline)
+        .speculative_adaptive_chunks();
+    REQUIRE(format.is_speculative_adaptive_chunks_enabled());
+
+    auto read_all = [](CSVReader& reader) {
+        std::vector<std::vector<std::string>> rows;
+        for (auto& row : reader) {
+            rows.push_back(std::vector<std::string>(row));
+        }
+        return rows;
+    };
+
+    std::stringstream expected_input(content);
+    CSVFormat serial_format;
+    serial_format.delimiter(',').header_row(0).threading(false);
+    CSVReader expected_reader(expected_input, serial_format);
+    const auto expected = read_all(expected_reader);
+    REQUIRE(expected.size() == generated_rows);
+
+    std::stringstream input(content);
+    CSVReader reader(input, format);
+    REQUIRE(read_all(reader) == expected);
+    REQUIRE(reader.speculative_diagnostics().chunks > 0);
+}
+
+TEST_CASE("CSVReader with pinned parse workers matches serial parsing", "[raw_csv_parse][speculative][placement]") {
+    std::string content = "id,notes\n";
+    size_t generated_rows = 0;
+    while (content.size() < 4 * internals::CSV_CHUNK_SIZE_FLOOR) {
+        const std::string id = std::to_string(generated_rows++);
+        content += id + ",\"note " + id + ", quoted\"\n";
+    }
+
+    CSVFormat format;
+    format.delimiter(',')
+        .header_row(0)
+        .chunk_size(internals::CSV_CHUNK_SIZE_FLOOR)
+        .speculative_parallel_min_bytes(1)
+        .speculative_parallel_threads(2)
+        .parse_worker_cpus({ 0 });
+    REQUIRE(format.get_parse_worker_cpus() == std::vector<int>{ 0 });
+
+    CSVReader reader(CSVMemorySource(content), format);
+    size_t rows = 0;
+    for (auto& row : reader) {
+        REQUIRE(row["id"].get<size_t>() == rows);
+        REQUIRE(row["notes"].get<std::string>() == "note " + std::to_string(rows) + ", quoted");
+        rows++;
+    }
+
+    REQUIRE(rows == generated_rows);
+    REQUIRE(reader.speculative_diagnostics().chunks > 0);
+}
+
+TEST_CASE("In-memory sources parse in place on the speculative path", "[raw_csv_parse][speculative][memory]") {
+    std::string content = "id,notes,value\n";
+    size_t generated_rows = 0;
+    while (content.size() < 3 * internals::CSV_CHUNK_SIZE_FLOOR) {
+        const std::string id = std::to_string(generated_rows++);
+        content += id + ",\"note " + id + "\nwith, commas\"," + id + "\n";
+    }
+
+    const bool pipeline = GENERATE(false, true);
+    CSVFormat format;
+    format.delimiter(',')
+        .header_row(0)
+        .chunk_size(internals::CSV_CHUNK_SIZE_FLOOR)
+        .speculative_parallel_min_bytes(1)
+        .speculative_parallel_threads(2)
+        .speculative_pipeline(pipeline);
+
+    std::stringstream expected_input(content);
+    CSVFormat serial_format;
+    serial_format.delimiter(',').header_row(0).threading(false);
+    CSVReader expected_reader(expected_input, serial_format);
+    std::vector<std::vector<std::string>> expected;
+    for (auto& row : expected_reader) {
+        expected.push_back(std::vector<std::string>(row));
+    }
+    REQUIRE(expected.size() == generated_rows);
+
+    SECTION("parse_unsafe() rows view the caller's buffer") {
+        auto reader = parse_unsafe(content, format);
+        std::vector<std::vector<std::string>> actual;
+        size_t copied_rows = 0;
+        for (auto& row : reader) {
+            const csv::string_view value = row[2].get<csv::string_view>();
+            if (value.data() < content.data() || value.data() + value.size() > content.data() + content.size()) {
+                copied_rows++;
+            }
+            actual.push_back(std::vector<std::string>(row));
+        }
+
+        REQUIRE(actual == expected);
+        REQUIRE(reader.parse_worker_count() == 2);
+        REQUIRE(reader.speculative_diagnostics().chunks > 0);
+
+        // Only rows stitched across speculative chunk boundaries are copied.
+        REQUIRE(copied_rows <= reader.speculative_diagnostics().chunks);
+    }
+
+    SECTION("parse() rows outlive the caller's buffer") {
+        std::vector<CSVRow> rows;
+        {
+            std::string copy = content;
+            auto reader = parse(copy, format);
+            for (auto& row : reader) {
+                rows.push_back(row);
+            }
+            REQUIRE(reader.speculative_diagnostics().chunks > 0);
+        }
+
+        REQUIRE(rows.size() == expected.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            REQUIRE(std::vector<std::string>(rows[i]) == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("CSVReaders sharing a ParseExecutor match serial parsing", "[raw_csv_parse][speculative][parse_executor]") {
+    std::string content = "id,notes,value\n";
+    size_t generated_rows = 0;
+    while (content.size() < 4 * internals::CSV_CHUNK_SIZE_FLOOR) {
+        const std::string id = std::to_string(generated_rows++);
+        content += id + ",\"note " + id + "\nwith, commas\"," + id + "\n";
+    }
+
+    auto read_all = [](CSVReader& reader) {
+        std::vector<std::vector<std::string>> rows;
+        for (auto& row : reader) {
+            rows.push_back(std::vector<std::string>(row));
+        }
+        return rows;
+    };
+
+    std::stringstream expected_input(content);
+    CSVFormat serial_format;
+    serial_format.delimiter(',').header_row(0).threading(false);
+    CSVReader expected_reader(expected_input, serial_format);
+    const auto expected = read_all(expected_reader);
+    REQUIRE(expected.size() == generated_rows);
+
+    auto executor = std::make_shared<ParseExecutor>(3);
+    REQUIRE(executor->worker_count() == 3);
+
+    CSVFormat format;
+    format.delimiter(',')
+        .header_row(0)
+        .chunk_size(internals::CSV_CHUNK_SIZE_FLOOR)
+        .speculative_parallel_min_bytes(1);
+
+    SECTION("Concurrent readers on one executor") {
+        const bool pipeline = GENERATE(false, true);
+        format.parse_executor(executor).speculative_parallel_threads(2).speculative_pipeline(pipeline);
+
+        const size_t reader_count = 4;
+        std::vector<std::vector<std::vector<std::string>>> results(reader_count);
+        std::vector<size_t> worker_counts(reader_count, 0);
+        std::vector<std::thread> readers;
+        for (size_t i = 0; i < reader_count; ++i) {
+            readers.push_back(std::thread([&, i]() {
+                std::stringstream input(content);
+                CSVReader reader(input, format);
+                worker_counts[i] = reader.parse_worker_count();
+                results[i] = read_all(reader);
+            }));
+        }
+
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        for (size_t i = 0; i < reader_count; ++i) {
+            REQUIRE(worker_counts[i] == 2);
+            REQUIRE(results[i] == expected);
+        }
+    }
+
+    SECTION("A reader's share is capped by the executor") {
+        format.parse_executor(executor).speculative_parallel_threads(16);
+        std::stringstream input(content);
+        CSVReader reader(input, format);
+        REQUIRE(reader.parse_worker_count() == 3);
+        REQUIRE(read_all(reader) == expected);
+    }
+
+    SECTION("Global executor") {
+        ParseExecutor::set_global(executor);
+        REQUIRE(ParseExecutor::global() == executor);
+
+        std::stringstream input(content);
+        CSVReader reader(input, format);
+        ParseExecutor::set_global(nullptr);
+
+        // The reader keeps the executor it started with.
+        REQUIRE(reader.parse_worker_count() == 3);
+        REQUIRE(read_all(reader) == expected);
+        REQUIRE(ParseExecutor::global() == nullptr);
+    }
+}
 #endif
 
 TEST_CASE("StreamParser stays serial when runtime threading is disabled", "[raw_csv_parse][stream]") {
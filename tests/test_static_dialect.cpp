@@ -0,0 +1,115 @@
+#include <catch2/catch_all.hpp>
+#include "internal/parser/core.hpp"
+#include "csv.hpp"
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace csv;
+using namespace csv::internals;
+
+namespace {
+    using Rows = std::vector<std::vector<std::string>>;
+
+    template<typename Dialect>
+    Rows parse_with_dialect(const std::string& text, const ParseFlagMap& parse_flags, ParserEngine engine) {
+        CSVParserCore<
+            std::vector<CSVRow>,
+            PermissiveParsePolicy,
+            CSVRowFieldPolicy<false>,
+            CSVRowRowPolicy,
+            Dialect> parser(parse_flags, WhitespaceMap());
+        parser.set_parser_engine(engine);
+
+        auto chunk = std::make_shared<std::string>(text);
+        std::vector<CSVRow> rows;
+        parser.parse_chunk(*chunk, chunk, rows, ParserChunkOptions(ParserDFAState(), false));
+        parser.end_feed();
+
+        Rows parsed;
+        for (auto& row : rows) {
+            parsed.push_back(std::vector<std::string>(row));
+        }
+        return parsed;
+    }
+
+    template<typename Dialect>
+    void require_dialect_matches_runtime(const std::string& text, const ParseFlagMap& parse_flags) {
+        INFO(text);
+        for (ParserEngine engine : { ParserEngine::STATE_MACHINE, ParserEngine::STRUCTURAL_INDEX }) {
+            REQUIRE(parse_with_dialect<Dialect>(text, parse_flags, engine)
+                == parse_with_dialect<RuntimeDialect>(text, parse_flags, engine));
+        }
+    }
+
+    template<typename Dialect>
+    void require_same_flags(const ParseFlagMap& parse_flags) {
+        for (int ch = -128; ch < 128; ++ch) {
+            INFO(ch);
+            REQUIRE(Dialect::parse_flag(parse_flags, static_cast<char>(ch))
+                == RuntimeDialect::parse_flag(parse_flags, static_cast<char>(ch)));
+        }
+    }
+}
+
+TEST_CASE("StaticDialect classifies like make_parse_flags", "[static_dialect]") {
+    require_same_flags<StaticDialect<','>>(make_parse_flags(',', '"'));
+    require_same_flags<StaticDialect<'\t'>>(make_parse_flags('\t', '"'));
+    require_same_flags<StaticDialect<';', '\''>>(make_parse_flags(';', '\''));
+    require_same_flags<StaticDialect<'|', '"', false>>(make_parse_flags('|'));
+}
+
+TEST_CASE("StaticDialect parser matches the runtime dialect", "[static_dialect]") {
+    std::mt19937 rng(5150);
+    const std::string alphabet = "aaab,,\t\"\"\n\r ";
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+
+    for (size_t trial = 0; trial < 200; ++trial) {
+        std::string text;
+        for (size_t i = 0; i < 64 + trial * 3; ++i) {
+            text += alphabet[pick(rng)];
+        }
+
+        require_dialect_matches_runtime<StaticDialect<','>>(text, make_parse_flags(',', '"'));
+        require_dialect_matches_runtime<StaticDialect<'\t'>>(text, make_parse_flags('\t', '"'));
+    }
+}
+
+TEST_CASE("CSVReader honors CSVFormat::specialize_dialect", "[static_dialect][csv_reader]") {
+    const char delim = GENERATE(',', '\t');
+    std::string csv_string = std::string("id") + delim + "notes" + delim + "value\r\n";
+    while (csv_string.size() < 3 * internals::CSV_CHUNK_SIZE_FLOOR) {
+        const std::string i = std::to_string(csv_string.size());
+        csv_string += i + delim + "\"note" + delim + " with \"\"quotes\"\"\nand a newline\"" + delim + i + "\r\n";
+    }
+
+    CSVFormat format;
+    format.delimiter(delim)
+        .header_row(0)
+        .chunk_size(internals::CSV_CHUNK_SIZE_FLOOR)
+        .speculative_parallel_min_bytes(1)
+        .speculative_parallel_threads(2);
+    REQUIRE_FALSE(format.is_dialect_specialization_enabled());
+
+    std::stringstream expected_input(csv_string);
+    CSVReader expected(expected_input, format);
+
+    format.specialize_dialect();
+    REQUIRE(format.is_dialect_specialization_enabled());
+    std::stringstream actual_input(csv_string);
+    CSVReader actual(actual_input, format);
+
+    size_t n_rows = 0;
+    auto it = actual.begin();
+    for (auto& row : expected) {
+        REQUIRE(it != actual.end());
+        REQUIRE(std::vector<std::string>(*it) == std::vector<std::string>(row));
+        ++it;
+        ++n_rows;
+    }
+
+    REQUIRE(it == actual.end());
+    REQUIRE(n_rows > 1000);
+}
@@ -6,6 +6,8 @@
 #include <catch2/catch_all.hpp>
 #include <sstream>
 #include <memory>
+#include <string>
+#include <vector>
 #include "csv.hpp"
 #include "shared/non_seekable_stream.hpp"
 
@@ -261,3 +263,72 @@ TEST_CASE("StringViewStreamBuf seek coverage", "[stream_sources][string_view_str
         REQUIRE(ys == std::vector<int>{20, 40});
     }
 }
+
+TEST_CASE("StreamParser chunks keep retained rows intact", "[stream_sources][stream_buffer_pool]") {
+    // Rows straddle many chunk boundaries, including quoted newlines. Every row
+    // is retained until the end so reused or shared buffers would show up as
+    // corrupted field values.
+    std::string content = "id,notes,value\n";
+    std::vector<std::vector<std::string>> expected;
+    while (content.size() < 4 * internals::CSV_CHUNK_SIZE_FLOOR) {
+        const std::string id = std::to_string(expected.size());
+        const std::string notes = "line " + id + "\nwith \"quotes\"";
+        content += id + ",\"line " + id + "\nwith \"\"quotes\"\"\"," + id + id + "\n";
+        expected.push_back({ id, notes, id + id });
+    }
+
+    NonSeekableStream stream(content);
+    CSVFormat format;
+    format.delimiter(',')
+        .header_row(0)
+        .chunk_size(internals::CSV_CHUNK_SIZE_FLOOR);
+
+    CSVReader reader(stream, format);
+    std::vector<CSVRow> rows(reader.begin(), reader.end());
+
+    REQUIRE(rows.size() == expected.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        REQUIRE(std::vector<std::string>(rows[i]) == expected[i]);
+    }
+}
+
+TEST_CASE("StreamBufferPool recycles released buffers", "[stream_sources][stream_buffer_pool]") {
+    using internals::memory::StreamBufferPool;
+
+    auto pool = std::make_shared<StreamBufferPool>(1);
+    const char* first_data = nullptr;
+    {
+        auto first = pool->acquire(64);
+        REQUIRE(first->capacity() == 64);
+        first_data = first->data();
+        REQUIRE(pool->free_buffer_count() == 0);
+    }
+    REQUIRE(pool->free_buffer_count() == 1);
+
+    SECTION("Smaller request reuses the free buffer") {
+        auto reused = pool->acquire(32);
+        REQUIRE(reused->data() == first_data);
+        REQUIRE(pool->free_buffer_count() == 0);
+    }
+
+    SECTION("Larger request allocates a new buffer") {
+        auto larger = pool->acquire(128);
+        REQUIRE(larger->capacity() == 128);
+        REQUIRE(pool->free_buffer_count() == 1);
+    }
+
+    SECTION("Free list is capped") {
+        auto a = pool->acquire(64);
+        auto b = pool->acquire(64);
+        a.reset();
+        b.reset();
+        REQUIRE(pool->free_buffer_count() == 1);
+    }
+
+    SECTION("Buffers may outlive the pool") {
+        auto survivor = pool->acquire(64);
+        pool.reset();
+        survivor->data()[0] = 'x';
+        survivor.reset();
+    }
+}
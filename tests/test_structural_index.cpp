@@ -0,0 +1,253 @@
+#include <catch2/catch_all.hpp>
+#include "internal/parser/core.hpp"
+#include "internal/parser/structural_index.hpp"
+#include "csv.hpp"
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace csv;
+using namespace csv::internals;
+
+namespace {
+    struct ParsedChunk {
+        std::vector<std::vector<std::string>> fields;
+        std::vector<std::string> raw_rows;
+        size_t complete_prefix_length = 0;
+        ParserDFAState ending_state;
+    };
+
+    ParsedChunk parse_with_engine(
+        const std::string& text,
+        ParserEngine engine,
+        const ParseFlagMap& parse_flags,
+        const WhitespaceMap& ws_flags,
+        ParserDFAState initial_state = ParserDFAState()
+    ) {
+        CSVParserCore<std::vector<CSVRow>> parser(parse_flags, ws_flags);
+        parser.set_parser_engine(engine);
+
+        auto chunk = std::make_shared<std::string>(text);
+        std::vector<CSVRow> rows;
+        const auto result = parser.parse_chunk(
+            *chunk, chunk, rows, ParserChunkOptions(initial_state, false)
+        );
+        parser.end_feed();
+
+        ParsedChunk parsed;
+        parsed.complete_prefix_length = result.complete_prefix_length;
+        parsed.ending_state = result.ending_state;
+        for (auto& row : rows) {
+            parsed.fields.push_back(std::vector<std::string>(row));
+            parsed.raw_rows.push_back(std::string(row.raw_str()));
+        }
+        return parsed;
+    }
+
+    void require_engines_agree(
+        const std::string& text,
+        const ParseFlagMap& parse_flags = make_parse_flags(',', '"'),
+        const WhitespaceMap& ws_flags = WhitespaceMap(),
+        ParserDFAState initial_state = ParserDFAState()
+    ) {
+        const ParsedChunk expected = parse_with_engine(
+            text, ParserEngine::STATE_MACHINE, parse_flags, ws_flags, initial_state);
+        const ParsedChunk actual = parse_with_engine(
+            text, ParserEngine::STRUCTURAL_INDEX, parse_flags, ws_flags, initial_state);
+
+        INFO(text);
+        REQUIRE(actual.fields == expected.fields);
+        REQUIRE(actual.raw_rows == expected.raw_rows);
+        REQUIRE(actual.complete_prefix_length == expected.complete_prefix_length);
+        REQUIRE(actual.ending_state.quote_escape == expected.ending_state.quote_escape);
+        REQUIRE(actual.ending_state.pending_quote == expected.ending_state.pending_quote);
+        REQUIRE(actual.ending_state.pending_linefeed == expected.ending_state.pending_linefeed);
+    }
+
+    std::string random_csv(std::mt19937& rng, size_t length, const std::string& alphabet) {
+        std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+        std::string out;
+        out.reserve(length);
+        for (size_t i = 0; i < length; ++i) {
+            out += alphabet[pick(rng)];
+        }
+        return out;
+    }
+}
+
+TEST_CASE("Structural indexer rejects non-RFC 4180 quote placement", "[structural_index]") {
+    const SentinelVecs sentinels(',', '"');
+    parser::StructuralIndexer indexer(sentinels);
+    parser::StructuralBlock block;
+
+    std::string regular(STRUCTURAL_BLOCK_SIZE + 1, 'x');
+    regular.replace(0, 11, "\"a,\"\"b\",c\r\n");
+    REQUIRE(indexer.classify(regular.data(), regular.back(), block));
+    REQUIRE(block.quotes == 0x59u);
+    REQUIRE(block.field_ends == (uint64_t(1) << 7));
+    REQUIRE(block.row_ends == (uint64_t(1) << 9));
+
+    SECTION("quote inside an unquoted field") {
+        std::string irregular(STRUCTURAL_BLOCK_SIZE + 1, 'x');
+        irregular.replace(0, 4, "a\"b,");
+        indexer.reset();
+        REQUIRE_FALSE(indexer.classify(irregular.data(), irregular.back(), block));
+    }
+
+    SECTION("text after a closing quote") {
+        std::string irregular(STRUCTURAL_BLOCK_SIZE + 1, 'x');
+        irregular.replace(0, 5, "\"a\"b,");
+        indexer.reset();
+        REQUIRE_FALSE(indexer.classify(irregular.data(), irregular.back(), block));
+    }
+
+    SECTION("closing quote checks the lookahead byte") {
+        std::string text(STRUCTURAL_BLOCK_SIZE + 1, 'x');
+        text[STRUCTURAL_BLOCK_SIZE - 3] = ',';
+        text[STRUCTURAL_BLOCK_SIZE - 2] = '"';
+        text[STRUCTURAL_BLOCK_SIZE - 1] = '"';
+        indexer.reset();
+        REQUIRE_FALSE(indexer.classify(text.data(), 'x', block));
+
+        indexer.reset();
+        REQUIRE(indexer.classify(text.data(), ',', block));
+    }
+}
+
+TEST_CASE("Structural index engine matches the state machine", "[structural_index]") {
+    // Pad so every case spans several blocks and ends in a partial block.
+    const std::string padding = std::string(150, 'p') + ",q\n";
+
+    auto edge_case = GENERATE(as<std::string>{},
+        "a,b,c\nd,e,f\n",
+        "a,b,c\r\nd,e,f\r\n",
+        "a,b\rc,d\r",
+        "\n\n,\n,,\n",
+        "\"quoted, field\",\"with \"\"escapes\"\"\"\n",
+        "\"multi\nline\r\nfield\",x\n",
+        "\"\",\"\"\"\",\"\"\"\"\"\"\n",
+        "a\"b,c\"d\"\n",
+        "\"a\"b,\"c\"\"d\"e\n",
+        "\"unterminated,field\nstill inside",
+        "  \" padded \"  ,x\n",
+        "x,\"tail\"",
+        "trailing,comma,\n"
+    );
+
+    SECTION("at the start of a chunk") {
+        require_engines_agree(edge_case + padding + padding);
+    }
+
+    SECTION("straddling block boundaries") {
+        for (size_t shift = 0; shift < STRUCTURAL_BLOCK_SIZE + 2; ++shift) {
+            require_engines_agree(std::string(shift, 'z') + "\n" + padding + edge_case + padding);
+        }
+    }
+
+    SECTION("with whitespace trimming") {
+        require_engines_agree(padding + edge_case + padding, make_parse_flags(',', '"'), make_ws_flags(" ", 1));
+    }
+
+    SECTION("with quoting disabled") {
+        require_engines_agree(padding + edge_case + padding, make_parse_flags(','));
+    }
+}
+
+TEST_CASE("Structural index engine matches the state machine on random input", "[structural_index]") {
+    std::mt19937 rng(20240611);
+    const std::string alphabet = "aaab,,\"\"\n\r ";
+
+    for (size_t trial = 0; trial < 400; ++trial) {
+        const std::string text = random_csv(rng, 64 + trial * 3, alphabet);
+        require_engines_agree(text);
+        require_engines_agree(text, make_parse_flags('\t', '\''));
+        require_engines_agree(text, make_parse_flags(','));
+        require_engines_agree(text, make_parse_flags(',', '"'), WhitespaceMap(), ParserDFAState(true));
+    }
+}
+
+TEST_CASE("Unquoted engine matches the state machine", "[structural_index][no_quote]") {
+    std::mt19937 rng(31337);
+    const std::string alphabet = "aaab,,\t\n\r ";
+
+    for (size_t trial = 0; trial < 400; ++trial) {
+        const std::string text = random_csv(rng, 64 + trial * 3, alphabet);
+        INFO(text);
+
+        // Without quote bytes in the input, the quoted dialect runs the DFA and
+        // must split exactly like the unquoted block engine.
+        for (char delim : { ',', '\t' }) {
+            const ParsedChunk expected = parse_with_engine(
+                text, ParserEngine::STATE_MACHINE, make_parse_flags(delim, '"'), WhitespaceMap());
+            const ParsedChunk actual = parse_with_engine(
+                text, ParserEngine::STATE_MACHINE, make_parse_flags(delim), WhitespaceMap());
+
+            REQUIRE(actual.fields == expected.fields);
+            REQUIRE(actual.raw_rows == expected.raw_rows);
+            REQUIRE(actual.complete_prefix_length == expected.complete_prefix_length);
+            REQUIRE(actual.ending_state.pending_linefeed == expected.ending_state.pending_linefeed);
+        }
+    }
+}
+
+TEST_CASE("CSVReader no_quote splits speculative chunks with the unquoted engine", "[structural_index][no_quote]") {
+    std::string csv_string = "id\tpayload\tvalue\n";
+    size_t expected_rows = 0;
+    while (csv_string.size() < 3 * internals::CSV_CHUNK_SIZE_FLOOR) {
+        const std::string i = std::to_string(expected_rows++);
+        csv_string += i + "\t\"literal \"quote\t" + i + (expected_rows % 2 ? "\r\n" : "\n");
+    }
+
+    CSVFormat format;
+    format.delimiter('\t')
+        .quote(false)
+        .header_row(0)
+        .chunk_size(internals::CSV_CHUNK_SIZE_FLOOR)
+        .speculative_parallel_min_bytes(1)
+        .speculative_parallel_threads(2);
+
+    std::stringstream input(csv_string);
+    CSVReader reader(input, format);
+
+    size_t n_rows = 0;
+    for (auto& row : reader) {
+        REQUIRE(row.size() == 3);
+        REQUIRE(row[0].get<std::string>() == std::to_string(n_rows));
+        REQUIRE(row[1].get<std::string>() == "\"literal \"quote");
+        REQUIRE(row[2].get<std::string>() == std::to_string(n_rows));
+        ++n_rows;
+    }
+
+    REQUIRE(n_rows == expected_rows);
+}
+
+TEST_CASE("CSVReader honors CSVFormat::parser_engine", "[structural_index]") {
+    std::string csv_string = "name,notes,value\r\n";
+    for (int i = 0; i < 200; ++i) {
+        csv_string += "row" + std::to_string(i)
+            + ",\"note, with \"\"quotes\"\"\nand a newline\","
+            + std::to_string(i * 7) + "\r\n";
+    }
+
+    CSVFormat format;
+    format.delimiter(',').header_row(0);
+    auto expected = parse(csv_string, format);
+
+    format.parser_engine(ParserEngine::STRUCTURAL_INDEX);
+    REQUIRE(format.get_parser_engine() == ParserEngine::STRUCTURAL_INDEX);
+    auto actual = parse(csv_string, format);
+
+    size_t n_rows = 0;
+    auto it = actual.begin();
+    for (auto& row : expected) {
+        REQUIRE(it != actual.end());
+        REQUIRE(std::vector<std::string>(*it) == std::vector<std::string>(row));
+        ++it;
+        ++n_rows;
+    }
+
+    REQUIRE(it == actual.end());
+    REQUIRE(n_rows == 200);
+}
@@ -135,3 +135,233 @@ TEST_CASE("ThreadSafeDeque concurrent stress test",
         errors->check_and_fail_if_errors();
     }
 }
+
+TEMPLATE_TEST_CASE("Row queue wait_for_capacity applies back-pressure",
+          "[threading][readahead]", internals::ThreadSafeDeque<int>, internals::SPSCRowQueue<int>) {
+    auto errors = std::make_shared<ThreadSafeErrorCollector>();
+    test_with_timeout([errors]() {
+        TestType queue(100);
+        queue.notify_all();
+
+        std::atomic<int> produced{ 0 };
+        std::thread producer([&]() {
+            for (int chunk = 0; chunk < 20; ++chunk) {
+                std::vector<int> rows(10, chunk);
+                queue.append_rows(std::move(rows));
+                produced += 10;
+                if (!queue.wait_for_capacity(10)) {
+                    break;
+                }
+            }
+            queue.kill_all();
+        });
+
+        int consumed = 0;
+        while (true) {
+            if (queue.empty()) {
+                if (!queue.is_waitable()) break;
+                queue.wait();
+                continue;
+            }
+
+            // Never more than one published chunk ahead plus the one in flight.
+            if (produced.load() - consumed > 20) {
+                errors->add_error("producer ran past its read-ahead budget");
+            }
+            queue.pop_front();
+            consumed++;
+        }
+        producer.join();
+
+        if (consumed != 200) errors->add_error("consumed " + std::to_string(consumed) + " rows");
+        if (queue.pushed_count() != 200) errors->add_error("pushed_count() != 200");
+    });
+    errors->check_and_fail_if_errors();
+}
+
+TEMPLATE_TEST_CASE("Row queue interrupt_producer releases a paused producer",
+          "[threading][readahead]", internals::ThreadSafeDeque<int>, internals::SPSCRowQueue<int>) {
+    auto errors = std::make_shared<ThreadSafeErrorCollector>();
+    test_with_timeout([errors]() {
+        TestType queue(100);
+        queue.notify_all();
+        queue.push_back(1);
+        queue.push_back(2);
+
+        std::atomic<bool> released{ false };
+        std::thread producer([&]() {
+            if (queue.wait_for_capacity(0)) {
+                errors->add_error("interrupted wait_for_capacity() returned true");
+            }
+            released = true;
+        });
+
+        queue.interrupt_producer();
+        producer.join();
+        if (!released) errors->add_error("producer was not released");
+
+        // A new producer cycle clears the interrupt.
+        queue.notify_all();
+        queue.pop_front();
+        queue.pop_front();
+        if (!queue.wait_for_capacity(0)) errors->add_error("notify_all() did not clear the interrupt");
+    });
+    errors->check_and_fail_if_errors();
+}
+
+TEST_CASE("SPSCRowQueue preserves order across ring blocks under contention",
+          "[threading][spsc]") {
+    auto errors = std::make_shared<ThreadSafeErrorCollector>();
+    test_with_timeout([errors]() {
+        // Tiny blocks force wrap-around, block chaining, and block reclamation.
+        internals::SPSCRowQueue<int> queue(16, 8);
+        const int n_rows = 200000;
+        queue.notify_all();
+
+        std::thread producer([&]() {
+            int next = 0;
+            while (next < n_rows) {
+                if (next % 3 == 0) {
+                    std::vector<int> batch;
+                    for (int i = 0; i < 37 && next < n_rows; ++i) {
+                        batch.push_back(next++);
+                    }
+                    queue.append_rows(std::move(batch));
+                }
+                else {
+                    int value = next++;
+                    queue.push_back(std::move(value));
+                }
+            }
+            queue.kill_all();
+        });
+
+        int expected = 0;
+        std::vector<int> drained;
+        while (true) {
+            if (queue.empty()) {
+                if (!queue.is_waitable()) {
+                    if (queue.empty()) break;
+                    continue;
+                }
+                queue.wait();
+                continue;
+            }
+
+            if (expected % 2 == 0) {
+                if (queue.pop_front() != expected) {
+                    errors->add_error("pop_front() out of order at " + std::to_string(expected));
+                    break;
+                }
+                expected++;
+            }
+            else {
+                drained.clear();
+                queue.drain_front(drained, 50);
+                for (int value : drained) {
+                    if (value != expected++) {
+                        errors->add_error("drain_front() out of order");
+                        break;
+                    }
+                }
+            }
+        }
+        producer.join();
+
+        if (expected != n_rows) errors->add_error("consumed " + std::to_string(expected) + " rows");
+        if (queue.pushed_count() != static_cast<size_t>(n_rows)) errors->add_error("pushed_count() mismatch");
+    });
+    errors->check_and_fail_if_errors();
+}
+
+TEST_CASE("SPSCRowQueue holds more rows than one block without a consumer", "[threading][spsc]") {
+    internals::SPSCRowQueue<int> queue(100, 4);
+    queue.append_rows(std::vector<int>{ 0, 1, 2 });
+    for (int i = 3; i < 20; ++i) {
+        int value = i;
+        queue.push_back(std::move(value));
+    }
+    REQUIRE(queue.size() == 20);
+
+    queue.inspect([](const std::vector<int>& queued) {
+        REQUIRE(queued.size() == 20);
+        REQUIRE(queued.front() == 0);
+        REQUIRE(queued.back() == 19);
+    });
+
+    std::vector<int> drained;
+    REQUIRE(queue.drain_front(drained, 11) == 11);
+    REQUIRE(drained.back() == 10);
+    for (int i = 11; i < 20; ++i) {
+        REQUIRE(queue.pop_front() == i);
+    }
+    REQUIRE(queue.empty());
+    REQUIRE(queue.drain_front(drained, 5) == 0);
+}
+
+TEST_CASE("CSVReader read-ahead matches synchronous parsing",
+          "[threading][readahead]") {
+    std::string csv_string = "a,b,c\n";
+    while (csv_string.size() < 4 * internals::CSV_CHUNK_SIZE_FLOOR) {
+        const std::string i = std::to_string(csv_string.size());
+        csv_string += i + ",\"x\ny\"," + i + "\n";
+    }
+
+    CSVFormat sync_format;
+    sync_format.delimiter(',').chunk_size(internals::CSV_CHUNK_SIZE_FLOOR).threading(false);
+    std::stringstream sync_input(csv_string);
+    CSVReader sync_reader(sync_input, sync_format);
+
+    std::vector<std::vector<std::string>> expected;
+    for (auto& row : sync_reader) {
+        expected.push_back(std::vector<std::string>(row));
+    }
+    REQUIRE(expected.size() > 1000);
+
+    const size_t n_chunks = GENERATE(0, 1, 4);
+    CSVFormat format;
+    format.delimiter(',').chunk_size(internals::CSV_CHUNK_SIZE_FLOOR).readahead_chunks(n_chunks);
+    REQUIRE(format.get_readahead_chunks() == n_chunks);
+
+    SECTION("read_row") {
+        std::stringstream input(csv_string);
+        CSVReader reader(input, format);
+
+        size_t i = 0;
+        CSVRow row;
+        while (reader.read_row(row)) {
+            REQUIRE(i < expected.size());
+            REQUIRE(std::vector<std::string>(row) == expected[i++]);
+        }
+        REQUIRE(i == expected.size());
+    }
+
+    SECTION("Moving a reader mid-stream restarts its producer") {
+        std::stringstream input(csv_string);
+        CSVReader reader(input, format);
+
+        size_t i = 0;
+        CSVRow row;
+        while (i < 10 && reader.read_row(row)) {
+            REQUIRE(std::vector<std::string>(row) == expected[i++]);
+        }
+
+        CSVReader moved(std::move(reader));
+        while (moved.read_row(row)) {
+            REQUIRE(i < expected.size());
+            REQUIRE(std::vector<std::string>(row) == expected[i++]);
+        }
+        REQUIRE(i == expected.size());
+    }
+
+    SECTION("Abandoning a reader does not hang on a paused producer") {
+        auto errors = std::make_shared<ThreadSafeErrorCollector>();
+        test_with_timeout([errors, csv_string, format]() {
+            std::stringstream input(csv_string);
+            CSVReader reader(input, format);
+            CSVRow row;
+            if (!reader.read_row(row)) errors->add_error("no first row");
+        });
+        errors->check_and_fail_if_errors();
+    }
+}
@@ -0,0 +1,259 @@
+#include <catch2/catch_all.hpp>
+#include "internal/parallel/work_stealing_pool.hpp"
+
+#include <string>
+
+#include <stdexcept>
+#include <vector>
+
+#if CSV_ENABLE_THREADS
+#include <atomic>
+#include <mutex>
+#include <thread>
+#endif
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+using csv::internals::parallel::TaskGroup;
+using csv::internals::parallel::WorkStealingPool;
+
+TEST_CASE("WorkStealingPool serial fallback visits indexed tasks", "[work_stealing_pool]") {
+    WorkStealingPool pool(1);
+    std::vector<size_t> workers;
+    std::vector<size_t> tasks;
+
+    pool.parallel_for(5, [&workers, &tasks](size_t worker_index, size_t task_index) {
+        workers.push_back(worker_index);
+        tasks.push_back(task_index);
+    });
+
+#if CSV_ENABLE_THREADS
+    REQUIRE(pool.worker_count() == 1);
+#else
+    REQUIRE(pool.worker_count() == 0);
+#endif
+    REQUIRE(workers == std::vector<size_t>{ 0, 0, 0, 0, 0 });
+    REQUIRE(tasks == std::vector<size_t>{ 0, 1, 2, 3, 4 });
+}
+
+TEST_CASE("WorkStealingPool skips empty batches", "[work_stealing_pool]") {
+    WorkStealingPool pool(1);
+    size_t calls = 0;
+
+    pool.parallel_for(0, [&calls](size_t, size_t) {
+        ++calls;
+    });
+
+    TaskGroup group;
+    pool.wait(group);
+    REQUIRE(group.done());
+    REQUIRE(calls == 0);
+}
+
+TEST_CASE("WorkStealingPool propagates task exceptions and remains reusable", "[work_stealing_pool]") {
+    WorkStealingPool pool(2);
+
+    REQUIRE_THROWS_AS(
+        pool.parallel_for(8, [](size_t, size_t task_index) {
+            if (task_index == 3) {
+                throw std::runtime_error("task failure");
+            }
+        }),
+        std::runtime_error
+    );
+
+    std::vector<size_t> visits(4, 0);
+    pool.parallel_for(visits.size(), [&visits](size_t, size_t task_index) {
+        visits[task_index]++;
+    });
+
+    REQUIRE(visits == std::vector<size_t>{ 1, 1, 1, 1 });
+}
+
+#if CSV_ENABLE_THREADS
+TEST_CASE("WorkStealingPool spawn_for returns while the batch is still running", "[work_stealing_pool][threads]") {
+    WorkStealingPool pool(2);
+    std::atomic<bool> release{ false };
+    std::atomic<size_t> finished{ 0 };
+
+    // Each task blocks until the caller releases it, which can only happen
+    // if spawn_for() returned without waiting for the batch.
+    TaskGroup group;
+    pool.spawn_for(group, 4, [&release, &finished](size_t, size_t) {
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+        finished++;
+    });
+
+    release.store(true);
+    pool.wait(group);
+    REQUIRE(finished.load() == 4);
+
+    pool.spawn_for(group, 3, [](size_t, size_t task_index) {
+        if (task_index == 1) {
+            throw std::runtime_error("task failure");
+        }
+    });
+    REQUIRE_THROWS_AS(pool.wait(group), std::runtime_error);
+
+    // Nothing outstanding: wait() returns immediately.
+    pool.wait(group);
+}
+
+TEST_CASE("WorkStealingPool distributes indexed work across repeated batches", "[work_stealing_pool][threads]") {
+    WorkStealingPool pool(3);
+
+    for (size_t batch = 0; batch < 3; ++batch) {
+        std::vector<size_t> visits(64, 0);
+        std::vector<size_t> worker_visits(pool.worker_count(), 0);
+        std::mutex mutex;
+
+        pool.parallel_for(visits.size(), [&visits, &worker_visits, &mutex](size_t worker_index, size_t task_index) {
+            std::lock_guard<std::mutex> lock(mutex);
+            visits[task_index]++;
+            worker_visits[worker_index]++;
+        });
+
+        for (size_t task_index = 0; task_index < visits.size(); ++task_index) {
+            REQUIRE(visits[task_index] == 1);
+        }
+
+        size_t total_worker_visits = 0;
+        for (size_t worker_index = 0; worker_index < worker_visits.size(); ++worker_index) {
+            total_worker_visits += worker_visits[worker_index];
+        }
+
+        REQUIRE(total_worker_visits == visits.size());
+    }
+}
+
+TEST_CASE("WorkStealingPool runs nested and continuation tasks", "[work_stealing_pool][threads]") {
+    WorkStealingPool pool(3);
+    std::atomic<size_t> leaves{ 0 };
+    std::atomic<size_t> continuations{ 0 };
+
+    SECTION("Nested parallel_for inside a task") {
+        pool.parallel_for(4, [&pool, &leaves](size_t, size_t) {
+            pool.parallel_for(8, [&leaves](size_t, size_t) {
+                leaves++;
+            });
+        });
+
+        REQUIRE(leaves.load() == 32);
+    }
+
+    SECTION("Tasks spawn into their own group and into a continuation group") {
+        TaskGroup group;
+        TaskGroup follow_up;
+        pool.spawn_for(group, 4, [&pool, &group, &follow_up, &leaves, &continuations](size_t, size_t) {
+            pool.spawn(group, [&leaves](size_t) {
+                leaves++;
+            });
+            pool.spawn(follow_up, [&continuations](size_t) {
+                continuations++;
+            });
+        });
+
+        pool.wait(group);
+        REQUIRE(leaves.load() == 4);
+        pool.wait(follow_up);
+        REQUIRE(continuations.load() == 4);
+    }
+}
+
+TEST_CASE("WorkStealingPool lets a later batch overtake a slow task", "[work_stealing_pool][threads]") {
+    WorkStealingPool pool(2);
+    std::atomic<bool> release_slow{ false };
+    std::atomic<size_t> fast_done{ 0 };
+
+    // One task of the first batch blocks. With a generation barrier the second
+    // batch could not start until it finished.
+    TaskGroup slow;
+    pool.spawn(slow, [&release_slow](size_t) {
+        while (!release_slow.load()) {
+            std::this_thread::yield();
+        }
+    });
+
+    TaskGroup fast;
+    pool.spawn_for(fast, 16, [&fast_done](size_t, size_t) {
+        fast_done++;
+    });
+    pool.wait(fast);
+    REQUIRE(fast_done.load() == 16);
+    REQUIRE_FALSE(slow.done());
+
+    release_slow.store(true);
+    pool.wait(slow);
+    REQUIRE(slow.done());
+}
+#endif
+
+TEST_CASE("NUMA placement helpers report unknown nodes for bad input", "[work_stealing_pool][placement]") {
+    using namespace csv::internals::parallel;
+
+    REQUIRE_FALSE(pin_current_thread(-1));
+    REQUIRE(cpu_numa_node(-1) == CSV_UNKNOWN_NUMA_NODE);
+    REQUIRE(page_numa_node(nullptr) == CSV_UNKNOWN_NUMA_NODE);
+
+    // A touched page is on some node wherever the kernel can tell.
+    std::string bytes(4096, 'x');
+    REQUIRE(page_numa_node(bytes.data()) >= CSV_UNKNOWN_NUMA_NODE);
+}
+
+#if CSV_ENABLE_THREADS && defined(__linux__)
+TEST_CASE("WorkStealingPool pins workers to its CPU set", "[work_stealing_pool][placement][threads]") {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    REQUIRE(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+
+    int cpu = 0;
+    while (cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed)) {
+        ++cpu;
+    }
+    REQUIRE(cpu < CPU_SETSIZE);
+
+    WorkStealingPool pool(2, std::vector<int>{ cpu });
+    std::mutex lock;
+    std::vector<int> seen_cpus;
+    pool.parallel_for(8, [&](size_t, size_t) {
+        const int current = sched_getcpu();
+        std::lock_guard<std::mutex> guard(lock);
+        seen_cpus.push_back(current);
+    });
+
+    REQUIRE(seen_cpus.size() == 8);
+    for (size_t i = 0; i < seen_cpus.size(); ++i) {
+        REQUIRE(seen_cpus[i] == cpu);
+    }
+
+    // Both workers share one node, so node-aware dispatch stays off.
+    REQUIRE_FALSE(pool.spans_numa_nodes());
+    REQUIRE(pool.worker_node(0) == pool.worker_node(1));
+    REQUIRE(pool.worker_node(2) == csv::internals::parallel::CSV_UNKNOWN_NUMA_NODE);
+}
+
+TEST_CASE("WorkStealingPool spawn_on queues with the requested worker", "[work_stealing_pool][placement][threads]") {
+    WorkStealingPool pool(2);
+    std::atomic<size_t> runs{ 0 };
+
+    TaskGroup group;
+    for (size_t i = 0; i < 8; ++i) {
+        pool.spawn_on(group, i % 2, [&runs](size_t worker_index) {
+            REQUIRE(worker_index < 2);
+            runs++;
+        });
+    }
+
+    // Out-of-range workers fall back to a normal spawn.
+    pool.spawn_on(group, 7, [&runs](size_t) {
+        runs++;
+    });
+    pool.wait(group);
+    REQUIRE(runs.load() == 9);
+    REQUIRE(pool.next_worker_on_node(csv::internals::parallel::CSV_UNKNOWN_NUMA_NODE) == pool.worker_count());
+}
+#endif